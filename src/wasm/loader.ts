@@ -1,5 +1,18 @@
 import { Renderer } from '@/editor/renderer';
-import wasm from './editor';
+// The pthreads build is opt-in: compile.py writes it to public/wasm/, which Vite serves and copies
+// to dist as is, and VITE_WASM_THREADS=1 enables it. It needs SharedArrayBuffer, which is only
+// available when the page is served cross-origin isolated (COOP/COEP headers). Otherwise the single
+// threaded build is loaded, which decodes the images on the main thread within a frame budget.
+const threads = import.meta.env.VITE_WASM_THREADS === '1';
+
+if (threads && !self.crossOriginIsolated) {
+  console.warn('The page is not cross-origin isolated, loading the single threaded build.');
+}
+
+const wasm =
+  threads && self.crossOriginIsolated
+    ? (await import(/* @vite-ignore */ `${import.meta.env.BASE_URL}wasm/editor-mt.js`)).default
+    : (await import('./editor')).default;
 
 const fallback: any = () => {};
 
@@ -23,6 +36,8 @@ const API: Api = {
   _load_font: fallback,
   _load_svg: fallback,
   _load_image: fallback,
+  _images_progress: fallback,
+  _images_loaded: fallback,
   _to_heap: fallback,
   _free: fallback
 };
@@ -102,6 +117,8 @@ wasm().then((module: any) => {
     module._load_image(ptr, data.byteLength);
     module._free(ptr);
   };
+  API._images_progress = module._images_progress;
+  API._images_loaded = module._images_loaded;
 
   API._to_heap = (array: Float32Array) => {
     const bytes = array.length * array.BYTES_PER_ELEMENT;
@@ -47,6 +47,8 @@ interface Api {
   _load_font(data: ArrayBuffer): void;
   _load_svg(data: ArrayBuffer): void;
   _load_image(data: ArrayBuffer): void;
+  _images_progress(): number;
+  _images_loaded(): boolean;
 
   _to_heap(array: Float32Array): Pointer;
   _free(pointer: Pointer): void;
@@ -9,6 +9,18 @@ export default defineConfig({
   plugins: [vitePluginString(), solidPlugin(), wasm(), topLevelAwait()],
   server: {
     port: 3000,
+    // The pthreads build of the editor needs SharedArrayBuffer and so cross-origin isolation,
+    // without these headers src/wasm/loader.ts falls back to the single threaded build.
+    headers: {
+      "Cross-Origin-Opener-Policy": "same-origin",
+      "Cross-Origin-Embedder-Policy": "require-corp",
+    },
+  },
+  preview: {
+    headers: {
+      "Cross-Origin-Opener-Policy": "same-origin",
+      "Cross-Origin-Embedder-Policy": "require-corp",
+    },
   },
   build: {
     target: "esnext",
@@ -7,6 +7,9 @@ DESYNCHRONIZED = False
 
 EMCC_PATH = '%EMSDK%/upstream/emscripten/emcc'
 OUTPUT = '..\src\wasm\editor.js'
+# Built with pthreads too, as a static asset with its .wasm file: src/wasm/loader.ts picks it when
+# VITE_WASM_THREADS=1 and the page is cross-origin isolated.
+THREADED_OUTPUT = '..\public\wasm\editor-mt.js'
 OPTIONS = [
   'ALLOW_MEMORY_GROWTH', 
   'EXPORT_ES6', 
@@ -33,16 +36,25 @@ for path in Path('./').rglob('*.cc'):
   if str(path)[:5] != 'debug':
     files.append(str(path))
 
+# The renderer workers and the image decoder run on pthreads, spawned ahead as they block on
+# start. SharedArrayBuffer requires the page to be cross-origin isolated (COOP/COEP headers),
+# without it the single threaded build decodes the images on the main thread within a budget.
+THREADED_OPTIONS = [
+  'USE_PTHREADS',
+  'PTHREAD_POOL_SIZE=navigator.hardwareConcurrency*2',
+]
+
 COMMON = [
   EMCC_PATH,
   *files,
-  '-o ' + OUTPUT,
   '-l embind',
   '-DEMSCRIPTEN=1',
   '-std=c++17',
   '-s ' + ' -s '.join(OPTIONS)
 ]
 
+THREADED = ['-pthread', '-s ' + ' -s '.join(THREADED_OPTIONS)]
+
 
 # Other options could be -fsanitize=undefined, -fsanitize=address, -fsanitize=leak, -sSAFE_HEAP=1
 if (SANITIZE):
@@ -50,15 +62,20 @@ if (SANITIZE):
   COMMON = COMMON + ['-sASSERTIONS=2', '-sSTACK_OVERFLOW_CHECK=2',  '-sCHECK_NULL_WRITES=1', '-sVERBOSE=1', '-sSAFE_HEAP', '-DGK_CONF_DEBUG=1', '-g', '-fdebug-compilation-dir="../wasm-src"']
 
 if (DEBUG):
-  os.system(' '.join([*COMMON, '-sASSERTIONS=1', '-sNO_DISABLE_EXCEPTION_CATCHING=1', '-DGK_CONF_DEBUG=1', '-g', '-fdebug-compilation-dir="../wasm-src"']))
+  CONFIG = ['-sASSERTIONS=1', '-sNO_DISABLE_EXCEPTION_CATCHING=1', '-DGK_CONF_DEBUG=1', '-g', '-fdebug-compilation-dir="../wasm-src"']
 else:
-  os.system(' '.join([*COMMON, '-DGK_CONF_DIST=1', '-O1', '-fno-rtti', '-fno-exceptions', '-funsafe-math-optimizations', '-DEMSCRIPTEN_HAS_UNBOUND_TYPE_NAMES=0']))
+  CONFIG = ['-DGK_CONF_DIST=1', '-O1', '-fno-rtti', '-fno-exceptions', '-funsafe-math-optimizations', '-DEMSCRIPTEN_HAS_UNBOUND_TYPE_NAMES=0']
+
+os.makedirs(os.path.dirname(THREADED_OUTPUT), exist_ok=True)
+
+for (output, threads) in [(OUTPUT, []), (THREADED_OUTPUT, THREADED)]:
+  os.system(' '.join([*COMMON, *threads, *CONFIG, '-o ' + output]))
 
-if (DESYNCHRONIZED):
-  with open(OUTPUT, 'r') as file:
-    filedata = file.read()
+  if (DESYNCHRONIZED):
+    with open(output, 'r') as file:
+      filedata = file.read()
 
-  filedata = filedata.replace('"stencil":!!HEAP32[a+(8>>2)],"antialias"', '"stencil":!!HEAP32[a+(8>>2)],"desynchronized":true,"antialias"')
+    filedata = filedata.replace('"stencil":!!HEAP32[a+(8>>2)],"antialias"', '"stencil":!!HEAP32[a+(8>>2)],"desynchronized":true,"antialias"')
 
-  with open(OUTPUT, 'w') as file:
-    file.write(filedata)
+    with open(output, 'w') as file:
+      file.write(filedata)
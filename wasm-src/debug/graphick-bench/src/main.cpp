@@ -0,0 +1,974 @@
+/**
+ * @file graphick-bench/src/main.cpp
+ * @brief Native benchmarks of the rendering pipeline stages.
+ *
+ * Every SVG file of the directory is benchmarked stage by stage: parsing, transforming, stroking,
+ * clipping, tiling and batching, at several zoom levels and viewport sizes. The random access of
+ * large paths, used by the editing tools, the clipping of large paths at deep zoom levels and the
+ * stroking of long paths, serial and split across the workers, are benchmarked on synthetic paths.
+ * The residency of an image shared by drawables displayed at different sizes is checked too.
+ * The heap allocations of the geometry stages and of the renderer frames are counted: once warmed
+ * up they must be zero, otherwise the benchmark fails. The renderer runs without workers for this.
+ * Results are printed as a table and, if requested, written as JSON. Keys are sorted and entries
+ * follow the order of the files, zooms and viewports, so that runs can be compared with a diff.
+ *
+ * Usage: graphick-bench [vectors_directory] [--json output_file]
+ */
+
+#include "wasm-src/editor/editor.h"
+#include "wasm-src/editor/scene/components/appearance.h"
+#include "wasm-src/editor/scene/components/base.h"
+#include "wasm-src/editor/scene/components/path.h"
+
+#include "wasm-src/geom/clip.h"
+#include "wasm-src/geom/path.h"
+#include "wasm-src/geom/path_builder.h"
+
+#include "wasm-src/io/json/json.h"
+#include "wasm-src/io/resource_manager.h"
+#include "wasm-src/io/svg/svg.h"
+
+#include "wasm-src/renderer/renderer.h"
+#include "wasm-src/renderer/texture_cache.h"
+#include "wasm-src/renderer/tiles.h"
+
+#include "wasm-src/utils/job_system.h"
+
+#include <glad/glad.h>
+
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <sstream>
+
+using namespace graphick;
+
+/**
+ * @brief The version of the JSON output, increased when the format changes.
+ */
+static constexpr int json_version = 1;
+
+/**
+ * @brief The zoom levels to benchmark.
+ */
+static constexpr double zooms[] = {1.0, 8.0, 64.0};
+
+/**
+ * @brief The viewport sizes to benchmark.
+ */
+static const ivec2 viewports[] = {ivec2(800, 600), ivec2(1920, 1080)};
+
+/**
+ * @brief The number of segments of the paths used to benchmark the random access of geom::Path.
+ */
+static constexpr uint32_t path_access_sizes[] = {1000, 20000};
+
+/**
+ * @brief The number of segments of the paths used to benchmark geom::clip.
+ */
+static constexpr uint32_t clip_sizes[] = {20000, 200000};
+
+/**
+ * @brief The size of the clipping rectangles, relative to the bounding rectangle of the path.
+ */
+static constexpr double clip_fractions[] = {0.1, 0.5};
+
+/**
+ * @brief The number of segments of the paths used to benchmark geom::PathBuilder::stroke.
+ */
+static constexpr uint32_t stroke_sizes[] = {5000, 50000};
+
+/**
+ * @brief The number of heap allocations of the process, see count_allocations().
+ */
+static std::atomic<size_t> allocations = 0;
+
+/**
+ * @brief The number of heap allocations of the calling thread, see bench_view().
+ */
+static thread_local size_t local_allocations = 0;
+
+void* operator new(const size_t size)
+{
+  allocations++;
+  local_allocations++;
+
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] const size_t size) noexcept
+{
+  std::free(ptr);
+}
+
+/**
+ * @brief An element of the benchmark scene, with the properties needed by each stage.
+ */
+struct BenchElement {
+  geom::path path;                                      // The path, in local space.
+  mat2x3 transform;                                     // The transform of the path.
+
+  std::optional<renderer::Fill> fill;                   // The fill of the element, if visible.
+  std::optional<geom::StrokingOptions<double>> stroke;  // The stroke of the element, if visible.
+  renderer::Fill stroke_fill;                           // The fill of the stroke outline.
+};
+
+/**
+ * @brief A path ready to be tiled: a filled path or the outline of a stroke.
+ */
+struct BenchPath {
+  geom::dcubic_multipath path;  // The closed monotonic cubic path.
+  drect bounding_rect;          // The bounding rectangle of the path.
+  renderer::Fill fill;          // The fill to tile the path with.
+};
+
+/**
+ * @brief Creates an hidden window, the editor requires a valid OpenGL context to be initialized.
+ *
+ * @return The window, nullptr if the context could not be created.
+ */
+static GLFWwindow* create_hidden_context()
+{
+  if (!glfwInit()) {
+    printf("Failed to initialize GLFW\n");
+    return nullptr;
+  }
+
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+  GLFWwindow* window = glfwCreateWindow(800, 600, "graphick-bench", nullptr, nullptr);
+
+  if (!window) {
+    glfwTerminate();
+    return nullptr;
+  }
+
+  glfwMakeContextCurrent(window);
+  gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+
+  editor::Editor::init();
+
+  return window;
+}
+
+/**
+ * @brief Returns the current time in milliseconds.
+ */
+static inline double now()
+{
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Runs the callback repeatedly for at least min_time milliseconds.
+ *
+ * @param callback The function to benchmark.
+ * @param min_time The minimum total time to run the callback for.
+ * @return The average time of a single run in milliseconds.
+ */
+static double measure(const std::function<void()>& callback, const double min_time = 250.0)
+{
+  /* Warm up the caches and the allocator. */
+  callback();
+
+  const double start = now();
+  int runs = 0;
+
+  do {
+    callback();
+    runs++;
+  } while (now() - start < min_time);
+
+  return (now() - start) / runs;
+}
+
+/**
+ * @brief Counts the heap allocations of a single run of the callback, after a warm up run.
+ *
+ * @param callback The function to check.
+ * @return The number of allocations of the second run.
+ */
+static size_t count_allocations(const std::function<void()>& callback)
+{
+  callback();
+
+  const size_t start = allocations;
+
+  callback();
+
+  return allocations - start;
+}
+
+/**
+ * @brief Reads the content of a file.
+ *
+ * @param file_path The path of the file.
+ * @return The content of the file.
+ */
+static std::string read_file(const std::filesystem::path& file_path)
+{
+  std::ifstream ifs(file_path);
+  std::stringstream content;
+
+  content << ifs.rdbuf();
+
+  return content.str();
+}
+
+/**
+ * @brief Collects the elements of the current scene.
+ *
+ * @return The visible elements of the scene.
+ */
+static std::vector<BenchElement> collect_elements()
+{
+  editor::Scene& scene = editor::Editor::scene();
+
+  auto view = scene.get_all_entities_with<editor::PathData, editor::TransformData>();
+  auto fills = scene.get_all_entities_with<editor::FillData>();
+  auto strokes = scene.get_all_entities_with<editor::StrokeData>();
+
+  std::vector<BenchElement> elements;
+
+  for (const entt::entity entity : view) {
+    BenchElement element{view.get<editor::PathData>(entity).path,
+                         view.get<editor::TransformData>(entity).matrix};
+
+    if (element.path.empty()) {
+      continue;
+    }
+
+    if (fills.contains(entity)) {
+      const editor::FillData& fill = fills.get<editor::FillData>(entity);
+
+      if (fill.visible && fill.paint.visible()) {
+        element.fill = renderer::Fill(fill.paint, fill.rule);
+      }
+    }
+
+    if (strokes.contains(entity)) {
+      const editor::StrokeData& stroke = strokes.get<editor::StrokeData>(entity);
+
+      if (stroke.visible && stroke.paint.visible()) {
+        element.stroke = geom::StrokingOptions<double>{
+            renderer::RendererSettings::stroking_tolerance,
+            stroke.width,
+            stroke.miter_limit,
+            stroke.cap,
+            stroke.join};
+        element.stroke_fill = renderer::Fill(stroke.paint, renderer::FillRule::NonZero);
+      }
+    }
+
+    if (element.fill || element.stroke) {
+      elements.push_back(std::move(element));
+    }
+  }
+
+  return elements;
+}
+
+/**
+ * @brief Benchmarks the scene-level stages of a file: parse_svg, Path::transformed,
+ * PathBuilder::stroke and the fused pipeline of Path::stream().
+ *
+ * The file is left loaded in the scene of the editor.
+ *
+ * @param svg The content of the SVG file.
+ * @param result The JSON object to write the results to.
+ * @return The paths to tile, the filled paths followed by the stroke outlines.
+ */
+static std::vector<BenchPath> bench_scene(const std::string& svg, io::json::JSON& result)
+{
+  const double parse_time = measure([&]() {
+    editor::Editor::new_scene();
+    io::svg::parse_svg(svg);
+  });
+
+  const std::vector<BenchElement> elements = collect_elements();
+
+  std::vector<geom::dpath> transformed(elements.size());
+
+  const double transform_time = measure([&]() {
+    for (size_t i = 0; i < elements.size(); i++) {
+      transformed[i] = elements[i].path.transformed<double>(elements[i].transform);
+    }
+  });
+
+  std::vector<BenchPath> paths;
+  std::vector<BenchPath> outlines;
+
+  const double stroke_time = measure([&]() {
+    outlines.clear();
+
+    for (size_t i = 0; i < elements.size(); i++) {
+      if (!elements[i].stroke) {
+        continue;
+      }
+
+      const geom::PathBuilder<double> builder(transformed[i], transformed[i].bounding_rect());
+      geom::StrokeOutline<double> outline = builder.stroke(*elements[i].stroke);
+
+      outlines.push_back(
+          {std::move(outline.path), outline.bounding_rect, elements[i].stroke_fill});
+    }
+  });
+
+  for (size_t i = 0; i < elements.size(); i++) {
+    if (!elements[i].fill) {
+      continue;
+    }
+
+    geom::dcubic_multipath cubic_path = transformed[i].to_cubic_multipath();
+
+    if (cubic_path.empty()) {
+      continue;
+    }
+
+    if (!cubic_path.closed()) {
+      cubic_path.line_to(cubic_path.front());
+    }
+
+    const drect bounding_rect = cubic_path.bounding_rect();
+
+    paths.push_back({std::move(cubic_path), bounding_rect, *elements[i].fill});
+  }
+
+  /* The filled paths are transformed, split in monotonic curves and closed in a single pass,
+   * into a buffer reused across elements and runs. */
+
+  geom::dcubic_multipath geometry_path;
+
+  const auto build_geometry = [&]() {
+    for (const BenchElement& element : elements) {
+      if (element.fill) {
+        geometry_path.clear();
+        element.path.stream<double>(element.transform, geometry_path);
+      }
+    }
+  };
+
+  const double geometry_time = measure(build_geometry);
+  const size_t geometry_allocations = count_allocations(build_geometry);
+
+  result["elements"] = static_cast<int>(elements.size());
+  result["strokes"] = static_cast<int>(outlines.size());
+  result["parse_ms"] = parse_time;
+  result["transform_ms"] = transform_time;
+  result["stroke_ms"] = stroke_time;
+  result["geometry_ms"] = geometry_time;
+  result["geometry_allocations"] = static_cast<int>(geometry_allocations);
+
+  paths.insert(paths.end(),
+               std::make_move_iterator(outlines.begin()),
+               std::make_move_iterator(outlines.end()));
+
+  return paths;
+}
+
+/**
+ * @brief Benchmarks the random access of a synthetic path, the way the editing tools use it:
+ * segment_at() and node_at() over the whole path, and split() followed by node_at().
+ *
+ * @param segments The number of segments of the path, lines, quadratics and cubics in turn.
+ * @param result The JSON object to write the results to.
+ */
+static void bench_path_access(const uint32_t segments, io::json::JSON& result)
+{
+  geom::path path;
+  path.move_to(vec2::zero());
+
+  for (uint32_t i = 0; i < segments; i++) {
+    const float x = static_cast<float>(i) * 10.0f;
+
+    switch (i % 3) {
+      case 0:
+        path.line_to({x + 10.0f, 0.0f});
+        break;
+      case 1:
+        path.quadratic_to({x + 5.0f, 10.0f}, {x + 10.0f, 0.0f});
+        break;
+      default:
+        path.cubic_to({x + 3.0f, -10.0f}, {x + 7.0f, 10.0f}, {x + 10.0f, 0.0f});
+        break;
+    }
+  }
+
+  const double segment_time = measure([&]() {
+    for (uint32_t i = 0; i < path.size(); i++) {
+      path.segment_at(i);
+    }
+  });
+
+  const double node_time = measure([&]() {
+    for (uint32_t i = 0; i < path.points_count(); i++) {
+      path.node_at(i);
+    }
+  });
+
+  geom::path edited;
+
+  const double split_time = measure([&]() {
+    edited = path;
+
+    /* Scattered edits, each one is followed by a lookup of the new vertex. */
+    for (uint32_t i = 0; i < 100; i++) {
+      const uint32_t point_index = edited.split((i * 7919) % edited.size(), 0.5f);
+      edited.node_at(point_index);
+    }
+  });
+
+  result["segments"] = static_cast<int>(segments);
+  result["segment_at_ms"] = segment_time;
+  result["node_at_ms"] = node_time;
+  result["split_ms"] = split_time;
+}
+
+/**
+ * @brief Benchmarks the clipping of a synthetic path to rectangles centered on it, the way
+ * Renderer::draw_multipath() clips the paths that are mostly out of the viewport.
+ *
+ * @param segments The number of segments of the path, a serpentine of lines and cubics.
+ * @param result The JSON object to write the results to.
+ */
+static void bench_clip(const uint32_t segments, io::json::JSON& result)
+{
+  const uint32_t row_segments = static_cast<uint32_t>(std::sqrt(segments));
+
+  geom::path path;
+  path.move_to(vec2::zero());
+
+  for (uint32_t i = 0; i < segments; i++) {
+    const uint32_t row = i / row_segments;
+    const uint32_t column = row % 2 ? row_segments - i % row_segments : i % row_segments;
+
+    const float x = static_cast<float>(column) * 10.0f;
+    const float y = static_cast<float>(row) * 10.0f;
+    const float dx = row % 2 ? -10.0f : 10.0f;
+
+    if (i % 4 == 0) {
+      path.line_to({x + dx, y});
+    } else {
+      path.cubic_to({x + dx * 0.3f, y - 8.0f}, {x + dx * 0.7f, y + 8.0f}, {x + dx, y});
+    }
+  }
+
+  geom::dcubic_multipath cubic_path;
+  path.stream<double>(mat2x3(), cubic_path);
+
+  const drect bounding_rect = cubic_path.bounding_rect();
+
+  geom::dcubic_multipath clipped;
+  io::json::JSON& times = result["clip_ms"] = io::json::JSON::array();
+
+  for (const double fraction : clip_fractions) {
+    const dvec2 half_size = bounding_rect.size() * fraction / 2.0;
+    const drect clip_rect = {bounding_rect.center() - half_size,
+                             bounding_rect.center() + half_size};
+
+    times.append(measure([&]() { geom::clip(cubic_path, clip_rect, clipped); }));
+  }
+
+  result["segments"] = static_cast<int>(segments);
+  result["curves"] = static_cast<int>(cubic_path.size());
+}
+
+/**
+ * @brief Benchmarks the stroking of a long synthetic path, on the calling thread and split across
+ * the workers of a job system, and checks that both outlines are the same.
+ *
+ * @param segments The number of segments of the path, a zigzag of lines and cubics.
+ * @param jobs The job system to split the stroke across.
+ * @param result The JSON object to write the results to.
+ */
+static void bench_stroke(const uint32_t segments, utils::JobSystem& jobs, io::json::JSON& result)
+{
+  geom::dpath path;
+  path.move_to(dvec2::zero());
+
+  for (uint32_t i = 0; i < segments; i++) {
+    const double x = static_cast<double>(i) * 10.0;
+    const double y = i % 2 ? 0.0 : 10.0;
+
+    if (i % 4 == 0) {
+      path.line_to({x + 10.0, 10.0 - y});
+    } else {
+      path.cubic_to({x + 3.0, y - 5.0}, {x + 7.0, 15.0 - y}, {x + 10.0, 10.0 - y});
+    }
+  }
+
+  const geom::dpath_builder builder = geom::dpath_builder(path, path.bounding_rect());
+  const geom::StrokingOptions<double> options = {
+      renderer::RendererSettings::stroking_tolerance,
+      4.0,
+      4.0,
+      geom::LineCap::Round,
+      geom::LineJoin::Round};
+
+  geom::StrokeOutline<double> serial;
+  geom::StrokeOutline<double> split;
+
+  result["segments"] = static_cast<int>(segments);
+  result["workers"] = static_cast<int>(jobs.concurrency());
+  result["stroke_ms"] = measure([&]() { serial = builder.stroke(options); });
+  result["split_stroke_ms"] = measure([&]() { split = builder.stroke(options, nullptr, &jobs); });
+  result["same"] = serial.path.points == split.path.points &&
+                   serial.path.starts == split.path.starts &&
+                   serial.bounding_rect.min == split.bounding_rect.min &&
+                   serial.bounding_rect.max == split.bounding_rect.max;
+}
+
+/**
+ * @brief Checks that an image painted by two drawables at different zooms is uploaded once, at the
+ * resolution of the larger one, whatever the order of the requests. Then checks that zooming out
+ * keeps the resident texture until the image is downsampled in the background.
+ *
+ * @param result The JSON object to write the results to.
+ */
+static void bench_textures(io::json::JSON& result)
+{
+  constexpr int image_size = 256;
+
+  /* A binary PPM, decoded by stb_image like the images imported by the editor. */
+  const std::string header = "P6\n" + std::to_string(image_size) + " " +
+                             std::to_string(image_size) + "\n255\n";
+
+  std::vector<uint8_t> data(header.begin(), header.end());
+  data.resize(header.size() + image_size * image_size * 3);
+
+  for (size_t i = header.size(); i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 31);
+  }
+
+  const uuid image_id = io::ResourceManager::load_image(data.data(), data.size());
+  io::ResourceManager::poll_images(true);
+
+  const dvec2 zoomed_in = dvec2(image_size);
+  const dvec2 zoomed_out = dvec2(image_size / 16);
+
+  renderer::TextureCache textures;
+
+  textures.begin_frame();
+  textures.request(image_id, zoomed_out);
+  textures.request(image_id, zoomed_in);
+  textures.resolve();
+
+  const size_t first_upload = textures.stats().uploaded_bytes;
+
+  textures.begin_frame();
+  textures.request(image_id, zoomed_in);
+  textures.request(image_id, zoomed_out);
+  textures.resolve();
+
+  const size_t second_upload = textures.stats().uploaded_bytes;
+
+  textures.begin_frame();
+  textures.request(image_id, zoomed_out);
+  textures.resolve();
+
+  const size_t zoom_out_upload = textures.stats().uploaded_bytes;
+  const bool resident = textures.textures()->find(image_id) != textures.textures()->end();
+
+  io::ResourceManager::poll_images(true);
+
+  textures.begin_frame();
+  textures.request(image_id, zoomed_out);
+  textures.resolve();
+
+  const size_t decoded_upload = textures.stats().uploaded_bytes;
+
+  /* The full resolution and the zoomed out images, mipmaps included. */
+  const size_t full_bytes = static_cast<size_t>(image_size) * image_size * 3 * 4 / 3;
+  const size_t zoomed_out_bytes = full_bytes / 256;
+
+  result["image_size"] = image_size;
+  result["first_upload_bytes"] = static_cast<int>(first_upload);
+  result["second_upload_bytes"] = static_cast<int>(second_upload);
+  result["zoom_out_upload_bytes"] = static_cast<int>(zoom_out_upload);
+  result["decoded_upload_bytes"] = static_cast<int>(decoded_upload);
+  result["finest"] = first_upload == full_bytes && second_upload == 0;
+  result["deferred"] = resident && zoom_out_upload == 0 && decoded_upload == zoomed_out_bytes;
+}
+
+/**
+ * @brief Benchmarks the view-dependent stages of a file: geom::clip, Tiler::tile and the batching
+ * of the TiledRenderer.
+ *
+ * Paths are clipped and tiled as the renderer does, the view is centered on the scene.
+ *
+ * @param paths The paths to tile.
+ * @param zoom The zoom level.
+ * @param viewport_size The size of the viewport in pixels.
+ * @param result The JSON object to write the results to.
+ */
+static void bench_view(const std::vector<BenchPath>& paths,
+                       const double zoom,
+                       const ivec2 viewport_size,
+                       io::json::JSON& result)
+{
+  drect scene_rect = paths.empty() ? drect{} : paths.front().bounding_rect;
+
+  for (const BenchPath& path : paths) {
+    scene_rect.min = math::min(scene_rect.min, path.bounding_rect.min);
+    scene_rect.max = math::max(scene_rect.max, path.bounding_rect.max);
+  }
+
+  const dvec2 half_size = dvec2(viewport_size) / (2.0 * zoom);
+  const drect visible = {scene_rect.center() - half_size, scene_rect.center() + half_size};
+
+  renderer::Tiler tiler;
+  tiler.setup(zoom);
+
+  /* The same clipping heuristic of Renderer::draw_multipath(). */
+
+  const double tile_size = tiler.tile_size();
+  const drect clip_region = {math::floor(visible.min / tile_size - 2) * tile_size,
+                             math::ceil(visible.max / tile_size + 2) * tile_size};
+
+  std::vector<const BenchPath*> visible_paths;
+  std::vector<const BenchPath*> clipped_paths;
+
+  for (const BenchPath& path : paths) {
+    const double coverage = geom::rect_rect_intersection_area(path.bounding_rect, visible) /
+                            path.bounding_rect.area();
+
+    if (coverage <= math::epsilon<double>) {
+      continue;
+    } else if (coverage < 0.25) {
+      clipped_paths.push_back(&path);
+    } else {
+      visible_paths.push_back(&path);
+    }
+  }
+
+  std::vector<BenchPath> clipped(clipped_paths.size());
+
+  const auto clip_paths = [&]() {
+    for (size_t i = 0; i < clipped_paths.size(); i++) {
+      geom::clip(clipped_paths[i]->path, clip_region, clipped[i].path);
+    }
+  };
+
+  const double clip_time = measure(clip_paths);
+  const size_t clip_allocations = count_allocations(clip_paths);
+
+  for (size_t i = 0; i < clipped_paths.size(); i++) {
+    clipped[i].bounding_rect = clipped[i].path.bounding_rect();
+    clipped[i].fill = clipped_paths[i]->fill;
+
+    if (!clipped[i].path.empty()) {
+      visible_paths.push_back(&clipped[i]);
+    }
+  }
+
+  size_t tiles = 0, fills = 0, curves = 0, tile_bytes = 0;
+
+  const double tile_time = measure([&]() {
+    tiles = fills = curves = tile_bytes = 0;
+
+    for (const BenchPath* path : visible_paths) {
+      renderer::Drawable drawable;
+
+      tiler.tile(
+          path->path, path->bounding_rect, path->fill, rect::identity().vertices(), drawable);
+
+      tiles += drawable.tiles.size();
+      fills += drawable.fills.size() / 4;
+      curves += drawable.curves.size() / 4;
+      tile_bytes += drawable.tiles.size() * sizeof(renderer::TileInstance) +
+                    drawable.tile_tex_coords.size() * sizeof(renderer::TileTexCoords);
+    }
+  });
+
+  /* Batching is measured on cached frames of the editor, so that only the batches are rebuilt. */
+
+  editor::Scene& scene = editor::Editor::scene();
+
+  scene.viewport.resize(viewport_size, ivec2::zero(), 1.0f);
+  scene.viewport.zoom_to(static_cast<float>(zoom));
+  scene.viewport.move_to(vec2(-visible.min));
+
+  editor::Editor::request_render({true, false});
+  editor::Editor::render_loop(now());
+
+  double batch_time = 0.0;
+  size_t frames = 0;
+
+  const double frame_time = measure([&]() {
+    editor::Editor::request_render({false, false});
+    editor::Editor::render_loop(now());
+
+    batch_time += renderer::Renderer::stats().batch_time / 1e6;
+    frames++;
+  });
+
+  const renderer::RenderStats stats = renderer::Renderer::stats();
+
+  /* The same frames without retained batches, every batch is rebuilt from the drawables. */
+
+  double rebuild_time = 0.0;
+  size_t rebuild_frames = 0;
+
+  renderer::RendererSettings::retained_batches = false;
+
+  measure([&]() {
+    editor::Editor::request_render({false, false});
+    editor::Editor::render_loop(now());
+
+    rebuild_time += renderer::Renderer::stats().batch_time / 1e6;
+    rebuild_frames++;
+  });
+
+  renderer::RendererSettings::retained_batches = true;
+
+  /* Once warmed up, frames of an unchanged view must not allocate. The renderer has no workers,
+   * see main(), so all its allocations are counted on this thread. */
+
+  size_t frame_allocations = 0;
+
+  for (int i = 0; i < 4; i++) {
+    editor::Editor::request_render({false, false});
+
+    const size_t start = local_allocations;
+
+    editor::Editor::render_loop(now());
+
+    frame_allocations += local_allocations - start;
+  }
+
+  result["zoom"] = zoom;
+  result["viewport"] = io::json::JSON::array(viewport_size.x, viewport_size.y);
+  result["clipped"] = static_cast<int>(clipped_paths.size());
+  result["clip_ms"] = clip_time;
+  result["clip_allocations"] = static_cast<int>(clip_allocations);
+  result["frame_allocations"] = static_cast<int>(frame_allocations);
+  result["tile_ms"] = tile_time;
+  result["tiles"] = static_cast<int>(tiles);
+  result["fills"] = static_cast<int>(fills);
+  result["curves"] = static_cast<int>(curves);
+  result["tile_bytes"] = tiles ? static_cast<double>(tile_bytes) / tiles : 0.0;
+  result["batch_ms"] = batch_time / frames;
+  result["rebuild_batch_ms"] = rebuild_time / rebuild_frames;
+  result["frame_ms"] = frame_time;
+  result["batches"] = static_cast<int>(stats.batches);
+  result["batch_tiles"] = static_cast<int>(stats.tiles);
+  result["batch_fills"] = static_cast<int>(stats.fills);
+  result["batch_tile_bytes"] = stats.tiles ?
+                                   static_cast<double>(stats.tile_bytes) / stats.tiles :
+                                   0.0;
+  result["batch_curves"] = static_cast<int>(stats.curves);
+  result["half_curves"] = static_cast<int>(stats.half_curves);
+  result["shared_curves"] = static_cast<int>(stats.shared_curves);
+  result["retained_batches"] = static_cast<int>(stats.retained_batches);
+  result["culled_tiles"] = static_cast<int>(stats.culled_tiles);
+  result["offscreen_tiles"] = static_cast<int>(stats.offscreen_tiles);
+  result["passes"] = static_cast<int>(stats.passes);
+  result["stale_LODs"] = static_cast<int>(stats.stale_LODs);
+  result["texture_splits"] = static_cast<int>(stats.texture_splits);
+}
+
+int main(int argc, char** argv)
+{
+  std::filesystem::path directory = "../graphick-debug/res/vectors";
+  std::filesystem::path json_path;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+
+    if (arg == "--json" && i + 1 < argc) {
+      json_path = argv[++i];
+    } else {
+      directory = arg;
+    }
+  }
+
+  /* The renderer works on this thread, so that the allocations of its frames can be counted. */
+  renderer::RendererSettings::max_workers = 0;
+
+  GLFWwindow* window = create_hidden_context();
+
+  if (!window) {
+    printf("Failed to create window\n");
+    return -1;
+  }
+
+  /* Whether a check failed, the results are still printed and written. */
+  bool failed = false;
+
+  std::vector<std::filesystem::path> files;
+
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.path().extension() == ".svg") {
+      files.push_back(entry.path());
+    }
+  }
+
+  std::sort(files.begin(), files.end());
+
+  io::json::JSON results = io::json::JSON::object();
+  io::json::JSON& results_files = results["files"] = io::json::JSON::array();
+
+  results["version"] = json_version;
+
+  io::json::JSON& results_paths = results["path_access"] = io::json::JSON::array();
+
+  for (const uint32_t segments : path_access_sizes) {
+    io::json::JSON path_result = io::json::JSON::object();
+
+    bench_path_access(segments, path_result);
+
+    printf("path access %6d segments  segment_at %9.3f ms  node_at %9.3f ms  split %9.3f ms\n",
+           path_result["segments"].to_int(),
+           path_result["segment_at_ms"].to_float(),
+           path_result["node_at_ms"].to_float(),
+           path_result["split_ms"].to_float());
+
+    results_paths.append(std::move(path_result));
+  }
+
+  io::json::JSON& results_clips = results["clip"] = io::json::JSON::array();
+
+  for (const uint32_t segments : clip_sizes) {
+    io::json::JSON clip_result = io::json::JSON::object();
+
+    bench_clip(segments, clip_result);
+
+    printf("clip %13d segments  curves %8d  10%% %9.3f ms  50%% %9.3f ms\n",
+           clip_result["segments"].to_int(),
+           clip_result["curves"].to_int(),
+           clip_result["clip_ms"][0u].to_float(),
+           clip_result["clip_ms"][1u].to_float());
+
+    results_clips.append(std::move(clip_result));
+  }
+
+  io::json::JSON& results_strokes = results["stroke"] = io::json::JSON::array();
+  utils::JobSystem jobs;
+
+  for (const uint32_t segments : stroke_sizes) {
+    io::json::JSON stroke_result = io::json::JSON::object();
+
+    bench_stroke(segments, jobs, stroke_result);
+
+    printf("stroke %11d segments  workers %6d  serial %9.3f ms  split %9.3f ms  %s\n",
+           stroke_result["segments"].to_int(),
+           stroke_result["workers"].to_int(),
+           stroke_result["stroke_ms"].to_float(),
+           stroke_result["split_stroke_ms"].to_float(),
+           stroke_result["same"].to_bool() ? "same" : "DIFFERENT");
+
+    failed |= !stroke_result["same"].to_bool();
+
+    results_strokes.append(std::move(stroke_result));
+  }
+
+  io::json::JSON& results_textures = results["textures"] = io::json::JSON::object();
+
+  bench_textures(results_textures);
+
+  printf("textures %7d x %-4d  first upload %9d bytes  second upload %9d bytes  %s"
+         "  zoom out upload %9d bytes  decoded upload %9d bytes  %s\n",
+         results_textures["image_size"].to_int(),
+         results_textures["image_size"].to_int(),
+         results_textures["first_upload_bytes"].to_int(),
+         results_textures["second_upload_bytes"].to_int(),
+         results_textures["finest"].to_bool() ? "finest" : "WRONG LEVEL",
+         results_textures["zoom_out_upload_bytes"].to_int(),
+         results_textures["decoded_upload_bytes"].to_int(),
+         results_textures["deferred"].to_bool() ? "deferred" : "NOT DEFERRED");
+
+  for (const std::filesystem::path& file : files) {
+    const std::string name = file.filename().string();
+
+    io::json::JSON file_result = io::json::JSON::object();
+    io::json::JSON& views = file_result["views"] = io::json::JSON::array();
+
+    file_result["name"] = name;
+
+    const std::vector<BenchPath> paths = bench_scene(read_file(file), file_result);
+
+    printf("%-28s elements %6d  strokes %6d  parse %9.3f ms  transform %9.3f ms"
+           "  stroke %9.3f ms  geometry %9.3f ms  allocations %d\n",
+           name.c_str(),
+           file_result["elements"].to_int(),
+           file_result["strokes"].to_int(),
+           file_result["parse_ms"].to_float(),
+           file_result["transform_ms"].to_float(),
+           file_result["stroke_ms"].to_float(),
+           file_result["geometry_ms"].to_float(),
+           file_result["geometry_allocations"].to_int());
+
+    failed |= file_result["geometry_allocations"].to_int() != 0;
+
+    for (const double zoom : zooms) {
+      for (const ivec2 viewport_size : viewports) {
+        io::json::JSON view = io::json::JSON::object();
+
+        bench_view(paths, zoom, viewport_size, view);
+
+        printf("  zoom %5.0f  %4d x %-4d  clip %9.3f ms (%d allocations)  tile %9.3f ms"
+               "  batch %9.3f ms  rebuild %9.3f ms  tiles %8d  culled %8d  offscreen %8d"
+               "  fills %8d  curves %8d  batches %4d  bytes/tile %5.1f  stale %6d"
+               "  frame allocations %d\n",
+               zoom,
+               viewport_size.x,
+               viewport_size.y,
+               view["clip_ms"].to_float(),
+               view["clip_allocations"].to_int(),
+               view["tile_ms"].to_float(),
+               view["batch_ms"].to_float(),
+               view["rebuild_batch_ms"].to_float(),
+               view["tiles"].to_int(),
+               view["culled_tiles"].to_int(),
+               view["offscreen_tiles"].to_int(),
+               view["fills"].to_int(),
+               view["curves"].to_int(),
+               view["batches"].to_int(),
+               view["batch_tile_bytes"].to_float(),
+               view["stale_LODs"].to_int(),
+               view["frame_allocations"].to_int());
+
+        failed |= view["clip_allocations"].to_int() != 0 ||
+                  view["frame_allocations"].to_int() != 0;
+
+        views.append(std::move(view));
+      }
+    }
+
+    results_files.append(std::move(file_result));
+  }
+
+  if (!json_path.empty()) {
+    std::ofstream ofs(json_path);
+    ofs << results.dump() << std::endl;
+  }
+
+  editor::Editor::shutdown();
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+
+  if (failed) {
+    printf("Failed: allocations once warmed up or split strokes are different\n");
+    return 1;
+  }
+
+  return 0;
+}
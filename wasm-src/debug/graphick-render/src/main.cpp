@@ -0,0 +1,307 @@
+/**
+ * @file graphick-render/src/main.cpp
+ * @brief Headless batch renderer, converts SVG files to PNG images on the CPU.
+ *
+ * Documents are distributed across threads, each thread owns an independent editor (scene,
+ * resource manager, renderer and software device), so no state is shared between documents.
+ *
+ * Usage: graphick-render [-j threads] [-s scale] [-o output_directory] <svg files or directories>
+ */
+
+#include "wasm-src/editor/editor.h"
+
+#include "wasm-src/io/svg/svg.h"
+
+#include "wasm-src/renderer/gpu/device.h"
+#include "wasm-src/renderer/renderer.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace graphick;
+
+/**
+ * @brief The command line options.
+ */
+struct Options {
+  std::vector<std::filesystem::path> files;  // The SVG files to render.
+  std::filesystem::path output;              // The directory to write the PNG images to.
+
+  size_t threads = 0;                        // The number of documents rendered concurrently.
+  float scale = 1.0f;                        // The scale factor from SVG units to pixels.
+};
+
+/**
+ * @brief The result of rendering a single document, timings are in milliseconds.
+ */
+struct DocumentStats {
+  bool success = false;    // Whether the image was written.
+  ivec2 size;              // The size of the image in pixels.
+  size_t drawables = 0;    // The number of drawables of the scene.
+
+  double parse_time = 0;   // The time spent parsing the SVG.
+  double tile_time = 0;    // The time spent stroking and tiling the paths.
+  double raster_time = 0;  // The time spent by the device rasterizing the frame.
+  double render_time = 0;  // The total time spent rendering the frame.
+  double encode_time = 0;  // The time spent reading back and encoding the image.
+};
+
+/**
+ * @brief The maximum size of an output image along each axis, in pixels.
+ */
+static constexpr int max_image_size = 16384;
+
+/**
+ * @brief Returns the current time in milliseconds.
+ */
+static inline double now()
+{
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Renders a document with the editor of the calling thread and writes it as a PNG image.
+ *
+ * @param file The SVG file to render.
+ * @param options The command line options.
+ * @return The statistics of the document.
+ */
+static DocumentStats render_document(const std::filesystem::path& file, const Options& options)
+{
+  DocumentStats stats;
+
+  std::ifstream ifs(file);
+  std::stringstream content;
+
+  content << ifs.rdbuf();
+
+  editor::Editor::new_scene();
+  editor::Scene& scene = editor::Editor::scene();
+
+  double start = now();
+
+  if (!io::svg::parse_svg(content.str())) {
+    return stats;
+  }
+
+  stats.parse_time = now() - start;
+
+  /* The image is fitted to the content, the SVG viewBox is not parsed yet. The bounds of the
+   * scene include the strokes, the images and the transforms of the groups. */
+
+  const drect content_rect = drect(scene.bounding_rect());
+
+  if (content_rect.size().x <= 0.0 && content_rect.size().y <= 0.0) {
+    return stats;
+  }
+
+  /* A pixel of padding keeps antialiased edges inside the image. */
+  const drect bounding_rect = drect::expand(content_rect, 1.0 / options.scale);
+  const dvec2 size = math::ceil(bounding_rect.size() * static_cast<double>(options.scale));
+
+  if (size.x > max_image_size || size.y > max_image_size) {
+    return stats;
+  }
+
+  stats.size = ivec2(size);
+
+  scene.viewport.resize(stats.size, ivec2::zero(), 1.0f);
+  scene.viewport.zoom_to(options.scale);
+  scene.viewport.move_to(vec2(-bounding_rect.min));
+
+  start = now();
+
+  editor::Editor::request_render({true, false});
+  editor::Editor::render_loop(start);
+
+  const renderer::RenderStats& render_stats = renderer::Renderer::stats();
+
+  stats.render_time = now() - start;
+  stats.tile_time = render_stats.tile_time / 1e6;
+  stats.raster_time = render_stats.gpu_time / 1e6;
+  stats.drawables = render_stats.drawables;
+
+  start = now();
+
+  const size_t stride = static_cast<size_t>(stats.size.x) * 4;
+
+  std::vector<uint8_t> pixels(stride * stats.size.y);
+  std::vector<uint8_t> image(pixels.size());
+
+  renderer::GPU::Device::read_pixels(irect(ivec2::zero(), stats.size), pixels.data());
+
+  /* Rows are read from the bottom up, PNG images are stored from the top down. */
+  for (int y = 0; y < stats.size.y; y++) {
+    const size_t row = static_cast<size_t>(stats.size.y - 1 - y);
+    std::memcpy(image.data() + y * stride, pixels.data() + row * stride, stride);
+  }
+
+  const std::filesystem::path output = options.output /
+                                       file.filename().replace_extension(".png");
+
+  stats.success = stbi_write_png(output.string().c_str(),
+                                 stats.size.x,
+                                 stats.size.y,
+                                 4,
+                                 image.data(),
+                                 static_cast<int>(stride)) != 0;
+  stats.encode_time = now() - start;
+
+  return stats;
+}
+
+/**
+ * @brief Renders documents until there are none left, called by each thread.
+ *
+ * @param options The command line options.
+ * @param next The index of the next document to render, shared between threads.
+ * @param stats The statistics of each document.
+ */
+static void render_documents(const Options& options,
+                             std::atomic<size_t>& next,
+                             std::vector<DocumentStats>& stats)
+{
+  editor::Editor::init();
+
+  for (size_t i = next.fetch_add(1); i < options.files.size(); i = next.fetch_add(1)) {
+    stats[i] = render_document(options.files[i], options);
+  }
+
+  editor::Editor::shutdown();
+}
+
+/**
+ * @brief Parses the command line arguments.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @param options The options to fill.
+ * @return Whether the arguments are valid.
+ */
+static bool parse_arguments(const int argc, char** argv, Options& options)
+{
+  options.output = std::filesystem::current_path();
+  options.threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+
+    if ((arg == "-j" || arg == "-s" || arg == "-o") && i + 1 >= argc) {
+      return false;
+    }
+
+    if (arg == "-j") {
+      options.threads = std::max(std::atoi(argv[++i]), 1);
+    } else if (arg == "-s") {
+      options.scale = static_cast<float>(std::atof(argv[++i]));
+    } else if (arg == "-o") {
+      options.output = argv[++i];
+    } else if (std::filesystem::is_directory(arg)) {
+      for (const auto& entry : std::filesystem::directory_iterator(arg)) {
+        if (entry.path().extension() == ".svg") {
+          options.files.push_back(entry.path());
+        }
+      }
+    } else {
+      options.files.push_back(arg);
+    }
+  }
+
+  std::sort(options.files.begin(), options.files.end());
+
+  return !options.files.empty() && options.scale > 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+  Options options;
+
+  if (!parse_arguments(argc, argv, options)) {
+    printf("Usage: graphick-render [-j threads] [-s scale] [-o output_directory] <files>\n");
+    return -1;
+  }
+
+  std::filesystem::create_directories(options.output);
+
+  /* The cores are split between the documents: each renderer and device gets an equal share of
+   * worker threads, in addition to the thread of the document. */
+
+  const size_t threads = std::min(options.threads, options.files.size());
+  const size_t hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  renderer::RendererSettings::max_workers = std::max(hardware_threads / threads, size_t(1)) - 1;
+
+  std::vector<DocumentStats> stats(options.files.size());
+  std::vector<std::thread> workers;
+  std::atomic<size_t> next = 0;
+
+  const double start = now();
+
+  for (size_t i = 1; i < threads; i++) {
+    workers.emplace_back(render_documents, std::cref(options), std::ref(next), std::ref(stats));
+  }
+
+  render_documents(options, next, stats);
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  const double time = now() - start;
+
+  DocumentStats total;
+  size_t failed = 0;
+
+  for (size_t i = 0; i < options.files.size(); i++) {
+    const DocumentStats& document = stats[i];
+
+    if (!document.success) {
+      printf("%-28s failed\n", options.files[i].filename().string().c_str());
+      failed++;
+      continue;
+    }
+
+    printf("%-28s %5d x %-5d  drawables %7zu  parse %9.3f ms  tile %9.3f ms  raster %9.3f ms"
+           "  render %9.3f ms  encode %9.3f ms\n",
+           options.files[i].filename().string().c_str(),
+           document.size.x,
+           document.size.y,
+           document.drawables,
+           document.parse_time,
+           document.tile_time,
+           document.raster_time,
+           document.render_time,
+           document.encode_time);
+
+    total.parse_time += document.parse_time;
+    total.tile_time += document.tile_time;
+    total.raster_time += document.raster_time;
+    total.render_time += document.render_time;
+    total.encode_time += document.encode_time;
+  }
+
+  printf("\n%zu documents (%zu failed) on %zu threads in %.3f ms, %.1f documents/s\n",
+         options.files.size(),
+         failed,
+         threads,
+         time,
+         options.files.size() * 1000.0 / time);
+  printf("total: parse %.3f ms  tile %.3f ms  raster %.3f ms  render %.3f ms  encode %.3f ms\n",
+         total.parse_time,
+         total.tile_time,
+         total.raster_time,
+         total.render_time,
+         total.encode_time);
+
+  return failed == 0 ? 0 : 1;
+}
@@ -40,6 +40,8 @@ workspace "graphick-debug"
     "%{prj.name}/lib/**.h",
     "%{prj.name}/lib/**.hpp",
     "%{prj.name}/lib/**.cpp",
+    "graphick-bench/**",
+    "graphick-render/**"
   }
 
   includedirs {
@@ -93,3 +95,153 @@ workspace "graphick-debug"
     optimize "On"
     symbols "Off"
     floatingpoint "Fast"
+
+  filter {}
+
+  project "graphick-bench"
+  kind "ConsoleApp"
+  language "C++"
+  location "graphick-bench"
+  cppdialect "C++17"
+  staticruntime "off"
+
+  targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+  files {
+    "../**.h",
+    "../**.hpp",
+    "../**.cpp",
+    "%{prj.name}/src/**.h",
+    "%{prj.name}/src/**.cpp"
+  }
+
+  removefiles {
+    "../export.cpp",
+    "graphick-debug/**",
+    "graphick-render/**"
+  }
+
+  includedirs {
+    "%{prj.name}/src",
+    "%{IncludeDir.glfw}",
+    "%{IncludeDir.glad}",
+    "../../"
+  }
+
+  links {
+    "glfw",
+    "glad",
+    "opengl32.lib"
+  }
+
+  defines {
+    "GLFW_INCLUDE_NONE"
+  }
+
+  linkoptions { 
+    "/NODEFAULTLIB:\"LIBCMTD\"",
+    "/NODEFAULTLIB:\"LIBCMT\""
+  }
+
+  flags {
+    "MultiProcessorCompile"
+  }
+
+  filter "system:windows"
+    systemversion "latest"
+
+    defines {
+      "GK_PLATFORM_WINDOWS"
+    }
+
+  filter "configurations:Debug"
+    defines { "GK_CONF_DEBUG" }
+    runtime "Debug"
+    symbols "On"
+
+  filter "configurations:Release"
+    defines { "GK_CONF_RELEASE" }
+    runtime "Release"
+    optimize "On"
+    symbols "On"
+    floatingpoint "Fast"
+
+  filter "configurations:Dist"
+    defines { "GK_CONF_DIST" }
+    runtime "Release"
+    optimize "On"
+    symbols "Off"
+    floatingpoint "Fast"
+
+  filter {}
+
+  project "graphick-render"
+  kind "ConsoleApp"
+  language "C++"
+  location "graphick-render"
+  cppdialect "C++17"
+  staticruntime "off"
+
+  targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+  files {
+    "../**.h",
+    "../**.hpp",
+    "../**.cpp",
+    "%{prj.name}/src/**.h",
+    "%{prj.name}/src/**.cpp"
+  }
+
+  removefiles {
+    "../export.cpp",
+    "graphick-debug/**",
+    "graphick-bench/**"
+  }
+
+  includedirs {
+    "%{prj.name}/src",
+    "graphick-debug/lib/glfw/deps",
+    "../../"
+  }
+
+  defines {
+    "GK_SOFTWARE",
+    "ENTT_USE_ATOMIC"
+  }
+
+  flags {
+    "MultiProcessorCompile"
+  }
+
+  filter "system:windows"
+    systemversion "latest"
+
+    defines {
+      "GK_PLATFORM_WINDOWS"
+    }
+
+  filter "system:linux"
+    links {
+      "pthread"
+    }
+
+  filter "configurations:Debug"
+    defines { "GK_CONF_DEBUG" }
+    runtime "Debug"
+    symbols "On"
+
+  filter "configurations:Release"
+    defines { "GK_CONF_RELEASE" }
+    runtime "Release"
+    optimize "On"
+    symbols "On"
+    floatingpoint "Fast"
+
+  filter "configurations:Dist"
+    defines { "GK_CONF_DIST" }
+    runtime "Release"
+    optimize "On"
+    symbols "Off"
+    floatingpoint "Fast"
@@ -50,7 +50,7 @@ bool render_callback(const double time, void* user_data)
     } \
   }
 
-Editor* Editor::s_instance = nullptr;
+thread_local Editor* Editor::s_instance = nullptr;
 
 void Editor::init()
 {
@@ -106,6 +106,12 @@ Scene& Editor::scene()
   return get()->m_scenes[0];
 }
 
+void Editor::new_scene()
+{
+  get()->m_scenes.clear();
+  get()->m_scenes.emplace_back();
+}
+
 void Editor::resize(const ivec2 size, const ivec2 offset, float dpr)
 {
   console::log(ui_data());
@@ -316,6 +322,11 @@ void Editor::modify_ui_data(const std::string& data)
 
 bool Editor::render_frame(const double time)
 {
+  /* Images decoded in the background replace their placeholders in the next frame. */
+  if (io::ResourceManager::poll_images() > 0) {
+    request_render({false, false});
+  }
+
   if (!m_render_request.has_value())
     return false;
 
@@ -49,6 +49,9 @@ struct RenderRequestOptions {
  * @brief The main Graphick Editor singleton.
  *
  * This class is responsible for managing and rendering the scenes.
+ * There is one instance per thread: init() also initializes the input manager, the resource
+ * manager and the renderer of the calling thread, so that headless tools can process independent
+ * documents in parallel.
  */
 class Editor {
  public:
@@ -87,6 +90,13 @@ class Editor {
    */
   static Scene& scene();
 
+  /**
+   * @brief Replaces all of the scenes with a new empty one, i.e. before loading a new document.
+   *
+   * The renderer cache is owned by the scene, so it is discarded too.
+   */
+  static void new_scene();
+
   /**
    * @brief Resizes the editor.
    *
@@ -169,7 +179,7 @@ class Editor {
   friend bool render_callback(const double time, void* user_data);
 
  private:
-  static Editor* s_instance;  // The editor's singleton instance.
+  static thread_local Editor* s_instance;  // The editor's instance of this thread.
 };
 
 }  // namespace graphick::editor
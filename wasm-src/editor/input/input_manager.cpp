@@ -22,10 +22,10 @@
 
 namespace graphick::editor::input {
 
-InputManager* InputManager::s_instance = nullptr;
-InputManager::Pointer InputManager::pointer{};
-InputManager::KeysState InputManager::keys{};
-HoverState InputManager::hover{};
+thread_local InputManager* InputManager::s_instance = nullptr;
+thread_local InputManager::Pointer InputManager::pointer{};
+thread_local InputManager::KeysState InputManager::keys{};
+thread_local HoverState InputManager::hover{};
 
 void InputManager::init()
 {
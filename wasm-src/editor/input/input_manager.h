@@ -114,9 +114,9 @@ class InputManager {
   };
 
  public:
-  static KeysState keys;    // The state of the keys.
-  static Pointer pointer;   // The state of the pointer.
-  static HoverState hover;  // The hover state of the pointer.
+  static thread_local KeysState keys;    // The state of the keys.
+  static thread_local Pointer pointer;   // The state of the pointer.
+  static thread_local HoverState hover;  // The hover state of the pointer.
  public:
   /**
    * @brief Deleted copy and move constructors.
@@ -397,10 +397,10 @@ class InputManager {
   bool on_drag(PointerTarget target, float delta_x, float delta_y);
 
  private:
-  bool m_moving = false;            // Whether the pointer is moving.
-  bool m_abort = false;             // Whether the pointer event should be aborted.
+  bool m_moving = false;                         // Whether the pointer is moving.
+  bool m_abort = false;                          // Whether the pointer event should be aborted.
  private:
-  static InputManager *s_instance;  // The static instance of the InputManager singleton.
+  static thread_local InputManager *s_instance;  // The InputManager instance of this thread.
 };
 
 }  // namespace graphick::editor::input
@@ -19,29 +19,45 @@ void Cache::clear()
   }
 }
 
-void Cache::clear(const uuid entity_id, const Scene* scene)
+void Cache::clear(const uuid entity_id, const Scene* scene, const bool transform_only)
 {
-  renderer_cache.clear(entity_id);
+  if (transform_only) {
+    renderer_cache.clear_transform(entity_id);
+  } else {
+    renderer_cache.clear(entity_id);
+  }
 
+  /* The rebuild also drops the segment indices of the removed entities. */
   if (!scene->has_entity(entity_id)) {
+    spatial_index.invalidate();
     return;
   }
 
   Entity entity = scene->get_entity(entity_id);
 
+  if (entity.is_group() || entity.is_layer()) {
+    /* The children of groups and layers could have changed, their transforms are handled by
+     * invalidating each child. */
+    if (!transform_only) {
+      spatial_index.invalidate();
+    }
+  } else {
+    spatial_index.invalidate(entity_id, transform_only);
+  }
+
   if (entity.is_group()) {
     const GroupComponent& group = entity.get_component<GroupComponent>();
 
     for (auto it = group.begin(); it != group.end(); it++) {
       Entity child = Entity(*it, const_cast<Scene*>(scene));
-      clear(child.id(), scene);
+      clear(child.id(), scene, transform_only);
     }
   } else if (entity.is_layer()) {
     const LayerComponent& layer = entity.get_component<LayerComponent>();
 
     for (auto it = layer.begin(); it != layer.end(); it++) {
       Entity child = Entity(*it, const_cast<Scene*>(scene));
-      clear(child.id(), scene);
+      clear(child.id(), scene, transform_only);
     }
   }
 }
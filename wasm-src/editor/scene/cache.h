@@ -9,6 +9,8 @@
 
 #include "../../renderer/renderer_cache.h"
 
+#include "spatial_index.h"
+
 #include <vector>
 
 namespace graphick::editor {
@@ -23,6 +25,7 @@ class Scene;
 class Cache {
  public:
   renderer::RendererCache renderer_cache;  // The renderer cache.
+  SpatialIndex spatial_index;              // The bounds of the drawable entities.
  public:
   /**
    * @brief Clears the cache.
@@ -33,8 +36,11 @@ class Cache {
    * @brief Clears the cache of the given entity.
    *
    * @param entity_id The id of the entity to clear.
+   * @param scene The scene the entity belongs to.
+   * @param transform_only Whether only the transform of the entity changed, cached drawables are
+   * kept to be moved to the new transform.
    */
-  void clear(const uuid entity_id, const Scene* scene);
+  void clear(const uuid entity_id, const Scene* scene, const bool transform_only = false);
 
   /**
    * @brief Sets the portion of the screen that is cached.
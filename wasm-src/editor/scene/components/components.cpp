@@ -422,7 +422,7 @@ ImageData::ImageData(io::DataDecoder& decoder) : image_id(decoder.uuid()) {}
 
 rect ImageData::bounding_rect() const
 {
-  const vec2 size = vec2(io::ResourceManager::get_image(image_id).size);
+  const vec2 size = vec2(io::ResourceManager::get_image_size(image_id));
   return rect(vec2::zero(), size);
 }
 
@@ -433,12 +433,12 @@ const uint8_t* ImageComponent::data() const
 
 ivec2 ImageComponent::size() const
 {
-  return io::ResourceManager::get_image(id()).size;
+  return io::ResourceManager::get_image_size(id());
 }
 
 uint8_t ImageComponent::channels() const
 {
-  return io::ResourceManager::get_image(id()).channels;
+  return io::ResourceManager::get_image_channels(id());
 }
 
 geom::path ImageComponent::path() const
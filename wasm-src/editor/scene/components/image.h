@@ -63,6 +63,9 @@ struct ImageComponent : public ComponentWrapper {
   /**
    * @brief Returns the image data of the entity.
    *
+   * The full resolution image is decoded again if its data was released, see
+   * io::ResourceManager::get_image().
+   *
    * @return The image data of the entity.
    */
   const uint8_t* data() const;
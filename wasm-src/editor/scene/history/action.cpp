@@ -180,6 +180,15 @@ bool Action::merge(Action& other)
   return true;
 }
 
+void Action::clear_cache(Scene* scene) const
+{
+  const bool transform_only = type == Type::Modify &&
+                              io::DataDecoder(&m_data).component_id() ==
+                                  TransformComponent::component_id;
+
+  scene->m_cache.clear(entity_id, scene, transform_only);
+}
+
 void Action::execute_add(Scene* scene) const
 {
   if (target == Target::Entity) {
@@ -244,7 +253,7 @@ void Action::execute_remove(Scene* scene) const
 void Action::execute_modify(Scene* scene) const
 {
   scene->get_entity(entity_id).modify(m_data);
-  scene->m_cache.clear(entity_id, scene);
+  clear_cache(scene);
 
   // Entity entity = scene->get_entity(entity_id);
   // rect bounding_rect_before = entity.get_component<TransformComponent>().approx_bounding_rect();
@@ -321,7 +330,7 @@ void Action::revert_remove(Scene* scene) const
 void Action::revert_modify(Scene* scene) const
 {
   scene->get_entity(entity_id).modify(m_backup);
-  scene->m_cache.clear(entity_id, scene);
+  clear_cache(scene);
 
   // Entity entity = scene->get_entity(entity_id);
   // rect bounding_rect_before = entity.get_component<TransformComponent>().approx_bounding_rect();
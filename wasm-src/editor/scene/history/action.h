@@ -112,6 +112,15 @@ struct Action {
    */
   bool merge(Action &other);
 
+  /**
+   * @brief Clears the cache of the affected entity.
+   *
+   * If the action only modifies the transform of the entity, cached drawables are kept.
+   *
+   * @param scene The scene the entity belongs to.
+   */
+  void clear_cache(Scene *scene) const;
+
  private:
   /**
    * @brief Executes the add action.
@@ -11,7 +11,6 @@
  * @todo refactor and abstract away entity related methods in render()
  * @todo when scene serialization is a thing, implement copy constructor
  * @todo implement layer and groups history
- * @todo entity_at with open path not working (close the path)
  */
 
 #include "scene.h"
@@ -397,7 +396,7 @@ struct EntityAtOptions {
 
   HitTestType hit_test_type = HitTestType::All;
 
-  const Cache* cache = nullptr;
+  Cache* cache = nullptr;
   const Scene* scene = nullptr;
 
   EntityAtOptions(Hierarchy& hierarchy) : hierarchy(hierarchy) {}
@@ -462,7 +461,8 @@ static bool is_entity_at(const Entity entity, const EntityAtOptions& options)
                                      has_stroke ? &stroking_options : nullptr,
                                      options.hierarchy.transform() * transform,
                                      options.threshold,
-                                     deep_search_entity);
+                                     deep_search_entity,
+                                     &options.cache->spatial_index.segments(id, path));
   } else if (entity.is_image()) {
     const TransformComponent transform = entity.get_component<TransformComponent>();
     const ImageComponent image = entity.get_component<ImageComponent>();
@@ -515,28 +515,37 @@ uuid Scene::entity_at(const vec2 position, const bool deep_search, const float t
     }
   }
 
-  const float tolerance = static_cast<float>(Settings::Renderer::stroking_tolerance);
+  /* Only the entities whose bounds contain the position are hit tested, front to back. */
 
-  uuid return_id = uuid::null;
+  m_cache.spatial_index.update(this);
 
-  ForEachOptions options;
+  const rect query_rect = {position - local_threshold, position + local_threshold};
+  const std::vector<const SpatialIndex::Entry*> entries = m_cache.spatial_index.query(query_rect);
 
-  options.reverse = true;
   entity_at_options.hit_test_type = HitTestType::All;
 
-  for_each(
-      [&](const Entity entity, const Hierarchy& hierarchy) {
-        entity_at_options.hierarchy = hierarchy;
+  for (auto it = entries.rbegin(); it != entries.rend(); it++) {
+    const SpatialIndex::Entry* entry = *it;
 
-        if (editor::is_entity_at(entity, entity_at_options)) {
-          return_id = deep_search || hierarchy.entries.empty() ? entity.id() :
-                                                                 hierarchy.entries.front().id;
-          options.break_and_return = true;
-        }
-      },
-      options);
+    Hierarchy hierarchy;
+
+    for (const uuid group_id : entry->groups) {
+      const Entity group = get_entity(group_id);
+
+      hierarchy.push({group_id,
+                      false,
+                      selection.has(group_id, true),
+                      group.get_component<TransformComponent>().matrix()});
+    }
+
+    entity_at_options.hierarchy = hierarchy;
+
+    if (editor::is_entity_at({entry->entity, const_cast<Scene*>(this)}, entity_at_options)) {
+      return deep_search || hierarchy.entries.empty() ? entry->id : hierarchy.entries.front().id;
+    }
+  }
 
-  return return_id;
+  return uuid::null;
 }
 
 Entity Scene::duplicate_entity(const uuid id)
@@ -674,6 +683,12 @@ std::unordered_map<uuid, Selection::SelectionEntry> Scene::entities_in(const mat
   return entities;
 }
 
+rect Scene::bounding_rect() const
+{
+  m_cache.spatial_index.update(this);
+  return m_cache.spatial_index.bounding_rect();
+}
+
 void Scene::group_selected()
 {
   // TODO: handle multiple layers
@@ -864,30 +879,36 @@ void Scene::render(const bool ignore_cache) const
 
   renderer::Outline outline = {nullptr, draw_vertices, Settings::Renderer::ui_primary_color};
 
-  ForEachOptions options;
+  /* Only the entities intersecting the viewport are visited, the margin accounts for the UI
+   * handles of selected entities. */
 
-  options.callback_on_layers = true;
+  const float margin = static_cast<float>(Settings::Renderer::ui_handle_size * 2.0 / zoom);
+  const rect visible_rect = rect::expand(rect(rendering_viewport.visible()), margin);
 
-  for_each(
-      [&](const Entity entity, const Hierarchy& hierarchy) {
-        const uuid id = entity.id();
+  m_cache.spatial_index.update(this);
 
-        const bool parent_selected = hierarchy.selected();
-        const bool selected = parent_selected || selection.has(id, true);
+  for (const SpatialIndex::Entry* entry : m_cache.spatial_index.query(visible_rect)) {
+    const Entity entity = {entry->entity, const_cast<Scene*>(this)};
+    const uuid id = entry->id;
 
-        if (entity.is_element()) {
-          render_element(entity, id, hierarchy.transform(), selected, &m_registry, &outline, this);
-        } else if (entity.is_image()) {
-          render_image(entity, id, hierarchy.transform(), selected, &m_registry, &outline, this);
-        } else if (entity.is_text()) {
+    const bool parent_selected = std::any_of(entry->groups.begin(),
+                                             entry->groups.end(),
+                                             [&](const uuid group_id) {
+                                               return selection.has(group_id, true);
+                                             });
+    const bool selected = parent_selected || selection.has(id, true);
 
-        } else if (entity.is_layer()) {
-          const LayerComponent layer = entity.get_component<LayerComponent>();
+    if (selected) {
+      const Entity layer = {entry->layer, const_cast<Scene*>(this)};
+      outline.color = layer.get_component<LayerComponent>().color();
+    }
 
-          outline.color = layer.color();
-        }
-      },
-      options);
+    if (entity.is_element()) {
+      render_element(entity, id, entry->parent_transform, selected, &m_registry, &outline, this);
+    } else if (entity.is_image()) {
+      render_image(entity, id, entry->parent_transform, selected, &m_registry, &outline, this);
+    }
+  }
 
   tool_state.render_overlays(get_active_layer().get_component<LayerComponent>().color(),
                              viewport.zoom());
@@ -268,6 +268,16 @@ class Scene {
   std::unordered_map<uuid, Selection::SelectionEntry> entities_in(const math::rect& rect,
                                                                   bool deep_search = false);
 
+  /**
+   * @brief Returns the bounding rectangle of the drawable entities of the scene.
+   *
+   * The bounds are the ones used to cull the entities: they contain the control points of the
+   * paths, the stroke extent (caps and miter joins included) and images, in world space.
+   *
+   * @return The bounding rectangle, empty if the scene has nothing to draw.
+   */
+  rect bounding_rect() const;
+
   /**
    * @brief Groups the selected entities.
    */
@@ -331,6 +341,7 @@ class Scene {
   friend class Editor;
   friend class Entity;
   friend class History;
+  friend class SpatialIndex;
   friend struct Action;
 };
 
@@ -0,0 +1,227 @@
+/**
+ * @file editor/scene/spatial_index.cpp
+ * @brief This file contains the implementation of the SpatialIndex class.
+ */
+
+#include "spatial_index.h"
+
+#include "entity.h"
+#include "scene.h"
+
+#include "../../math/matrix.h"
+#include "../../math/vector.h"
+
+#include "../../utils/debugger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace graphick::editor {
+
+/**
+ * @brief Calculates a conservative world-space bounding rectangle of a drawable entity.
+ *
+ * The control points of paths are used instead of the exact curve bounds, so that the rectangle
+ * also contains the handles drawn for selected entities.
+ *
+ * @param entity The entity.
+ * @param parent_transform The combined transform of the groups containing the entity.
+ * @return The bounding rectangle, empty if the entity has nothing to draw.
+ */
+static rect entity_bounds(const Entity& entity, const mat2x3& parent_transform)
+{
+  if (entity.is_element()) {
+    const geom::path& path = entity.get_component<PathComponent>().data();
+
+    if (path.vacant()) {
+      return rect{};
+    }
+
+    const mat2x3 transform = parent_transform *
+                             entity.get_component<TransformComponent>().matrix();
+    const rect bounding_rect = transform * path.approx_bounding_rect();
+
+    if (!entity.has_component<StrokeComponent>()) {
+      return bounding_rect;
+    }
+
+    /* The stroke is not affected by the transform, square caps and miter joins can extend past
+     * half the width. */
+
+    const StrokeComponent stroke = entity.get_component<StrokeComponent>();
+    const float cap_extent = std::sqrt(2.0f);
+    const float extent = stroke.join() == geom::LineJoin::Miter ?
+                             std::max(cap_extent, stroke.miter_limit()) :
+                             cap_extent;
+
+    return rect::expand(bounding_rect, stroke.width() * 0.5f * extent);
+  } else if (entity.is_image() || entity.is_text()) {
+    return entity.get_component<TransformComponent>().bounding_rect(parent_transform);
+  }
+
+  return rect{};
+}
+
+void SpatialIndex::invalidate(const uuid id, const bool transform_only)
+{
+  if (!transform_only) {
+    m_segments.erase(id);
+  }
+
+  if (!m_valid) {
+    return;
+  }
+
+  if (m_indices.find(id) == m_indices.end()) {
+    m_valid = false;
+    return;
+  }
+
+  m_invalid_entries.insert(id);
+}
+
+void SpatialIndex::update(const Scene* scene)
+{
+  __debug_time_total();
+
+  if (m_valid && m_layers != scene->m_layers) {
+    m_valid = false;
+  }
+
+  if (!m_valid) {
+    rebuild(scene);
+    return;
+  }
+
+  for (const uuid& id : m_invalid_entries) {
+    refresh(m_indices.at(id), scene);
+  }
+
+  m_invalid_entries.clear();
+}
+
+std::vector<const SpatialIndex::Entry*> SpatialIndex::query(const rect& rect) const
+{
+  std::vector<uint32_t> indices;
+
+  m_tree.query(rect, [&](const int32_t proxy) { indices.push_back(m_tree.value(proxy)); });
+
+  std::sort(indices.begin(), indices.end());
+
+  std::vector<const Entry*> entries(indices.size());
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    entries[i] = &m_entries[indices[i]];
+  }
+
+  return entries;
+}
+
+const geom::SegmentIndex<float>& SpatialIndex::segments(const uuid id, const geom::path& path)
+{
+  auto it = m_segments.find(id);
+
+  if (it == m_segments.end()) {
+    it = m_segments.emplace(id, geom::SegmentIndex<float>(path.to_cubic_path())).first;
+  }
+
+  return it->second;
+}
+
+void SpatialIndex::rebuild(const Scene* scene)
+{
+  m_entries.clear();
+  m_indices.clear();
+  m_invalid_entries.clear();
+  m_tree.clear();
+
+  m_layers = scene->m_layers;
+
+  Scene::ForEachOptions options;
+  options.callback_on_layers = true;
+
+  entt::entity layer = entt::null;
+
+  scene->for_each(
+      [&](const Entity entity, const Hierarchy& hierarchy) {
+        if (entity.is_layer()) {
+          layer = entity;
+          return;
+        }
+
+        if (!entity.is_element() && !entity.is_image() && !entity.is_text()) {
+          return;
+        }
+
+        Entry& entry = m_entries.emplace_back(
+            Entry{entity, entity.id(), layer, {}, mat2x3{}, Tree::null_node});
+
+        for (const HierarchyEntry& group : hierarchy.entries) {
+          entry.groups.push_back(group.id);
+        }
+
+        m_indices[entry.id] = m_entries.size() - 1;
+
+        refresh(m_entries.size() - 1, scene);
+      },
+      options);
+
+  /* Segment indices are kept across rebuilds, only the ones of removed entities are dropped. */
+
+  for (auto it = m_segments.begin(); it != m_segments.end();) {
+    if (m_indices.find(it->first) == m_indices.end()) {
+      it = m_segments.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  m_valid = true;
+}
+
+rect SpatialIndex::bounding_rect() const
+{
+  rect bounding_rect;
+
+  for (const Entry& entry : m_entries) {
+    if (entry.proxy == Tree::null_node) {
+      continue;
+    }
+
+    const rect& bounds = m_tree.bounds(entry.proxy);
+
+    bounding_rect.min = math::min(bounding_rect.min, bounds.min);
+    bounding_rect.max = math::max(bounding_rect.max, bounds.max);
+  }
+
+  return bounding_rect;
+}
+
+void SpatialIndex::refresh(const size_t index, const Scene* scene)
+{
+  Entry& entry = m_entries[index];
+
+  entry.parent_transform = mat2x3::identity();
+
+  for (const uuid& group_id : entry.groups) {
+    const Entity group = scene->get_entity(group_id);
+    entry.parent_transform = entry.parent_transform *
+                             group.get_component<TransformComponent>().matrix();
+  }
+
+  const Entity entity = {entry.entity, const_cast<Scene*>(scene)};
+  const rect bounds = entity_bounds(entity, entry.parent_transform);
+
+  if (bounds.min.x > bounds.max.x || bounds.min.y > bounds.max.y) {
+    if (entry.proxy != Tree::null_node) {
+      m_tree.remove(entry.proxy);
+      entry.proxy = Tree::null_node;
+    }
+  } else if (entry.proxy == Tree::null_node) {
+    entry.proxy = m_tree.insert(bounds, static_cast<uint32_t>(index));
+  } else {
+    m_tree.update(entry.proxy, bounds);
+  }
+}
+
+}  // namespace graphick::editor
@@ -0,0 +1,144 @@
+/**
+ * @file editor/scene/spatial_index.h
+ * @brief This file contains the definition of the SpatialIndex class.
+ */
+
+#pragma once
+
+#include "../../geom/aabb_tree.h"
+#include "../../geom/path.h"
+#include "../../geom/segment_index.h"
+
+#include "../../lib/entt/entt.hpp"
+#include "../../math/mat2x3.h"
+#include "../../math/rect.h"
+#include "../../utils/uuid.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace graphick::editor {
+
+class Scene;
+
+/**
+ * @brief The SpatialIndex class keeps the world-space bounds of the drawable entities of a scene
+ * in a dynamic AABB tree, together with their position in the rendering order.
+ *
+ * Like the Cache, it is designed to be invalidated exclusively by the History class: bounds are
+ * refreshed incrementally when an entity is modified, while structural changes (i.e. entities
+ * added, removed or reordered) cause a full rebuild on the next update.
+ */
+class SpatialIndex {
+ public:
+  using Tree = geom::AABBTree<float, uint32_t>;  // The tree of the bounds, leaves store indices.
+
+  /**
+   * @brief An indexed entity, with the data needed to render it without walking the hierarchy.
+   */
+  struct Entry {
+    entt::entity entity;         // The indexed entity.
+    uuid id;                     // The id of the entity.
+
+    entt::entity layer;          // The layer containing the entity.
+    std::vector<uuid> groups;    // The groups containing the entity, outermost first.
+    mat2x3 parent_transform;     // The combined transform of the groups.
+
+    int32_t proxy;               // The leaf of the entity in the tree, null_node if not drawable.
+  };
+ public:
+  /**
+   * @brief Marks the whole index as invalid, it will be rebuilt on the next update.
+   */
+  inline void invalidate()
+  {
+    m_valid = false;
+  }
+
+  /**
+   * @brief Marks the bounds of an entity as invalid.
+   *
+   * If the entity is not indexed yet, the whole index is invalidated.
+   *
+   * @param id The id of the entity.
+   * @param transform_only Whether only the transform of the entity changed, the segment index of
+   * its path is kept.
+   */
+  void invalidate(const uuid id, const bool transform_only = false);
+
+  /**
+   * @brief Brings the index up to date with the scene.
+   *
+   * This method should be called before querying the index.
+   *
+   * @param scene The scene the index refers to.
+   */
+  void update(const Scene* scene);
+
+  /**
+   * @brief Returns the entries whose bounds intersect the given rectangle.
+   *
+   * @param rect The rectangle to query, in scene space.
+   * @return The entries intersecting the rectangle, in rendering order.
+   */
+  std::vector<const Entry*> query(const rect& rect) const;
+
+  /**
+   * @brief Returns the union of the bounds of the indexed entities, strokes included.
+   *
+   * @return The bounding rectangle in scene space, empty if no entity is drawable.
+   */
+  rect bounding_rect() const;
+
+  /**
+   * @brief Returns the cached segment index of the path of an element, building it if needed.
+   *
+   * The segment index is in the local space of the path, so it survives transform changes.
+   *
+   * @param id The id of the element.
+   * @param path The path of the element.
+   * @return The segment index of the path.
+   */
+  const geom::SegmentIndex<float>& segments(const uuid id, const geom::path& path);
+
+  /**
+   * @brief Returns the number of indexed entities.
+   *
+   * @return The number of indexed entities.
+   */
+  inline size_t size() const
+  {
+    return m_entries.size();
+  }
+
+ private:
+  /**
+   * @brief Rebuilds the whole index walking the hierarchy of the scene.
+   *
+   * @param scene The scene to index.
+   */
+  void rebuild(const Scene* scene);
+
+  /**
+   * @brief Recalculates the parent transform and the bounds of an entry.
+   *
+   * @param index The index of the entry.
+   * @param scene The scene the entry refers to.
+   */
+  void refresh(const size_t index, const Scene* scene);
+
+ private:
+  std::vector<Entry> m_entries;                 // The indexed entities, in rendering order.
+  std::unordered_map<uuid, size_t> m_indices;   // The index of each entry by entity id.
+  std::unordered_set<uuid> m_invalid_entries;   // The entities whose bounds are invalid.
+
+  std::unordered_map<uuid, geom::SegmentIndex<float>> m_segments;  // Segment indices of paths.
+
+  Tree m_tree;                                  // The tree of the entity bounds.
+
+  std::vector<entt::entity> m_layers;           // The layers of the scene when last rebuilt.
+  bool m_valid = false;                         // Whether the structure of the index is valid.
+};
+
+}  // namespace graphick::editor
@@ -131,6 +131,16 @@ void EMSCRIPTEN_KEEPALIVE load_image(const uint8_t* data, size_t buffer_size)
   editor::Editor::scene().create_image(image_id);
 }
 
+float EMSCRIPTEN_KEEPALIVE images_progress()
+{
+  return io::ResourceManager::images_progress();
+}
+
+bool EMSCRIPTEN_KEEPALIVE images_loaded()
+{
+  return io::ResourceManager::pending_images() == 0;
+}
+
 void EMSCRIPTEN_KEEPALIVE init()
 {
   editor::Editor::init();
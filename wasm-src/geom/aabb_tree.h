@@ -0,0 +1,474 @@
+/**
+ * @file aabb_tree.h
+ * @brief This file contains the definition of the AABBTree class, a dynamic bounding volume
+ * hierarchy.
+ */
+
+#pragma once
+
+#include "intersections.h"
+
+#include "../math/rect.h"
+#include "../math/vector.h"
+
+#include "../utils/assert.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace graphick::geom {
+
+/**
+ * @brief A dynamic tree of axis-aligned bounding boxes.
+ *
+ * Each leaf stores a value and its bounding box, internal nodes store the union of the boxes of
+ * their children. The tree is kept balanced with AVL rotations, so insertions, removals and
+ * updates are O(log n) and queries only visit the branches that intersect the query.
+ * Leaves are referenced by a proxy, which is stable until the leaf is removed.
+ *
+ * @note The insertion heuristic follows the one of Box2D's b2DynamicTree.
+ */
+template<typename T, typename V>
+class AABBTree {
+ public:
+  static constexpr int32_t null_node = -1;  // The invalid node index.
+ public:
+  /**
+   * @brief Default constructor.
+   */
+  AABBTree() = default;
+
+  /**
+   * @brief Returns the number of leaves in the tree.
+   *
+   * @return The number of leaves.
+   */
+  inline size_t size() const
+  {
+    return m_leaves_count;
+  }
+
+  /**
+   * @brief Checks whether the tree is empty.
+   *
+   * @return true if the tree has no leaves, false otherwise.
+   */
+  inline bool empty() const
+  {
+    return m_leaves_count == 0;
+  }
+
+  /**
+   * @brief Returns the value of a leaf.
+   *
+   * @param proxy The proxy of the leaf.
+   * @return The value of the leaf.
+   */
+  inline const V& value(const int32_t proxy) const
+  {
+    return m_nodes[proxy].value;
+  }
+
+  /**
+   * @brief Returns the bounding box of a leaf.
+   *
+   * @param proxy The proxy of the leaf.
+   * @return The bounding box of the leaf.
+   */
+  inline const math::Rect<T>& bounds(const int32_t proxy) const
+  {
+    return m_nodes[proxy].bounds;
+  }
+
+  /**
+   * @brief Removes all the leaves from the tree.
+   */
+  inline void clear()
+  {
+    m_nodes.clear();
+    m_root = null_node;
+    m_free_list = null_node;
+    m_leaves_count = 0;
+  }
+
+  /**
+   * @brief Inserts a new leaf in the tree.
+   *
+   * @param bounds The bounding box of the leaf.
+   * @param value The value of the leaf.
+   * @return The proxy of the new leaf.
+   */
+  int32_t insert(const math::Rect<T>& bounds, const V& value)
+  {
+    const int32_t proxy = allocate_node();
+
+    m_nodes[proxy].bounds = bounds;
+    m_nodes[proxy].value = value;
+    m_nodes[proxy].height = 0;
+
+    insert_leaf(proxy);
+
+    m_leaves_count++;
+
+    return proxy;
+  }
+
+  /**
+   * @brief Removes a leaf from the tree.
+   *
+   * @param proxy The proxy of the leaf to remove, invalidated by this call.
+   */
+  void remove(const int32_t proxy)
+  {
+    GK_ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(m_nodes.size()), "Invalid proxy!");
+    GK_ASSERT(m_nodes[proxy].is_leaf(), "Only leaves can be removed!");
+
+    remove_leaf(proxy);
+    free_node(proxy);
+
+    m_leaves_count--;
+  }
+
+  /**
+   * @brief Updates the bounding box of a leaf.
+   *
+   * The leaf is reinserted only if its bounding box changed.
+   *
+   * @param proxy The proxy of the leaf, it remains valid after this call.
+   * @param bounds The new bounding box of the leaf.
+   * @return true if the leaf was reinserted, false otherwise.
+   */
+  bool update(const int32_t proxy, const math::Rect<T>& bounds)
+  {
+    GK_ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(m_nodes.size()), "Invalid proxy!");
+    GK_ASSERT(m_nodes[proxy].is_leaf(), "Only leaves can be updated!");
+
+    if (m_nodes[proxy].bounds.min == bounds.min && m_nodes[proxy].bounds.max == bounds.max) {
+      return false;
+    }
+
+    remove_leaf(proxy);
+
+    m_nodes[proxy].bounds = bounds;
+
+    insert_leaf(proxy);
+
+    return true;
+  }
+
+  /**
+   * @brief Calls the callback for each leaf whose bounding box intersects the given rectangle.
+   *
+   * The order of the callbacks is not defined.
+   *
+   * @param rect The rectangle to query.
+   * @param callback The callback to call, with the proxy of the leaf as argument.
+   */
+  template<typename F>
+  void query(const math::Rect<T>& rect, F callback) const
+  {
+    if (m_root == null_node) {
+      return;
+    }
+
+    std::vector<int32_t> stack = {m_root};
+
+    while (!stack.empty()) {
+      const int32_t index = stack.back();
+      const Node& node = m_nodes[index];
+
+      stack.pop_back();
+
+      if (!does_rect_intersect_rect(node.bounds, rect)) {
+        continue;
+      }
+
+      if (node.is_leaf()) {
+        callback(index);
+      } else {
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief A node of the tree, leaves have no children.
+   */
+  struct Node {
+    math::Rect<T> bounds;         // The bounding box of the node.
+    V value;                      // The value of the leaf, unused for internal nodes.
+
+    int32_t parent = null_node;   // The parent node, or the next free node if unused.
+    int32_t left = null_node;     // The left child.
+    int32_t right = null_node;    // The right child.
+    int32_t height = -1;          // The height of the subtree, 0 for leaves, -1 if unused.
+
+    inline bool is_leaf() const
+    {
+      return left == null_node;
+    }
+  };
+
+ private:
+  /**
+   * @brief Returns the perimeter of a rectangle, used as the cost metric of the tree.
+   */
+  static inline T perimeter(const math::Rect<T>& rect)
+  {
+    const math::Vec2<T> size = rect.size();
+    return T(2) * (size.x + size.y);
+  }
+
+  /**
+   * @brief Allocates a node from the free list, or grows the pool.
+   *
+   * @return The index of the allocated node.
+   */
+  int32_t allocate_node()
+  {
+    if (m_free_list == null_node) {
+      m_nodes.emplace_back();
+      return static_cast<int32_t>(m_nodes.size() - 1);
+    }
+
+    const int32_t index = m_free_list;
+
+    m_free_list = m_nodes[index].parent;
+    m_nodes[index] = Node{};
+
+    return index;
+  }
+
+  /**
+   * @brief Returns a node to the free list.
+   *
+   * @param index The index of the node.
+   */
+  void free_node(const int32_t index)
+  {
+    m_nodes[index].parent = m_free_list;
+    m_nodes[index].height = -1;
+
+    m_free_list = index;
+  }
+
+  /**
+   * @brief Links a leaf into the tree, choosing the sibling that minimizes the perimeter growth.
+   *
+   * @param leaf The index of the leaf.
+   */
+  void insert_leaf(const int32_t leaf)
+  {
+    if (m_root == null_node) {
+      m_root = leaf;
+      m_nodes[leaf].parent = null_node;
+      return;
+    }
+
+    const math::Rect<T> leaf_bounds = m_nodes[leaf].bounds;
+
+    int32_t index = m_root;
+
+    while (!m_nodes[index].is_leaf()) {
+      const Node& node = m_nodes[index];
+
+      const T area = perimeter(node.bounds);
+      const T combined_area = perimeter(math::Rect<T>::from_rects(node.bounds, leaf_bounds));
+
+      /* Cost of creating a new parent for this node and the new leaf, and the minimum cost of
+       * pushing the leaf further down the tree. */
+
+      const T cost = T(2) * combined_area;
+      const T inheritance_cost = T(2) * (combined_area - area);
+
+      const auto descend_cost = [&](const int32_t child) {
+        const math::Rect<T> bounds = math::Rect<T>::from_rects(leaf_bounds, m_nodes[child].bounds);
+
+        if (m_nodes[child].is_leaf()) {
+          return perimeter(bounds) + inheritance_cost;
+        }
+
+        return perimeter(bounds) - perimeter(m_nodes[child].bounds) + inheritance_cost;
+      };
+
+      const T cost_left = descend_cost(node.left);
+      const T cost_right = descend_cost(node.right);
+
+      if (cost < cost_left && cost < cost_right) {
+        break;
+      }
+
+      index = cost_left < cost_right ? node.left : node.right;
+    }
+
+    const int32_t sibling = index;
+    const int32_t old_parent = m_nodes[sibling].parent;
+    const int32_t new_parent = allocate_node();
+
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].bounds = math::Rect<T>::from_rects(leaf_bounds, m_nodes[sibling].bounds);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].left = sibling;
+    m_nodes[new_parent].right = leaf;
+
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent = new_parent;
+
+    if (old_parent == null_node) {
+      m_root = new_parent;
+    } else if (m_nodes[old_parent].left == sibling) {
+      m_nodes[old_parent].left = new_parent;
+    } else {
+      m_nodes[old_parent].right = new_parent;
+    }
+
+    refit(m_nodes[leaf].parent);
+  }
+
+  /**
+   * @brief Unlinks a leaf from the tree, its sibling takes the place of their parent.
+   *
+   * @param leaf The index of the leaf.
+   */
+  void remove_leaf(const int32_t leaf)
+  {
+    if (leaf == m_root) {
+      m_root = null_node;
+      return;
+    }
+
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grand_parent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right :
+                                                           m_nodes[parent].left;
+
+    free_node(parent);
+
+    if (grand_parent == null_node) {
+      m_root = sibling;
+      m_nodes[sibling].parent = null_node;
+      return;
+    }
+
+    if (m_nodes[grand_parent].left == parent) {
+      m_nodes[grand_parent].left = sibling;
+    } else {
+      m_nodes[grand_parent].right = sibling;
+    }
+
+    m_nodes[sibling].parent = grand_parent;
+
+    refit(grand_parent);
+  }
+
+  /**
+   * @brief Walks up the tree from a node, rebalancing and recomputing bounds and heights.
+   *
+   * @param index The index of the first node to refit.
+   */
+  void refit(int32_t index)
+  {
+    while (index != null_node) {
+      index = balance(index);
+
+      Node& node = m_nodes[index];
+
+      node.height = 1 + std::max(m_nodes[node.left].height, m_nodes[node.right].height);
+      node.bounds = math::Rect<T>::from_rects(m_nodes[node.left].bounds,
+                                              m_nodes[node.right].bounds);
+
+      index = node.parent;
+    }
+  }
+
+  /**
+   * @brief Performs a left or right rotation if the subtree rooted at a node is imbalanced.
+   *
+   * @param a The index of the root of the subtree.
+   * @return The index of the new root of the subtree.
+   */
+  int32_t balance(const int32_t a)
+  {
+    if (m_nodes[a].is_leaf() || m_nodes[a].height < 2) {
+      return a;
+    }
+
+    const int32_t b = m_nodes[a].left;
+    const int32_t c = m_nodes[a].right;
+
+    const int32_t imbalance = m_nodes[c].height - m_nodes[b].height;
+
+    if (imbalance > 1) {
+      return rotate(a, c, b);
+    } else if (imbalance < -1) {
+      return rotate(a, b, c);
+    }
+
+    return a;
+  }
+
+  /**
+   * @brief Promotes the taller child of a node, the node becomes a child of its promoted child.
+   *
+   * @param a The index of the node to rotate.
+   * @param up The index of the child to promote.
+   * @param other The index of the other child of the node.
+   * @return The index of the promoted child, the new root of the subtree.
+   */
+  int32_t rotate(const int32_t a, const int32_t up, const int32_t other)
+  {
+    Node& node_a = m_nodes[a];
+    Node& node_up = m_nodes[up];
+
+    const int32_t f = node_up.left;
+    const int32_t g = node_up.right;
+
+    node_up.left = a;
+    node_up.parent = node_a.parent;
+    node_a.parent = up;
+
+    if (node_up.parent == null_node) {
+      m_root = up;
+    } else if (m_nodes[node_up.parent].left == a) {
+      m_nodes[node_up.parent].left = up;
+    } else {
+      m_nodes[node_up.parent].right = up;
+    }
+
+    /* The taller grandchild stays with the promoted node, the other one replaces it. */
+
+    const bool keep_f = m_nodes[f].height > m_nodes[g].height;
+    const int32_t kept = keep_f ? f : g;
+    const int32_t moved = keep_f ? g : f;
+
+    node_up.right = kept;
+
+    if (node_a.left == up) {
+      node_a.left = moved;
+    } else {
+      node_a.right = moved;
+    }
+
+    m_nodes[moved].parent = a;
+
+    node_a.bounds = math::Rect<T>::from_rects(m_nodes[other].bounds, m_nodes[moved].bounds);
+    node_a.height = 1 + std::max(m_nodes[other].height, m_nodes[moved].height);
+
+    node_up.bounds = math::Rect<T>::from_rects(node_a.bounds, m_nodes[kept].bounds);
+    node_up.height = 1 + std::max(node_a.height, m_nodes[kept].height);
+
+    return up;
+  }
+
+ private:
+  std::vector<Node> m_nodes;        // The pool of nodes, unused nodes form a free list.
+
+  int32_t m_root = null_node;       // The root of the tree.
+  int32_t m_free_list = null_node;  // The first unused node of the pool.
+
+  size_t m_leaves_count = 0;        // The number of leaves in the tree.
+};
+
+}  // namespace graphick::geom
@@ -312,366 +312,454 @@ inline void clip(std::vector<math::Vec2<T>>& points, const math::Rect<T>& rect)
 }
 
 /**
- * @brief Clips a cubic path to the right of a given x value.
- *
- * Modifies the input path.
+ * @brief The edges of a clipping rectangle.
+ */
+enum class ClipEdge { Left, Right, Top, Bottom };
+
+/**
+ * @brief A streaming pipeline stage that clips monotonic cubic curves to an edge of a rectangle.
  *
- * @param path The cubic path to clip.
- * @param x The x value to clip to.
+ * The clipped curves are output to the next stage as a single closed contour, the parts outside of
+ * the edge are replaced by lines along it. Since the curves are monotonic, only their end points
+ * are checked against the edge.
  */
-template<typename T>
-inline CubicMultipath<T> clip_to_left(const CubicMultipath<T>& path, const T x)
-{
-  if (path.empty()) {
-    return path;
+template<typename T, ClipEdge E, typename S>
+class ClipStage {
+ public:
+  /**
+   * @brief Constructs a new clipping stage.
+   *
+   * @param value The coordinate of the edge, x for the left and right edges, y otherwise.
+   * @param sink The stage to output the clipped curves to.
+   */
+  ClipStage(const T value, S& sink) : m_value(value), m_sink(sink) {}
+
+  /**
+   * @brief Deleted copy constructor, the stages hold a reference to the next one.
+   */
+  ClipStage(const ClipStage&) = delete;
+
+  /**
+   * @brief Moves the cursor to the given point, contours are joined along the edge.
+   *
+   * @param p The point to move the cursor to.
+   */
+  inline void move_to(const math::Vec2<T> p)
+  {
+    m_p0 = p;
   }
 
-  CubicPath<T> new_path;
-  new_path.points.reserve(path.points.size());
-
-  for (size_t j = 0; j < path.starts.size(); j++) {
-    const size_t end = path.starts.size() > (j + 1) ? path.starts[j + 1] : path.points.size();
-
-    for (size_t i = path.starts[j]; i < end - 3; i += 3) {
-      /* Curves are monotonic, only p0 and p3 matter. */
-
-      const math::Vec2<T> p0 = path[i];
-      const math::Vec2<T> p1 = path[i + 1];
-      const math::Vec2<T> p2 = path[i + 2];
-      const math::Vec2<T> p3 = path[i + 3];
+  /**
+   * @brief Clips a line starting at the cursor.
+   *
+   * @param p The end point of the line.
+   */
+  inline void line_to(const math::Vec2<T> p)
+  {
+    if (p != m_p0) {
+      cubic_to_monotonic(p, p, p);
+    }
+  }
 
-      const CubicBezier<T> curve = CubicBezier<T>(p0, p1, p2, p3);
+  /**
+   * @brief Clips a monotonic cubic curve starting at the cursor.
+   *
+   * @param p1 The first control point of the curve.
+   * @param p2 The second control point of the curve.
+   * @param p3 The end point of the curve.
+   */
+  void cubic_to_monotonic(const math::Vec2<T> p1, const math::Vec2<T> p2, const math::Vec2<T> p3)
+  {
+    const math::Vec2<T> p0 = m_p0;
+    const CubicBezier<T> curve = CubicBezier<T>(p0, p1, p2, p3);
+
+    m_p0 = p3;
+
+    if (outside(p0[axis])) {
+      if (!inside(p3[axis])) {
+        return;
+      }
 
-      const bool linear = curve.is_line(math::geometric_epsilon<T>);
+      if (curve.is_line(math::geometric_epsilon<T>)) {
+        output_line(intersection(p0, p3));
+        output_line(p3);
+      } else {
+        const CubicBezier<T> new_curve = extract(curve, intersection_t(curve), T(1));
 
-      if (p0.x < x) {
-        if (p3.x > x) {
-          const double t0 = math::clamp((x - p0.x) / (p3.x - p0.x), 0.0, 1.0);
+        output_line(on_edge(new_curve.p0));
+        output_cubic(new_curve.p1, new_curve.p2, new_curve.p3);
+      }
 
-          if (linear) {
-            new_path.line_to({x, math::lerp(p0.y, p3.y, t0)});
-            new_path.line_to(p3);
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.x, b.x, c.x, d.x, x, t0);
+      return;
+    }
 
-            const CubicBezier<T> new_curve = extract(curve, t, 1.0);
+    output_line(p0);
 
-            new_path.line_to({x, new_curve.p0.y});
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        }
+    if (outside(p3[axis])) {
+      if (curve.is_line(math::geometric_epsilon<T>)) {
+        output_line(intersection(p0, p3));
       } else {
-        if (new_path.empty() || new_path.back() != p0) {
-          new_path.line_to(p0);
-        }
-
-        if (p3.x < x) {
-          const double t0 = math::clamp((x - p0.x) / (p3.x - p0.x), 0.0, 1.0);
-
-          if (linear) {
-            new_path.line_to({x, math::lerp(p0.y, p3.y, t0)});
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.x, b.x, c.x, d.x, x, t0);
-
-            const CubicBezier<T> new_curve = extract(curve, 0.0, t);
-
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        } else {
-          new_path.cubic_to_monotonic(p1, p2, p3);
-        }
+        const CubicBezier<T> new_curve = extract(curve, T(0), intersection_t(curve));
+
+        output_cubic(new_curve.p1, new_curve.p2, new_curve.p3);
       }
+    } else {
+      output_cubic(p1, p2, p3);
     }
   }
 
-  if (!new_path.empty() && new_path.front() != new_path.back()) {
-    new_path.line_to(new_path.front());
+  /**
+   * @brief Returns the end point of the last input curve.
+   *
+   * @return The cursor of the stage.
+   */
+  inline math::Vec2<T> cursor() const
+  {
+    return m_p0;
   }
 
-  return new_path;
-}
+  /**
+   * @brief Checks whether the last output point is the cursor.
+   *
+   * In this case a curve that doesn't cross the edge is output as is, see pass().
+   *
+   * @return true if the output is at the cursor, false otherwise.
+   */
+  inline bool synced() const
+  {
+    return m_started && m_last == m_p0;
+  }
 
-/**
- * @brief Clips a cubic path to the left of a given x value.
- *
- * Modifies the input path.
- *
- * @param path The cubic path to clip.
- * @param x The x value to clip to.
- */
-template<typename T>
-inline CubicMultipath<T> clip_to_right(const CubicMultipath<T>& path, const T x)
-{
-  if (path.empty()) {
-    return path;
+  /**
+   * @brief Moves the stage past a curve that doesn't cross the edge, the stage must be synced.
+   *
+   * The curve is not output, the caller is responsible for passing it to the next stage.
+   *
+   * @param p3 The end point of the curve.
+   */
+  inline void pass(const math::Vec2<T> p3)
+  {
+    m_p0 = p3;
+    m_last = p3;
+  }
+
+  /**
+   * @brief Closes the clipped contour and the next stage.
+   */
+  inline void close()
+  {
+    if (m_started && m_first != m_last) {
+      m_sink.line_to(m_first);
+    }
+
+    m_sink.close();
+  }
+ private:
+  static constexpr uint8_t axis = E == ClipEdge::Left || E == ClipEdge::Right ? 0 : 1;
+  static constexpr uint8_t cross_axis = 1 - axis;
+ private:
+  /**
+   * @brief Checks whether a coordinate is outside of the edge.
+   */
+  inline bool outside(const T v) const
+  {
+    return E == ClipEdge::Left || E == ClipEdge::Top ? v < m_value : v > m_value;
   }
 
-  CubicPath<T> new_path;
-  new_path.points.reserve(path.points.size());
+  /**
+   * @brief Checks whether a coordinate is strictly inside of the edge.
+   */
+  inline bool inside(const T v) const
+  {
+    return E == ClipEdge::Left || E == ClipEdge::Top ? v > m_value : v < m_value;
+  }
 
-  for (size_t j = 0; j < path.starts.size(); j++) {
-    const size_t end = path.starts.size() > (j + 1) ? path.starts[j + 1] : path.points.size();
+  /**
+   * @brief Projects a point on the edge.
+   */
+  inline math::Vec2<T> on_edge(const math::Vec2<T> p) const
+  {
+    math::Vec2<T> r;
 
-    for (size_t i = path.starts[j]; i < end - 3; i += 3) {
-      /* Curves are monotonic, only p0 and p3 matter. */
+    r[axis] = m_value;
+    r[cross_axis] = p[cross_axis];
 
-      const math::Vec2<T> p0 = path[i];
-      const math::Vec2<T> p1 = path[i + 1];
-      const math::Vec2<T> p2 = path[i + 2];
-      const math::Vec2<T> p3 = path[i + 3];
+    return r;
+  }
 
-      const CubicBezier<T> curve = CubicBezier<T>(p0, p1, p2, p3);
+  /**
+   * @brief Returns the linear approximation of the intersection with the edge, in t.
+   */
+  inline T linear_t(const math::Vec2<T> p0, const math::Vec2<T> p3) const
+  {
+    return math::clamp((m_value - p0[axis]) / (p3[axis] - p0[axis]), T(0), T(1));
+  }
 
-      const bool linear = curve.is_line(math::geometric_epsilon<T>);
+  /**
+   * @brief Returns the intersection of a line with the edge.
+   */
+  inline math::Vec2<T> intersection(const math::Vec2<T> p0, const math::Vec2<T> p3) const
+  {
+    math::Vec2<T> r;
 
-      if (p0.x > x) {
-        if (p3.x < x) {
-          const double t0 = math::clamp((x - p0.x) / (p3.x - p0.x), 0.0, 1.0);
+    r[axis] = m_value;
+    r[cross_axis] = math::lerp(p0[cross_axis], p3[cross_axis], linear_t(p0, p3));
 
-          if (linear) {
-            new_path.line_to({x, math::lerp(p0.y, p3.y, t0)});
-            new_path.line_to(p3);
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.x, b.x, c.x, d.x, x, t0);
+    return r;
+  }
 
-            const CubicBezier<T> new_curve = extract(curve, t, 1.0);
+  /**
+   * @brief Returns the t value of the intersection of a monotonic curve with the edge.
+   */
+  inline T intersection_t(const CubicBezier<T>& curve) const
+  {
+    const T t0 = linear_t(curve.p0, curve.p3);
 
-            new_path.line_to({x, new_curve.p0.y});
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        }
-      } else {
-        if (new_path.empty() || new_path.back() != p0) {
-          new_path.line_to(p0);
-        }
-
-        if (p3.x > x) {
-          const double t0 = math::clamp((x - p0.x) / (p3.x - p0.x), 0.0, 1.0);
-
-          if (linear) {
-            new_path.line_to({x, math::lerp(p0.y, p3.y, t0)});
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.x, b.x, c.x, d.x, x, t0);
-
-            const CubicBezier<T> new_curve = extract(curve, 0.0, t);
-
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        } else {
-          new_path.cubic_to_monotonic(p1, p2, p3);
-        }
-      }
+    if (math::is_almost_zero_or_one(t0)) {
+      return t0;
     }
+
+    const auto& [a, b, c, d] = curve.coefficients();
+
+    return geom::cubic_line_intersect_approx(a[axis], b[axis], c[axis], d[axis], m_value, t0);
   }
 
-  if (!new_path.empty() && new_path.front() != new_path.back()) {
-    new_path.line_to(new_path.front());
+  /**
+   * @brief Outputs a line to the next stage, the first point starts the contour.
+   */
+  inline void output_line(const math::Vec2<T> p)
+  {
+    if (!m_started) {
+      m_started = true;
+      m_first = p;
+      m_last = p;
+
+      m_sink.move_to(p);
+    } else if (p != m_last) {
+      m_last = p;
+
+      m_sink.line_to(p);
+    }
   }
 
-  return new_path;
-}
+  /**
+   * @brief Outputs a monotonic cubic curve to the next stage.
+   */
+  inline void output_cubic(const math::Vec2<T> p1, const math::Vec2<T> p2, const math::Vec2<T> p3)
+  {
+    m_last = p3;
+
+    m_sink.cubic_to_monotonic(p1, p2, p3);
+  }
+ private:
+  const T m_value;          // The coordinate of the edge.
+  S& m_sink;                // The next stage.
+
+  math::Vec2<T> m_p0;       // The end point of the last input curve.
+  math::Vec2<T> m_first;    // The first output point.
+  math::Vec2<T> m_last;     // The last output point.
+  bool m_started = false;   // Whether a point was output.
+};
 
 /**
- * @brief Clips a cubic path to the bottom of a given y value.
+ * @brief A streaming pipeline stage that clips monotonic cubic curves to a rectangle.
  *
- * Modifies the input path.
- *
- * @param path The cubic path to clip.
- * @param y The y value to clip to.
+ * The curves are clipped to the left, right, top and bottom edges in turn, in a single pass and
+ * without intermediate buffers. Each curve is first classified against the four edges at once:
+ * curves inside of the rectangle are output as is and curves outside of an edge are dropped, only
+ * the curves crossing an edge are clipped by the edge stages.
  */
-template<typename T>
-inline CubicMultipath<T> clip_to_top(const CubicMultipath<T>& path, const T y)
-{
-  if (path.empty()) {
-    return path;
+template<typename T, typename S>
+class RectClipStage {
+ public:
+  /**
+   * @brief Constructs a new rectangle clipping stage.
+   *
+   * @param rect The rectangle to clip to.
+   * @param sink The stage to output the clipped curves to.
+   */
+  RectClipStage(const math::Rect<T>& rect, S& sink)
+      : m_rect(rect),
+        m_sink(sink),
+        m_bottom(rect.max.y, sink),
+        m_top(rect.min.y, m_bottom),
+        m_right(rect.max.x, m_top),
+        m_left(rect.min.x, m_right)
+  {
   }
 
-  CubicPath<T> new_path;
-  new_path.points.reserve(path.points.size());
-
-  for (size_t j = 0; j < path.starts.size(); j++) {
-    const size_t end = path.starts.size() > (j + 1) ? path.starts[j + 1] : path.points.size();
-
-    for (size_t i = path.starts[j]; i < end - 3; i += 3) {
-      /* Curves are monotonic, only p0 and p3 matter. */
-
-      const math::Vec2<T> p0 = path[i];
-      const math::Vec2<T> p1 = path[i + 1];
-      const math::Vec2<T> p2 = path[i + 2];
-      const math::Vec2<T> p3 = path[i + 3];
+  /**
+   * @brief Deleted copy constructor, the stages hold a reference to the next one.
+   */
+  RectClipStage(const RectClipStage&) = delete;
+
+  /**
+   * @brief Moves the cursor to the given point, see ClipStage::move_to().
+   */
+  inline void move_to(const math::Vec2<T> p)
+  {
+    m_left.move_to(p);
+    m_outside = outside(p);
+  }
 
-      const CubicBezier<T> curve = CubicBezier<T>(p0, p1, p2, p3);
+  /**
+   * @brief Clips a line starting at the cursor.
+   */
+  inline void line_to(const math::Vec2<T> p)
+  {
+    if (p != m_left.cursor()) {
+      cubic_to_monotonic(p, p, p);
+    }
+  }
 
-      const bool linear = curve.is_line(math::geometric_epsilon<T>);
+  /**
+   * @brief Clips a monotonic cubic curve starting at the cursor.
+   */
+  inline void cubic_to_monotonic(const math::Vec2<T> p1,
+                                 const math::Vec2<T> p2,
+                                 const math::Vec2<T> p3)
+  {
+    /* A stage drops the curve if p0 is outside of its edge and p3 is not strictly inside, and
+     * outputs it as is if both are inside and the stage is synced. Since a curve passed through
+     * starts at the cursor of the next stage, the classification of p0 and p3 holds for it too. */
+
+    const uint8_t outside0 = m_outside;
+    const uint8_t outside3 = outside(p3);
+
+    const uint8_t rejected = outside0 ? outside0 & (outside3 | on_edges(p3)) : 0;
+    const uint8_t inside = ~(outside0 | outside3);
+
+    m_outside = outside3;
+
+    if (feed(m_left, edge_bit(ClipEdge::Left), rejected, inside, p1, p2, p3) &&
+        feed(m_right, edge_bit(ClipEdge::Right), rejected, inside, p1, p2, p3) &&
+        feed(m_top, edge_bit(ClipEdge::Top), rejected, inside, p1, p2, p3) &&
+        feed(m_bottom, edge_bit(ClipEdge::Bottom), rejected, inside, p1, p2, p3))
+    {
+      m_sink.cubic_to_monotonic(p1, p2, p3);
+    }
+  }
 
-      if (p0.y < y) {
-        if (p3.y > y) {
-          const double t0 = math::clamp((y - p0.y) / (p3.y - p0.y), 0.0, 1.0);
+  /**
+   * @brief Closes the clipped contour and the sink.
+   */
+  inline void close()
+  {
+    m_left.close();
+  }
+ private:
+  using BottomStage = ClipStage<T, ClipEdge::Bottom, S>;
+  using TopStage = ClipStage<T, ClipEdge::Top, BottomStage>;
+  using RightStage = ClipStage<T, ClipEdge::Right, TopStage>;
+  using LeftStage = ClipStage<T, ClipEdge::Left, RightStage>;
+ private:
+  /**
+   * @brief Returns the bit of an edge in the classification masks.
+   */
+  static constexpr uint8_t edge_bit(const ClipEdge edge)
+  {
+    return 1 << static_cast<uint8_t>(edge);
+  }
 
-          if (linear) {
-            new_path.line_to({math::lerp(p0.x, p3.x, t0), y});
-            new_path.line_to(p3);
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.y, b.y, c.y, d.y, y, t0);
+  /**
+   * @brief Returns the mask of the edges a point is strictly outside of.
+   */
+  inline uint8_t outside(const math::Vec2<T> p) const
+  {
+    return (p.x < m_rect.min.x ? edge_bit(ClipEdge::Left) : 0) |
+           (p.x > m_rect.max.x ? edge_bit(ClipEdge::Right) : 0) |
+           (p.y < m_rect.min.y ? edge_bit(ClipEdge::Top) : 0) |
+           (p.y > m_rect.max.y ? edge_bit(ClipEdge::Bottom) : 0);
+  }
 
-            const CubicBezier<T> new_curve = extract(curve, t, 1.0);
+  /**
+   * @brief Returns the mask of the edges a point lies on.
+   */
+  inline uint8_t on_edges(const math::Vec2<T> p) const
+  {
+    return (p.x == m_rect.min.x ? edge_bit(ClipEdge::Left) : 0) |
+           (p.x == m_rect.max.x ? edge_bit(ClipEdge::Right) : 0) |
+           (p.y == m_rect.min.y ? edge_bit(ClipEdge::Top) : 0) |
+           (p.y == m_rect.max.y ? edge_bit(ClipEdge::Bottom) : 0);
+  }
 
-            new_path.line_to({new_curve.p0.x, y});
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        }
-      } else {
-        if (new_path.empty() || new_path.back() != p0) {
-          new_path.line_to(p0);
-        }
-
-        if (p3.y < y) {
-          const double t0 = math::clamp((y - p0.y) / (p3.y - p0.y), 0.0, 1.0);
-
-          if (linear) {
-            new_path.line_to({math::lerp(p0.x, p3.x, t0), y});
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.y, b.y, c.y, d.y, y, t0);
-
-            const CubicBezier<T> new_curve = extract(curve, 0.0, t);
-
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        } else {
-          new_path.cubic_to_monotonic(p1, p2, p3);
-        }
-      }
+  /**
+   * @brief Feeds a curve to an edge stage, unless it can be dropped or passed through.
+   *
+   * @return true if the curve was passed through and must be fed to the next stage.
+   */
+  template<typename Stage>
+  static inline bool feed(Stage& stage,
+                          const uint8_t edge,
+                          const uint8_t rejected,
+                          const uint8_t inside,
+                          const math::Vec2<T> p1,
+                          const math::Vec2<T> p2,
+                          const math::Vec2<T> p3)
+  {
+    if (rejected & edge) {
+      stage.move_to(p3);
+    } else if ((inside & edge) && stage.synced()) {
+      stage.pass(p3);
+      return true;
+    } else {
+      stage.cubic_to_monotonic(p1, p2, p3);
     }
-  }
 
-  if (!new_path.empty() && new_path.front() != new_path.back()) {
-    new_path.line_to(new_path.front());
+    return false;
   }
+ private:
+  const math::Rect<T> m_rect;  // The rectangle to clip to.
+  S& m_sink;                   // The output stage.
+  uint8_t m_outside = 0;       // The edges the cursor is strictly outside of.
 
-  return new_path;
-}
+  BottomStage m_bottom;  // The last stage, it outputs to the sink.
+  TopStage m_top;        // The third stage.
+  RightStage m_right;    // The second stage.
+  LeftStage m_left;      // The first stage.
+};
 
 /**
- * @brief Clips a cubic path to the top of a given y value.
+ * @brief Clips a cubic path to a given rect, into a reusable path.
  *
- * Modifies the input path.
+ * The clipped path is a single closed contour, empty if the path is outside of the rect.
+ * Once the capacity of the output path is large enough, no memory is allocated.
  *
  * @param path The cubic path to clip.
- * @param y The y value to clip to.
+ * @param rect The rect to clip to.
+ * @param r_path The output path, its previous content is discarded.
  */
 template<typename T>
-inline CubicMultipath<T> clip_to_bottom(const CubicMultipath<T>& path, const T y)
+inline void clip(const CubicMultipath<T>& path,
+                 const math::Rect<T>& rect,
+                 CubicMultipath<T>& r_path)
 {
-  if (path.empty()) {
-    return path;
-  }
-
-  CubicPath<T> new_path;
-  new_path.points.reserve(path.points.size());
-
-  for (size_t j = 0; j < path.starts.size(); j++) {
-    const size_t end = path.starts.size() > (j + 1) ? path.starts[j + 1] : path.points.size();
-
-    for (size_t i = path.starts[j]; i < end - 3; i += 3) {
-      /* Curves are monotonic, only p0 and p3 matter. */
-
-      const math::Vec2<T> p0 = path[i];
-      const math::Vec2<T> p1 = path[i + 1];
-      const math::Vec2<T> p2 = path[i + 2];
-      const math::Vec2<T> p3 = path[i + 3];
-
-      const CubicBezier<T> curve = CubicBezier<T>(p0, p1, p2, p3);
+  r_path.clear();
 
-      const bool linear = curve.is_line(math::geometric_epsilon<T>);
-
-      if (p0.y > y) {
-        if (p3.y < y) {
-          const double t0 = math::clamp((y - p0.y) / (p3.y - p0.y), 0.0, 1.0);
-
-          if (linear) {
-            new_path.line_to({math::lerp(p0.x, p3.x, t0), y});
-            new_path.line_to(p3);
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.y, b.y, c.y, d.y, y, t0);
-
-            const CubicBezier<T> new_curve = extract(curve, t, 1.0);
-
-            new_path.line_to({new_curve.p0.x, y});
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        }
-      } else {
-        if (new_path.empty() || new_path.back() != p0) {
-          new_path.line_to(p0);
-        }
-
-        if (p3.y > y) {
-          const double t0 = math::clamp((y - p0.y) / (p3.y - p0.y), 0.0, 1.0);
-
-          if (linear) {
-            new_path.line_to({math::lerp(p0.x, p3.x, t0), y});
-          } else {
-            const auto& [a, b, c, d] = curve.coefficients();
-            const double t = math::is_almost_zero_or_one(t0) ?
-                                 t0 :
-                                 geom::cubic_line_intersect_approx(a.y, b.y, c.y, d.y, y, t0);
-
-            const CubicBezier<T> new_curve = extract(curve, 0.0, t);
-
-            new_path.cubic_to_monotonic(new_curve.p1, new_curve.p2, new_curve.p3);
-          }
-        } else {
-          new_path.cubic_to_monotonic(p1, p2, p3);
-        }
-      }
-    }
+  if (path.empty()) {
+    r_path.points.insert(r_path.points.end(), path.points.begin(), path.points.end());
+    r_path.starts.insert(r_path.starts.end(), path.starts.begin(), path.starts.end());
+    return;
   }
 
-  if (!new_path.empty() && new_path.front() != new_path.back()) {
-    new_path.line_to(new_path.front());
-  }
+  RectClipStage<T, CubicMultipath<T>> clipper(rect, r_path);
 
-  return new_path;
+  path.stream(clipper);
 }
 
 /**
  * @brief Clips a cubic path to a given rect.
  *
- * Modifies the input path.
- *
  * @param path The cubic path to clip.
  * @param rect The rect to clip to.
+ * @return The clipped path.
  */
 template<typename T>
 inline CubicMultipath<T> clip(const CubicMultipath<T>& path, const math::Rect<T>& rect)
 {
   CubicMultipath<T> new_path;
 
-  new_path = clip_to_left(path, rect.min.x);
-  new_path = clip_to_right(new_path, rect.max.x);
-  new_path = clip_to_top(new_path, rect.min.y);
-  new_path = clip_to_bottom(new_path, rect.max.y);
+  clip(path, rect, new_path);
 
   return new_path;
 }
@@ -21,6 +21,10 @@ namespace graphick::geom {
  *
  * All curves are splitted in monotone segments for efficient winding number computation (and
  * rendering).
+ *
+ * A cubic path is also the last stage of the streaming pipelines (see Path::stream() and
+ * geom::ClipStage), a stage is any type with the move_to(), line_to(), cubic_to_monotonic() and
+ * close() methods.
  */
 template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
 struct CubicPath {
@@ -239,6 +243,24 @@ struct CubicPath {
     points.insert(points.end(), {p1, p2, p3});
   }
 
+  /**
+   * @brief Closes the path with a line to its first control point, if not already closed.
+   */
+  inline void close()
+  {
+    if (!empty() && !closed()) {
+      line_to(front());
+    }
+  }
+
+  /**
+   * @brief Removes all the control points, keeping the allocated memory.
+   */
+  inline virtual void clear()
+  {
+    points.clear();
+  }
+
   /**
    * @brief Adds an arc to the path.
    *
@@ -317,6 +339,37 @@ struct CubicMultipath : public CubicPath<T> {
     this->points.insert(this->points.end(), path.points.begin(), path.points.end());
   }
 
+  /**
+   * @brief Removes all the control points and subpaths, keeping the allocated memory.
+   */
+  inline void clear() override
+  {
+    this->points.clear();
+    starts.clear();
+  }
+
+  /**
+   * @brief Streams the curves of the multipath to a pipeline stage, then closes it.
+   *
+   * @param sink The stage to output the curves to.
+   */
+  template<typename S>
+  inline void stream(S& sink) const
+  {
+    for (size_t j = 0; j < starts.size(); j++) {
+      const size_t start = starts[j];
+      const size_t end = starts.size() > (j + 1) ? starts[j + 1] : this->points.size();
+
+      sink.move_to(this->points[start]);
+
+      for (size_t i = start; i + 3 < end; i += 3) {
+        sink.cubic_to_monotonic(this->points[i + 1], this->points[i + 2], this->points[i + 3]);
+      }
+    }
+
+    sink.close();
+  }
+
   /**
    * @brief Returns the winding number of a point with respect to the path.
    *
@@ -941,43 +941,9 @@ void CubicPath<T, _>::cubic_to(const math::Vec2<T> p1,
 {
   GK_ASSERT(!points.empty(), "Cannot add a curve to an empty path.");
 
-  const CubicBezier<T> cubic = {back(), p1, p2, p3};
-  const auto& [a, b, c] = cubic.derivative_coefficients();
-  const auto inflection_points = inflections(cubic);
-
-  std::array<T, 8> split_points = {T(0), T(1), T(2), T(2), T(2), T(2), T(2), T(2)};
-  uint8_t split_count = 2;
-
-  for (uint8_t j = 0; j < inflection_points.count; j++) {
-    const T t = inflection_points.solutions[j];
-
-    if (t != T(0) && t != T(1)) {
-      split_points[split_count++] = t;
-    }
-  }
-
-  for (uint8_t i = 0; i < 2; i++) {
-    const math::QuadraticSolutions<T> solutions = math::solve_quadratic(a[i], b[i], c[i]);
-
-    for (uint8_t j = 0; j < solutions.count; j++) {
-      const T t = solutions.solutions[j];
-
-      if (math::is_almost_normalized(t)) {
-        split_points[split_count++] = t;
-      }
-    }
-  }
-
-  std::sort(split_points.begin(), split_points.begin() + split_count);
-
-  for (size_t i = 0; i < split_count - 1; i++) {
-    const T t0 = split_points[i];
-    const T t1 = split_points[i + 1];
-
-    const CubicBezier<T> sub = extract(cubic, t0, t1);
-
+  split_monotonic(CubicBezier<T>{back(), p1, p2, p3}, [&](const CubicBezier<T>& sub) {
     points.insert(points.end(), {sub.p1, sub.p2, sub.p3});
-  }
+  });
 }
 
 template<typename T, typename _>
@@ -1109,8 +1075,8 @@ static inline int winding_of(const dquadratic_bezier& quad, const dvec2 p)
   return 0;
 }
 
-template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
-static inline int winding_of(const CubicBezier<T>& c, const math::Vec2<T> p)
+template<typename T, typename _>
+int winding_of(const CubicBezier<T>& c, const math::Vec2<T> p)
 {
   if (std::max({c.p0.x, c.p1.x, c.p2.x, c.p3.x}) < p.x) {
     // The curve is entirely on the left of the point.
@@ -1300,6 +1266,9 @@ cubic_to_quadratics_with_intervals(const CubicBezier<float>&);
 template std::vector<std::pair<QuadraticBezier<double>, math::Vec2<double>>>
 cubic_to_quadratics_with_intervals(const CubicBezier<double>&);
 
+template int winding_of(const CubicBezier<float>&, const math::Vec2<float>);
+template int winding_of(const CubicBezier<double>&, const math::Vec2<double>);
+
 template struct QuadraticPath<float>;
 template struct QuadraticPath<double>;
 template struct QuadraticMultipath<float>;
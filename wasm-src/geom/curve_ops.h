@@ -13,6 +13,8 @@
 
 #include "../math/math.h"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace graphick::geom {
@@ -193,6 +195,50 @@ CubicBezier<T> extract(const CubicBezier<T>& cubic, const T t1, const T t2);
 
 /* -- Conversion -- */
 
+/**
+ * @brief Splits a cubic bezier curve into monotonic segments, without allocating.
+ *
+ * The curve is split at its inflection points and at its extrema in x and y.
+ *
+ * @param cubic The cubic bezier curve.
+ * @param sink_callback The callback to output each monotonic segment to.
+ */
+template<typename T, typename F, typename = std::enable_if<std::is_floating_point_v<T>>>
+inline void split_monotonic(const CubicBezier<T>& cubic, F&& sink_callback)
+{
+  const auto& [a, b, c] = cubic.derivative_coefficients();
+  const auto inflection_points = inflections(cubic);
+
+  std::array<T, 8> split_points = {T(0), T(1), T(2), T(2), T(2), T(2), T(2), T(2)};
+  uint8_t split_count = 2;
+
+  for (uint8_t j = 0; j < inflection_points.count; j++) {
+    const T t = inflection_points.solutions[j];
+
+    if (t != T(0) && t != T(1)) {
+      split_points[split_count++] = t;
+    }
+  }
+
+  for (uint8_t i = 0; i < 2; i++) {
+    const math::QuadraticSolutions<T> solutions = math::solve_quadratic(a[i], b[i], c[i]);
+
+    for (uint8_t j = 0; j < solutions.count; j++) {
+      const T t = solutions.solutions[j];
+
+      if (math::is_almost_normalized(t)) {
+        split_points[split_count++] = t;
+      }
+    }
+  }
+
+  std::sort(split_points.begin(), split_points.begin() + split_count);
+
+  for (size_t i = 0; i < split_count - 1; i++) {
+    sink_callback(extract(cubic, split_points[i], split_points[i + 1]));
+  }
+}
+
 /**
  * @brief Converts a cubic bezier curve into a sequence of quadratic bezier curves.
  *
@@ -207,4 +253,18 @@ template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
 std::vector<std::pair<QuadraticBezier<T>, math::Vec2<T>>> cubic_to_quadratics_with_intervals(
     const CubicBezier<T>& cubic);
 
+/* -- Winding Number -- */
+
+/**
+ * @brief Calculates the contribution of a cubic bezier curve to the winding number of a point.
+ *
+ * The curve is expected to be monotonic in y, a ray is cast from the point towards positive x.
+ *
+ * @param cubic The monotonic cubic bezier curve.
+ * @param p The point to check.
+ * @return The winding contribution of the curve, either -1, 0 or 1.
+ */
+template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
+int winding_of(const CubicBezier<T>& cubic, const math::Vec2<T> p);
+
 }  // namespace graphick::geom
@@ -24,6 +24,27 @@
 
 namespace graphick::geom {
 
+/**
+ * @brief Returns the number of points a command adds to the path.
+ *
+ * @param command The command.
+ * @return The number of points of the command, the start point excluded.
+ */
+template<typename C>
+static inline uint32_t command_points(const C command)
+{
+  switch (command) {
+    case C::Quadratic:
+      return 2;
+    case C::Cubic:
+      return 3;
+    case C::Move:
+    case C::Line:
+    default:
+      return 1;
+  }
+}
+
 /* -- Segment -- */
 
 template<typename T, typename _>
@@ -52,43 +73,9 @@ Path<T, _>::Iterator::Iterator(const Path<T>& path,
   if (index_type == IndexType::Point) {
     GK_ASSERT(index < path.m_points.size(), "Point index out of range.");
 
-    m_index = 0;
-
-    while (m_point_index <= index) {
-      switch (path.get_command(m_index)) {
-        case Command::Move:
-          if (index == m_point_index) {
-            operator++();
-            return;
-          }
-
-          m_point_index += 1;
-          break;
-        case Command::Line:
-          if (index == m_point_index) {
-            return;
-          }
-
-          m_point_index += 1;
-          break;
-        case Command::Quadratic:
-          if (index - m_point_index <= 1) {
-            return;
-          }
-
-          m_point_index += 2;
-          break;
-        case Command::Cubic:
-          if (index - m_point_index <= 2) {
-            return;
-          }
-
-          m_point_index += 3;
-          break;
-      }
-
-      m_index += 1;
-    }
+    /* The point of the initial move is the start of the first segment. */
+    m_index = std::max(path.point_command(index), uint32_t(1));
+    m_point_index = path.point_offset(m_index);
 
     return;
   } else if (index_type == IndexType::Segment) {
@@ -103,39 +90,7 @@ Path<T, _>::Iterator::Iterator(const Path<T>& path,
 
   GK_ASSERT(m_index > 0 && m_index <= path.m_commands_size, "Index out of range.");
 
-  if (m_index <= path.m_commands_size / 2) {
-    for (uint32_t i = 0; i < m_index; i++) {
-      switch (path.get_command(i)) {
-        case Command::Move:
-        case Command::Line:
-          m_point_index += 1;
-          break;
-        case Command::Quadratic:
-          m_point_index += 2;
-          break;
-        case Command::Cubic:
-          m_point_index += 3;
-          break;
-      }
-    }
-  } else {
-    m_point_index = static_cast<uint32_t>(path.m_points.size());
-
-    for (uint32_t i = path.m_commands_size - 1; i >= m_index; i--) {
-      switch (path.get_command(i)) {
-        case Command::Move:
-        case Command::Line:
-          m_point_index -= 1;
-          break;
-        case Command::Quadratic:
-          m_point_index -= 2;
-          break;
-        case Command::Cubic:
-          m_point_index -= 3;
-          break;
-      }
-    }
-  }
+  m_point_index = path.point_offset(m_index);
 }
 
 template<typename T, typename _>
@@ -176,13 +131,10 @@ typename Path<T, _>::Iterator Path<T, _>::Iterator::operator++(int)
 template<typename T, typename _>
 typename Path<T, _>::Iterator Path<T, _>::Iterator::operator+(const uint32_t n) const
 {
-  Iterator tmp = *this;
-
-  for (uint32_t i = 0; i < n; i++) {
-    ++tmp;
-  }
+  GK_ASSERT(m_index + n <= m_path.m_commands_size, "Cannot increment past the end iterator.");
 
-  return tmp;
+  /* Paths have a single move, at the start, so segments map directly to commands. */
+  return Iterator(m_path, m_index + n);
 }
 
 template<typename T, typename _>
@@ -221,13 +173,9 @@ typename Path<T, _>::Iterator Path<T, _>::Iterator::operator--(int)
 template<typename T, typename _>
 typename Path<T, _>::Iterator Path<T, _>::Iterator::operator-(const uint32_t n) const
 {
-  Iterator tmp = *this;
-
-  for (uint32_t i = 0; i < n; i++) {
-    --tmp;
-  }
+  GK_ASSERT(n < m_index, "Cannot decrement past the begin iterator.");
 
-  return tmp;
+  return Iterator(m_path, m_index - n);
 }
 
 template<typename T, typename _>
@@ -274,39 +222,7 @@ Path<T, _>::ReverseIterator::ReverseIterator(const Path<T>& path, const uint32_t
 
   GK_ASSERT(m_index >= 0 && m_index < path.m_commands_size, "Index out of range.");
 
-  if (m_index < path.m_commands_size / 2) {
-    for (uint32_t i = 0; i < m_index; i++) {
-      switch (path.get_command(i)) {
-        case Command::Move:
-        case Command::Line:
-          m_point_index += 1;
-          break;
-        case Command::Quadratic:
-          m_point_index += 2;
-          break;
-        case Command::Cubic:
-          m_point_index += 3;
-          break;
-      }
-    }
-  } else {
-    m_point_index = static_cast<uint32_t>(path.m_points.size());
-
-    for (uint32_t i = path.m_commands_size - 1; i >= m_index; i--) {
-      switch (path.get_command(i)) {
-        case Command::Move:
-        case Command::Line:
-          m_point_index -= 1;
-          break;
-        case Command::Quadratic:
-          m_point_index -= 2;
-          break;
-        case Command::Cubic:
-          m_point_index -= 3;
-          break;
-      }
-    }
-  }
+  m_point_index = path.point_offset(m_index);
 }
 
 template<typename T, typename _>
@@ -466,7 +382,8 @@ Path<T, _>::Path(Path<T>&& other) noexcept
       m_commands_size(other.m_commands_size),
       m_closed(other.m_closed),
       m_in_handle(other.m_in_handle),
-      m_out_handle(other.m_out_handle)
+      m_out_handle(other.m_out_handle),
+      m_point_offsets(std::move(other.m_point_offsets))
 {
 }
 
@@ -569,6 +486,9 @@ Path<T, _>& Path<T, _>::operator=(const Path<T, _>& other)
   m_in_handle = other.m_in_handle;
   m_out_handle = other.m_out_handle;
 
+  /* The index is rebuilt lazily, copies are rarely accessed randomly. */
+  m_point_offsets.clear();
+
   return *this;
 }
 
@@ -581,6 +501,7 @@ Path<T, _>& Path<T, _>::operator=(Path<T, _>&& other) noexcept
   m_closed = other.m_closed;
   m_in_handle = other.m_in_handle;
   m_out_handle = other.m_out_handle;
+  m_point_offsets = std::move(other.m_point_offsets);
 
   return *this;
 }
@@ -1289,6 +1210,7 @@ void Path<T, _>::remove(const uint32_t point_index, const bool keep_shape)
     m_commands.clear();
     m_commands_size = 0;
 
+    invalidate_point_offsets(0);
     move_to(p);
 
     m_in_handle = in;
@@ -1634,7 +1556,8 @@ bool Path<T, _>::is_point_inside_path(const math::Vec2<T> point,
                                       const StrokingOptions<T>* stroke,
                                       const math::Mat2x3<T>& transform,
                                       const T threshold,
-                                      const bool deep_search) const
+                                      const bool deep_search,
+                                      const SegmentIndex<T>* segments) const
 {
   if (empty()) {
     if (vacant()) {
@@ -1661,14 +1584,23 @@ bool Path<T, _>::is_point_inside_path(const math::Vec2<T> point,
     }
   }
 
+  const math::Mat2x3<T> inverse_transform = math::inverse(transform);
+  const math::Vec2<T> local_point = inverse_transform * point;
+
   if (fill) {
-    CubicPath<T> path = to_cubic_path();
+    int winding = 0;
 
-    if (!closed()) {
-      path.line_to(path.back());
-    }
+    if (segments) {
+      winding = segments->winding_of(local_point);
+    } else {
+      CubicPath<T> path = to_cubic_path();
 
-    const int winding = path.winding_of(math::inverse(transform) * point);
+      if (!closed()) {
+        path.line_to(path.front());
+      }
+
+      winding = path.winding_of(local_point);
+    }
 
     if ((fill->rule == FillRule::NonZero && winding != 0) ||
         (fill->rule == FillRule::EvenOdd && winding % 2 != 0))
@@ -1681,6 +1613,23 @@ bool Path<T, _>::is_point_inside_path(const math::Vec2<T> point,
     return false;
   }
 
+  if (segments && !deep_search) {
+    /* Stroking is expensive, points far from every segment are rejected early. The radius covers
+     * square caps, miter joins and the flattening tolerance, and is mapped to local space along
+     * each axis. */
+
+    const T extent = std::max(std::sqrt(T(2)),
+                              stroke->join == LineJoin::Miter ? stroke->miter_limit : T(1));
+    const T radius = (stroke->width / T(2) + threshold) * extent + stroke->tolerance;
+    const math::Vec2<T> local_radius = {
+        radius * std::hypot(inverse_transform[0][0], inverse_transform[0][1]),
+        radius * std::hypot(inverse_transform[1][0], inverse_transform[1][1])};
+
+    if (!segments->is_near(local_point, local_radius)) {
+      return false;
+    }
+  }
+
   if (math::is_identity(transform)) {
     return is_point_inside_stroke(point, stroke, threshold, deep_search);
   }
@@ -2191,6 +2140,58 @@ io::EncodedData& Path<T, _>::encode(io::EncodedData& data) const
   return data;
 }
 
+template<typename T, typename _>
+uint32_t Path<T, _>::point_offset(const uint32_t command_index) const
+{
+  GK_ASSERT(command_index <= m_commands_size, "Command index out of range.");
+
+  /* The first command is always a move, the ends are the common case of iteration. */
+  if (command_index <= 1) {
+    return command_index;
+  } else if (command_index == m_commands_size) {
+    return static_cast<uint32_t>(m_points.size());
+  } else if (command_index == m_commands_size - 1) {
+    return static_cast<uint32_t>(m_points.size()) - command_points(get_command(command_index));
+  }
+
+  extend_point_offsets(command_index);
+
+  return m_point_offsets[command_index];
+}
+
+template<typename T, typename _>
+void Path<T, _>::extend_point_offsets(const uint32_t command_index) const
+{
+  GK_ASSERT(command_index < m_commands_size, "Command index out of range.");
+
+  if (m_point_offsets.empty()) {
+    m_point_offsets.reserve(m_commands_size);
+    m_point_offsets.push_back(0);
+  }
+
+  for (uint32_t i = static_cast<uint32_t>(m_point_offsets.size()); i <= command_index; i++) {
+    m_point_offsets.push_back(m_point_offsets.back() + command_points(get_command(i - 1)));
+  }
+}
+
+template<typename T, typename _>
+uint32_t Path<T, _>::point_command(const uint32_t point_index) const
+{
+  GK_ASSERT(point_index < m_points.size(), "Point index out of range.");
+
+  if (point_index >= point_offset(m_commands_size - 1)) {
+    return m_commands_size - 1;
+  }
+
+  /* The last command is handled above, so the index is only needed up to the one before it. */
+  extend_point_offsets(m_commands_size - 2);
+
+  const auto it = std::upper_bound(
+      m_point_offsets.begin(), m_point_offsets.begin() + m_commands_size - 1, point_index);
+
+  return static_cast<uint32_t>(std::distance(m_point_offsets.begin(), it)) - 1;
+}
+
 template<typename T, typename _>
 void Path<T, _>::push_command(const Command command)
 {
@@ -2208,6 +2209,8 @@ void Path<T, _>::push_command(const Command command)
 template<typename T, typename _>
 void Path<T, _>::insert_command(const Command command, const uint32_t index)
 {
+  invalidate_point_offsets(index);
+
   if (index >= m_commands_size) {
     return push_command(command);
   } else if (index == 0) {
@@ -2260,6 +2263,8 @@ void Path<T, _>::replace_command(const uint32_t index, const Command command)
 {
   GK_ASSERT(index < m_commands_size, "Command index out of range.");
 
+  invalidate_point_offsets(index + 1);
+
   uint32_t rem = index % 4;
 
   m_commands[index / 4] &= ~(0b00000011 << (6 - rem * 2));
@@ -2271,6 +2276,8 @@ void Path<T, _>::remove_command(const uint32_t index)
 {
   GK_ASSERT(index < m_commands_size, "Command index out of range.");
 
+  invalidate_point_offsets(index);
+
   if (index == m_commands_size - 1) {
     uint32_t rem = (m_commands_size - 1) % 4;
 
@@ -8,9 +8,13 @@
 
 #include "cubic_bezier.h"
 #include "cubic_path.h"
+#include "curve_ops.h"
 #include "line.h"
 #include "quadratic_bezier.h"
 #include "quadratic_path.h"
+#include "segment_index.h"
+
+#include "../math/matrix.h"
 
 #include "../utils/assert.h"
 
@@ -38,6 +42,8 @@ struct FillingOptions;
  * @brief The Path class represents the path representation used throughout the graphick editor.
  *
  * The path is represented by a list of points and a list of tightly packed traversing commands.
+ * Random access to segments and points goes through an index of the first point of each command,
+ * built lazily: it is not thread-safe, but iterating from begin() or rbegin() never builds it.
  */
 template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
 class Path {
@@ -992,6 +998,7 @@ class Path {
    * @param threshold The threshold to use for the check.
    * @param zoom The zoom level to use for the check.
    * @param deep_search Whether to include handles in the search or not.
+   * @param segments The cached segment index of the path, can be nullptr.
    * @return true if the point is inside the path, false otherwise.
    */
   bool is_point_inside_path(const math::Vec2<T> point,
@@ -999,7 +1006,8 @@ class Path {
                             const StrokingOptions<T>* stroke,
                             const math::Mat2x3<T>& transform,
                             const T threshold = T(0),
-                            const bool deep_search = false) const;
+                            const bool deep_search = false,
+                            const SegmentIndex<T>* segments = nullptr) const;
 
   /**
    * @brief Checks whether the given point is inside the specified segment of the path or not.
@@ -1095,6 +1103,88 @@ class Path {
   template<typename U>
   Path<U> transformed(const math::Mat2x3<T>& transform, bool* r_has_transform = nullptr) const;
 
+  /**
+   * @brief Transforms the path and streams it to a pipeline stage as monotonic cubic curves.
+   *
+   * It is equivalent to transformed<U>(transform).to_cubic_multipath() closed with a line to its
+   * first point, but it runs in a single pass and doesn't allocate: the stage can be a reused
+   * CubicMultipath<U> or a clipping stage (see geom::clip()).
+   *
+   * @param transform The transformation matrix to apply to the path.
+   * @param sink The stage to output the curves to, it is closed at the end.
+   */
+  template<typename U, typename S>
+  void stream(const math::Mat2x3<T>& transform, S& sink) const
+  {
+    if (empty()) {
+      sink.close();
+      return;
+    }
+
+    const math::Mat2x3<U> mat = math::Mat2x3<U>(transform);
+    const bool has_transform = !math::is_identity(transform);
+
+    const auto point = [&](const uint32_t i) {
+      return has_transform ? mat * math::Vec2<U>(m_points[i]) : math::Vec2<U>(m_points[i]);
+    };
+
+    math::Vec2<U> first = point(0);
+    math::Vec2<U> last = first;
+
+    for (uint32_t i = 0, j = 0; i < m_commands_size; i++) {
+      switch (get_command(i)) {
+        case Command::Move:
+          last = point(j);
+          sink.move_to(last);
+          j += 1;
+          break;
+        case Command::Line: {
+          const math::Vec2<U> p = point(j);
+
+          if (p != last) {
+            sink.line_to(p);
+            last = p;
+          }
+
+          j += 1;
+          break;
+        }
+        case Command::Quadratic: {
+          const math::Vec2<U> p1 = point(j);
+          const math::Vec2<U> p2 = point(j + 1);
+
+          const math::Vec2<U> cp1 = last + (p1 - last) * U(2) / U(3);
+          const math::Vec2<U> cp2 = p2 + (p1 - p2) * U(2) / U(3);
+
+          split_monotonic(CubicBezier<U>{last, cp1, cp2, p2}, [&](const CubicBezier<U>& sub) {
+            sink.cubic_to_monotonic(sub.p1, sub.p2, sub.p3);
+            last = sub.p3;
+          });
+
+          j += 2;
+          break;
+        }
+        case Command::Cubic: {
+          const CubicBezier<U> cubic = {last, point(j), point(j + 1), point(j + 2)};
+
+          split_monotonic(cubic, [&](const CubicBezier<U>& sub) {
+            sink.cubic_to_monotonic(sub.p1, sub.p2, sub.p3);
+            last = sub.p3;
+          });
+
+          j += 3;
+          break;
+        }
+      }
+    }
+
+    if (last != first) {
+      sink.line_to(first);
+    }
+
+    sink.close();
+  }
+
   /**
    * @brief Encodes the path to a list of bytes.
    *
@@ -1114,6 +1204,46 @@ class Path {
     return static_cast<Command>((m_commands[index / 4] >> (6 - (index % 4) * 2)) & 0b00000011);
   }
 
+  /**
+   * @brief Returns the index of the first point of the ith command.
+   *
+   * The offsets are cached in a prefix index, extended up to the requested command.
+   * The first and the last commands are resolved without the index.
+   *
+   * @param command_index The index of the command, m_commands_size for the end of the path.
+   * @return The number of points before the ith command.
+   */
+  uint32_t point_offset(const uint32_t command_index) const;
+
+  /**
+   * @brief Extends the prefix index of the point offsets up to the ith command.
+   *
+   * @param command_index The index of the last command to index.
+   */
+  void extend_point_offsets(const uint32_t command_index) const;
+
+  /**
+   * @brief Returns the index of the command the ith point belongs to.
+   *
+   * @param point_index The index of the point.
+   * @return The index of the command that ends with or contains the ith point.
+   */
+  uint32_t point_command(const uint32_t point_index) const;
+
+  /**
+   * @brief Discards the point offsets from the ith command on, they are rebuilt when needed.
+   *
+   * It must be called whenever a command is inserted, removed or replaced.
+   *
+   * @param command_index The index of the first changed command.
+   */
+  inline void invalidate_point_offsets(const uint32_t command_index)
+  {
+    if (m_point_offsets.size() > command_index) {
+      m_point_offsets.resize(command_index);
+    }
+  }
+
   /**
    * @brief Pushes a command to the path, handling the packing logic.
    *
@@ -1171,6 +1301,8 @@ class Path {
       m_in_handle;   // The incoming handle of the path, its index is Path::in_handle_index.
   math::Vec2<T>
       m_out_handle;  // The outgoing handle of the path, its index is Path::out_handle_index.
+
+  mutable std::vector<uint32_t> m_point_offsets;  // The first point of each command, built lazily.
  private:
   template<typename U, typename _>
   friend class Path;
@@ -20,6 +20,7 @@
 #include "../math/matrix.h"
 
 #include "../utils/debugger.h"
+#include "../utils/job_system.h"
 
 namespace graphick::geom {
 
@@ -340,6 +341,334 @@ static void recursive_flatten(
   recursive_flatten(right, clip, tolerance_sq, sink_callback, depth);
 }
 
+/* -- ContourStroker -- */
+
+/**
+ * @brief The minimum number of segments of each chunk of a path stroked in parallel.
+ */
+static constexpr uint32_t min_stroke_chunk_segments = 256;
+
+/**
+ * @brief Offsets the segments of a contour to both sides and joins them.
+ *
+ * The output of each segment only depends on the pen state: the last point of both sides, the end
+ * point and the end normal of the previous segment. A contour can therefore be stroked in chunks,
+ * as long as each chunk starts from the pen state the previous one ended with.
+ */
+template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
+struct ContourStroker {
+  CubicPath<T>& inner;                // The inner side, in the same direction of the contour.
+  CubicPath<T>& outer;                // The outer side.
+  math::Rect<T>& bounding_rect;       // The bounding rectangle, grown by the miter joins.
+
+  const StrokingOptions<T>& options;  // The options to use when stroking the path.
+  const double radius;                // Half of the stroke width.
+  const double inv_miter_limit;       // The inverse miter limit.
+
+  const math::Rect<T>* visible;       // The visible area, curves outside are treated as lines.
+  const drect visible_rect;           // The visible area in double precision, if any.
+
+  dvec2 p0;                           // The end point of the previous segment.
+  dvec2 last_n;                       // The end normal of the previous segment.
+
+  /**
+   * @brief Strokes a linear segment.
+   *
+   * @param p1 The end point of the segment.
+   */
+  void line_to(const math::Vec2<T> p1)
+  {
+    const dline line = {p0, dvec2(p1)};
+
+    const dvec2 start_n = math::normal(line.p0, line.p1);
+    const dvec2 start_nr = start_n * radius;
+    const dvec2 inner_start = line.p0 - start_nr;
+    const dvec2 outer_start = line.p0 + start_nr;
+
+    const bool small_segment = math::squared_distance(line.p0, line.p1) < radius * radius;
+
+    add_join(dvec2(inner.back()),
+             inner_start,
+             p0,
+             -last_n,
+             -start_n,
+             radius,
+             inv_miter_limit,
+             options.join,
+             inner,
+             bounding_rect,
+             small_segment,
+             true);
+    add_join(dvec2(outer.back()),
+             outer_start,
+             p0,
+             last_n,
+             start_n,
+             radius,
+             inv_miter_limit,
+             options.join,
+             outer,
+             bounding_rect,
+             small_segment);
+
+    inner.line_to(math::Vec2<T>(line.p1 - start_nr));
+    outer.line_to(math::Vec2<T>(line.p1 + start_nr));
+
+    last_n = start_n;
+    p0 = line.p1;
+  }
+
+  /**
+   * @brief Strokes a cubic bezier segment.
+   *
+   * @param p1 The first control point of the segment.
+   * @param p2 The second control point of the segment.
+   * @param p3 The end point of the segment.
+   */
+  void cubic_to(const math::Vec2<T> p1, const math::Vec2<T> p2, const math::Vec2<T> p3)
+  {
+    const dcubic_bezier cubic = {p0, dvec2(p1), dvec2(p2), dvec2(p3)};
+
+    const dvec2 end_n = cubic.end_normal();
+    const dvec2 start_n = cubic.start_normal();
+    const dvec2 start_nr = start_n * radius;
+
+    const dvec2 inner_start = cubic.p0 - start_nr;
+    const dvec2 outer_start = cubic.p0 + start_nr;
+
+    add_join(dvec2(inner.back()),
+             inner_start,
+             p0,
+             -last_n,
+             -start_n,
+             radius,
+             inv_miter_limit,
+             options.join,
+             inner,
+             bounding_rect,
+             false,
+             true);
+    add_join(dvec2(outer.back()),
+             outer_start,
+             p0,
+             last_n,
+             start_n,
+             radius,
+             inv_miter_limit,
+             options.join,
+             outer,
+             bounding_rect,
+             false);
+
+    /* Here we are using the approximate bounding rect because it could be visible event if the
+     * exact one is not. */
+    if (visible == nullptr ||
+        geom::does_rect_intersect_rect(
+            math::drect::expand(cubic.approx_bounding_rect(), radius), visible_rect))
+    {
+      // TODO: maybe join the two in one function call
+      offset_cubic(cubic, -radius, options.tolerance, inner);
+      offset_cubic(cubic, radius, options.tolerance, outer);
+    } else {
+      const dvec2 end_nr = end_n * radius;
+
+      inner.line_to(math::Vec2<T>(cubic.p1 - start_nr));
+      inner.line_to(math::Vec2<T>(cubic.p2 - end_nr));
+      inner.line_to(math::Vec2<T>(cubic.p3 - end_nr));
+
+      outer.line_to(math::Vec2<T>(cubic.p1 + start_nr));
+      outer.line_to(math::Vec2<T>(cubic.p2 + end_nr));
+      outer.line_to(math::Vec2<T>(cubic.p3 + end_nr));
+    }
+
+    last_n = end_n;
+    p0 = cubic.p3;
+  }
+
+  /**
+   * @brief Strokes the segments in the range [it, end), quadratic segments are skipped.
+   *
+   * @param it The iterator to the first segment to stroke.
+   * @param end The iterator past the last segment to stroke.
+   */
+  void stroke(typename Path<T>::Iterator it, const typename Path<T>::Iterator& end)
+  {
+    for (; it != end; ++it) {
+      const typename Path<T>::Segment segment = *it;
+
+      if (segment.is_line()) {
+        line_to(segment.p1);
+      } else if (segment.is_cubic()) {
+        cubic_to(segment.p1, segment.p2, segment.p3);
+      }
+    }
+  }
+};
+
+/**
+ * @brief A chunk of a contour stroked in parallel with the others.
+ *
+ * Both sides start with the last point the previous chunk is expected to end with.
+ */
+template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
+struct StrokeChunk {
+  CubicPath<T> inner;            // The inner side of the chunk.
+  CubicPath<T> outer;            // The outer side of the chunk.
+  math::Rect<T> bounding_rect;   // The bounding rectangle, grown by the miter joins of the chunk.
+
+  dvec2 start_p0;                // The pen position the chunk was stroked from.
+  dvec2 start_n;                 // The pen normal the chunk was stroked from.
+
+  dvec2 p0;                      // The end point of the last segment of the chunk.
+  dvec2 last_n;                  // The end normal of the last segment of the chunk.
+};
+
+/**
+ * @brief Strokes the segments of a path in chunks on the job system, appending them to a stroker.
+ *
+ * The pen state at the start of each chunk is guessed stroking the segment before it on its own:
+ * the end point and normal only depend on the segment, and so does the last point of both sides
+ * unless the segment is too small to be offset. When the chunks are merged, a wrong guess is
+ * detected comparing it with the state the previous chunk ended with, and the chunk is stroked
+ * again from it, so the result is always the same as the one of the serial stroker.
+ *
+ * @param path The path to stroke.
+ * @param chunks_count The number of chunks to split the path in.
+ * @param jobs The job system to stroke the chunks with.
+ * @param stroker The stroker of the path at its first segment, it strokes the first chunk.
+ */
+template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
+static void stroke_chunks(const Path<T>& path,
+                          const size_t chunks_count,
+                          utils::JobSystem& jobs,
+                          ContourStroker<T>& stroker)
+{
+  using Iterator = typename Path<T>::Iterator;
+
+  /* The iterators are collected walking the path, random access would build its point index,
+   * which is not thread-safe. Each iterator points to the segment before a chunk. Quadratic
+   * segments are skipped by the stroker, so neither that segment nor the one before it can be
+   * quadratic, otherwise the guessed pen state would be wrong. */
+
+  const uint32_t segments_count = path.size();
+
+  std::vector<Iterator> previous;
+  previous.reserve(chunks_count);
+
+  Iterator it = path.begin();
+
+  for (size_t i = 1; i < chunks_count; i++) {
+    const uint32_t first_segment = static_cast<uint32_t>(i * segments_count / chunks_count);
+
+    while (it.segment_index() + 1 < first_segment ||
+           ((path.command_at(it.command_index()) == Path<T>::Command::Quadratic ||
+             path.command_at(it.command_index() - 1) == Path<T>::Command::Quadratic) &&
+            it.segment_index() + 2 < segments_count))
+    {
+      ++it;
+    }
+
+    previous.push_back(it);
+  }
+
+  const math::Rect<T> bounding_rect = stroker.bounding_rect;
+  const auto chunk_end = [&](const size_t index) {
+    if (index + 1 == chunks_count) {
+      return path.end();
+    }
+
+    Iterator end = previous[index];
+    return ++end;
+  };
+
+  std::vector<StrokeChunk<T>> chunks(chunks_count);
+
+  jobs.parallel_for(chunks_count, [&](const size_t index, const size_t) {
+    if (index == 0) {
+      stroker.stroke(path.begin(), chunk_end(0));
+      return;
+    }
+
+    StrokeChunk<T>& chunk = chunks[index];
+    Iterator it = previous[index - 1];
+
+    const typename Path<T>::Segment segment = *it;
+    const dvec2 p0 = dvec2(segment.p0);
+    const dvec2 p1 = dvec2(segment.p1);
+    const dvec2 n = segment.is_cubic() ?
+                        dcubic_bezier{p0, p1, dvec2(segment.p2), dvec2(segment.p3)}.start_normal() :
+                        math::normal(p0, p1);
+
+    chunk.inner.move_to(math::Vec2<T>(p0 - n * stroker.radius));
+    chunk.outer.move_to(math::Vec2<T>(p0 + n * stroker.radius));
+    chunk.bounding_rect = bounding_rect;
+
+    ContourStroker<T> chunk_stroker{chunk.inner,
+                                    chunk.outer,
+                                    chunk.bounding_rect,
+                                    stroker.options,
+                                    stroker.radius,
+                                    stroker.inv_miter_limit,
+                                    stroker.visible,
+                                    stroker.visible_rect,
+                                    p0,
+                                    n};
+
+    chunk_stroker.stroke(it, chunk_end(index - 1));
+
+    /* Only the pen state is kept from the guessing segment, it belongs to the previous chunk. */
+
+    chunk.inner.points.erase(chunk.inner.points.begin(), chunk.inner.points.end() - 1);
+    chunk.outer.points.erase(chunk.outer.points.begin(), chunk.outer.points.end() - 1);
+    chunk.bounding_rect = bounding_rect;
+    chunk.start_p0 = chunk_stroker.p0;
+    chunk.start_n = chunk_stroker.last_n;
+
+    chunk_stroker.stroke(chunk_end(index - 1), chunk_end(index));
+
+    chunk.p0 = chunk_stroker.p0;
+    chunk.last_n = chunk_stroker.last_n;
+  });
+
+  for (size_t i = 1; i < chunks_count; i++) {
+    StrokeChunk<T>& chunk = chunks[i];
+
+    if (chunk.inner.front() != stroker.inner.back() ||
+        chunk.outer.front() != stroker.outer.back() || chunk.start_p0 != stroker.p0 ||
+        chunk.start_n != stroker.last_n)
+    {
+      ContourStroker<T> chunk_stroker{chunk.inner,
+                                      chunk.outer,
+                                      chunk.bounding_rect,
+                                      stroker.options,
+                                      stroker.radius,
+                                      stroker.inv_miter_limit,
+                                      stroker.visible,
+                                      stroker.visible_rect,
+                                      stroker.p0,
+                                      stroker.last_n};
+
+      chunk.inner.points = {stroker.inner.back()};
+      chunk.outer.points = {stroker.outer.back()};
+      chunk.bounding_rect = bounding_rect;
+
+      chunk_stroker.stroke(chunk_end(i - 1), chunk_end(i));
+
+      chunk.p0 = chunk_stroker.p0;
+      chunk.last_n = chunk_stroker.last_n;
+    }
+
+    stroker.inner.points.insert(
+        stroker.inner.points.end(), chunk.inner.points.begin() + 1, chunk.inner.points.end());
+    stroker.outer.points.insert(
+        stroker.outer.points.end(), chunk.outer.points.begin() + 1, chunk.outer.points.end());
+    stroker.bounding_rect.include(chunk.bounding_rect.min);
+    stroker.bounding_rect.include(chunk.bounding_rect.max);
+    stroker.p0 = chunk.p0;
+    stroker.last_n = chunk.last_n;
+  }
+}
+
 /* -- PathBuilder -- */
 
 template<typename T, typename _>
@@ -389,7 +718,8 @@ void PathBuilder<T, _>::flatten(
 
 template<typename T, typename _>
 StrokeOutline<T> PathBuilder<T, _>::stroke(const StrokingOptions<T>& options,
-                                           const math::Rect<T>* visible) const
+                                           const math::Rect<T>* visible,
+                                           utils::JobSystem* jobs) const
 {
   if (m_type != PathType::Generic || m_generic_path->empty())
     return {};
@@ -454,109 +784,39 @@ StrokeOutline<T> PathBuilder<T, _>::stroke(const StrokingOptions<T>& options,
     add_cap(start, p0 + last_n * radius, -last_n, radius, options.cap, outline.path);
   }
 
-  drect visible_rect = visible ? drect(*visible) : drect{};
+  ContourStroker<T> stroker{inner,
+                            outline.path,
+                            outline.bounding_rect,
+                            options,
+                            radius,
+                            inv_miter_limit,
+                            visible,
+                            visible ? drect(*visible) : drect{},
+                            p0,
+                            last_n};
+
+  /* Splitting the path is only worth it if there are enough segments to keep the workers busy. */
+
+  const size_t chunks_count = jobs && jobs->concurrency() > 1 ?
+                                  std::min(jobs->concurrency() * 4,
+                                           static_cast<size_t>(m_generic_path->size() /
+                                                               min_stroke_chunk_segments)) :
+                                  0;
+
+  if (chunks_count > 1) {
+    stroke_chunks(*m_generic_path, chunks_count, *jobs, stroker);
+  } else {
+    m_generic_path->for_each(
+        nullptr,
+        [&](const math::Vec2<T> p1) { stroker.line_to(p1); },
+        nullptr,
+        [&](const math::Vec2<T> p1, const math::Vec2<T> p2, const math::Vec2<T> p3) {
+          stroker.cubic_to(p1, p2, p3);
+        });
+  }
 
-  m_generic_path->for_each(
-      nullptr,
-      [&](const math::Vec2<T> p1) {
-        const dline line = {p0, dvec2(p1)};
-
-        const dvec2 start_n = math::normal(line.p0, line.p1);
-        const dvec2 start_nr = start_n * radius;
-        const dvec2 inner_start = line.p0 - start_nr;
-        const dvec2 outer_start = line.p0 + start_nr;
-
-        const bool small_segment = math::squared_distance(line.p0, line.p1) < radius * radius;
-
-        add_join(dvec2(inner.back()),
-                 inner_start,
-                 p0,
-                 -last_n,
-                 -start_n,
-                 radius,
-                 inv_miter_limit,
-                 options.join,
-                 inner,
-                 outline.bounding_rect,
-                 small_segment,
-                 true);
-        add_join(dvec2(outline.path.back()),
-                 outer_start,
-                 p0,
-                 last_n,
-                 start_n,
-                 radius,
-                 inv_miter_limit,
-                 options.join,
-                 outline.path,
-                 outline.bounding_rect,
-                 small_segment);
-
-        inner.line_to(math::Vec2<T>(line.p1 - start_nr));
-        outline.path.line_to(math::Vec2<T>(line.p1 + start_nr));
-
-        last_n = start_n;
-        p0 = line.p1;
-      },
-      nullptr,
-      [&](const math::Vec2<T> p1, const math::Vec2<T> p2, const math::Vec2<T> p3) {
-        const dcubic_bezier cubic = {p0, dvec2(p1), dvec2(p2), dvec2(p3)};
-
-        const dvec2 end_n = cubic.end_normal();
-        const dvec2 start_n = cubic.start_normal();
-        const dvec2 start_nr = start_n * radius;
-
-        const dvec2 inner_start = cubic.p0 - start_nr;
-        const dvec2 outer_start = cubic.p0 + start_nr;
-
-        add_join(dvec2(inner.back()),
-                 inner_start,
-                 p0,
-                 -last_n,
-                 -start_n,
-                 radius,
-                 inv_miter_limit,
-                 options.join,
-                 inner,
-                 outline.bounding_rect,
-                 false,
-                 true);
-        add_join(dvec2(outline.path.back()),
-                 outer_start,
-                 p0,
-                 last_n,
-                 start_n,
-                 radius,
-                 inv_miter_limit,
-                 options.join,
-                 outline.path,
-                 outline.bounding_rect,
-                 false);
-
-        /* Here we are using the approximate bounding rect because it could be visible event if the
-         * exact one is not. */
-        if (visible == nullptr ||
-            geom::does_rect_intersect_rect(
-                math::drect::expand(cubic.approx_bounding_rect(), radius), visible_rect))
-        {
-          // TODO: maybe join the two in one function call
-          offset_cubic(cubic, -radius, options.tolerance, inner);
-          offset_cubic(cubic, radius, options.tolerance, outline.path);
-        } else {
-          const dvec2 end_nr = end_n * radius;
-
-          inner.line_to(math::Vec2<T>(cubic.p1 - start_nr));
-          inner.line_to(math::Vec2<T>(cubic.p2 - end_nr));
-          inner.line_to(math::Vec2<T>(cubic.p3 - end_nr));
-
-          outline.path.line_to(math::Vec2<T>(cubic.p1 + start_nr));
-          outline.path.line_to(math::Vec2<T>(cubic.p2 + end_nr));
-          outline.path.line_to(math::Vec2<T>(cubic.p3 + end_nr));
-        }
-
-        last_n = end_n;
-        p0 = cubic.p3;
-      });
+  p0 = stroker.p0;
+  last_n = stroker.last_n;
 
   if (m_generic_path->closed()) {
     add_join(dvec2(inner.back()),
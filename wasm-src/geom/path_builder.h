@@ -13,6 +13,14 @@
 
 #include <functional>
 
+namespace graphick::utils {
+
+/* -- Forward Declarations -- */
+
+class JobSystem;
+
+}  // namespace graphick::utils
+
 namespace graphick::geom {
 
 /* -- Forward Declarations -- */
@@ -81,14 +89,17 @@ class PathBuilder {
   /**
    * @brief Strokes a path and outputs the resulting cubic curves grouped in contours.
    *
-   * This method is only available for generic paths.
+   * This method is only available for generic paths. Long paths are split in chunks of segments
+   * stroked in parallel, the result is the same as the one of the serial stroker.
    *
    * @param options The options to use when stroking the path.
    * @param visible The portion of the path visible, curves outside will be treated as lines.
+   * @param jobs The job system to stroke long paths with, nullptr to stroke on the calling thread.
    * @return The resulting cubic curves grouped in contours.
    */
   StrokeOutline<T> stroke(const StrokingOptions<T>& options,
-                          const math::Rect<T>* visible = nullptr) const;
+                          const math::Rect<T>* visible = nullptr,
+                          utils::JobSystem* jobs = nullptr) const;
 
  private:
   /**
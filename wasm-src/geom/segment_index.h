@@ -0,0 +1,234 @@
+/**
+ * @file segment_index.h
+ * @brief This file contains the definition of the SegmentIndex class, an acceleration structure
+ * for point queries against the segments of a path.
+ */
+
+#pragma once
+
+#include "cubic_path.h"
+#include "curve_ops.h"
+
+#include "../math/rect.h"
+#include "../math/vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace graphick::geom {
+
+/**
+ * @brief An index of the monotonic segments of a closed path, bucketed in horizontal bands.
+ *
+ * Each segment is stored in every band its y range overlaps, so a winding query only visits the
+ * segments of the band containing the point and a proximity query only the bands overlapping the
+ * query radius. The winding number is the same as the one of CubicPath::winding_of().
+ */
+template<typename T, typename = std::enable_if<std::is_floating_point_v<T>>>
+class SegmentIndex {
+ public:
+  static constexpr size_t max_bands = 1024;  // The maximum number of bands.
+ public:
+  /**
+   * @brief Default constructor, creates an empty index.
+   */
+  SegmentIndex() = default;
+
+  /**
+   * @brief Builds the index of a cubic path.
+   *
+   * The path is implicitly closed, as it is done when rendering fills.
+   *
+   * @param path The path to index, its segments should be monotonic.
+   */
+  explicit SegmentIndex(const CubicPath<T>& path) : m_path(path)
+  {
+    if (m_path.empty()) {
+      return;
+    }
+
+    if (!m_path.closed()) {
+      m_path.line_to(m_path.front());
+    }
+
+    const size_t size = m_path.size();
+
+    m_bounds.resize(size);
+    m_bounding_rect = math::Rect<T>{};
+
+    for (size_t i = 0; i < size; i++) {
+      m_bounds[i] = approx_bounding_rect(segment(i));
+      m_bounding_rect = math::Rect<T>::from_rects(m_bounding_rect, m_bounds[i]);
+    }
+
+    const size_t bands = std::clamp(
+        static_cast<size_t>(std::sqrt(static_cast<T>(size)) * T(2)), size_t(1), max_bands);
+
+    m_band_height = std::max(m_bounding_rect.size().y / static_cast<T>(bands),
+                             std::numeric_limits<T>::min());
+    m_band_starts.assign(bands + 1, 0);
+
+    /* Counting sort of the segments by band, the first pass counts the segments of each band. */
+
+    for (size_t i = 0; i < size; i++) {
+      for (size_t j = band(m_bounds[i].min.y); j <= band(m_bounds[i].max.y); j++) {
+        m_band_starts[j + 1]++;
+      }
+    }
+
+    for (size_t j = 0; j < bands; j++) {
+      m_band_starts[j + 1] += m_band_starts[j];
+    }
+
+    std::vector<uint32_t> offsets(m_band_starts.begin(), m_band_starts.end() - 1);
+
+    m_band_segments.resize(m_band_starts.back());
+
+    for (size_t i = 0; i < size; i++) {
+      for (size_t j = band(m_bounds[i].min.y); j <= band(m_bounds[i].max.y); j++) {
+        m_band_segments[offsets[j]++] = static_cast<uint32_t>(i);
+      }
+    }
+  }
+
+  /**
+   * @brief Checks whether the index is empty.
+   *
+   * @return true if there are no segments, false otherwise.
+   */
+  inline bool empty() const
+  {
+    return m_bounds.empty();
+  }
+
+  /**
+   * @brief Returns the number of indexed segments.
+   *
+   * @return The number of segments.
+   */
+  inline size_t size() const
+  {
+    return m_bounds.size();
+  }
+
+  /**
+   * @brief Returns the approximate number of bytes used by the index.
+   *
+   * @return The memory footprint of the index.
+   */
+  inline size_t memory() const
+  {
+    return m_path.points.size() * sizeof(math::Vec2<T>) +
+           m_bounds.size() * sizeof(math::Rect<T>) +
+           (m_band_starts.size() + m_band_segments.size()) * sizeof(uint32_t);
+  }
+
+  /**
+   * @brief Calculates the winding number of a point.
+   *
+   * @param p The point to check.
+   * @return The winding number of the point.
+   */
+  int winding_of(const math::Vec2<T> p) const
+  {
+    if (empty() || p.y < m_bounding_rect.min.y || p.y > m_bounding_rect.max.y ||
+        p.x > m_bounding_rect.max.x)
+    {
+      return 0;
+    }
+
+    const size_t j = band(p.y);
+
+    int winding = 0;
+
+    for (uint32_t k = m_band_starts[j]; k < m_band_starts[j + 1]; k++) {
+      winding += geom::winding_of(segment(m_band_segments[k]), p);
+    }
+
+    return winding;
+  }
+
+  /**
+   * @brief Checks whether a point is close to the segments.
+   *
+   * This is a conservative test based on the control points of the segments: it never returns
+   * false for points that are within the given radius of the path.
+   *
+   * @param p The point to check.
+   * @param radius The maximum distance from the segments along each axis.
+   * @return true if the point could be within the radius of a segment, false otherwise.
+   */
+  bool is_near(const math::Vec2<T> p, const math::Vec2<T> radius) const
+  {
+    if (empty() || !is_point_in_rect(p, m_bounding_rect, radius)) {
+      return false;
+    }
+
+    const size_t start = band(p.y - radius.y);
+    const size_t end = band(p.y + radius.y);
+
+    for (uint32_t k = m_band_starts[start]; k < m_band_starts[end + 1]; k++) {
+      if (is_point_in_rect(p, m_bounds[m_band_segments[k]], radius)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+ private:
+  /**
+   * @brief Returns the i-th segment of the indexed path.
+   *
+   * @param i The index of the segment.
+   * @return The segment.
+   */
+  inline CubicBezier<T> segment(const size_t i) const
+  {
+    return CubicBezier<T>{m_path.points[i * 3],
+                          m_path.points[i * 3 + 1],
+                          m_path.points[i * 3 + 2],
+                          m_path.points[i * 3 + 3]};
+  }
+
+  /**
+   * @brief Returns the band containing the given y coordinate, clamped to the valid bands.
+   *
+   * @param y The y coordinate.
+   * @return The index of the band.
+   */
+  inline size_t band(const T y) const
+  {
+    const T j = std::floor((y - m_bounding_rect.min.y) / m_band_height);
+    return static_cast<size_t>(std::clamp(j, T(0), static_cast<T>(m_band_starts.size() - 2)));
+  }
+
+  /**
+   * @brief Checks whether a point is inside a rectangle expanded by a radius.
+   *
+   * @param p The point to check.
+   * @param rect The rectangle.
+   * @param radius The expansion of the rectangle along each axis.
+   * @return true if the point is inside the expanded rectangle, false otherwise.
+   */
+  static inline bool is_point_in_rect(const math::Vec2<T> p,
+                                      const math::Rect<T>& rect,
+                                      const math::Vec2<T> radius)
+  {
+    return p.x >= rect.min.x - radius.x && p.x <= rect.max.x + radius.x &&
+           p.y >= rect.min.y - radius.y && p.y <= rect.max.y + radius.y;
+  }
+
+ private:
+  CubicPath<T> m_path;                     // The closed path, with monotonic segments.
+  std::vector<math::Rect<T>> m_bounds;     // The approximate bounds of each segment.
+  math::Rect<T> m_bounding_rect;           // The bounds of the whole path.
+
+  T m_band_height = T(0);                  // The height of each band.
+  std::vector<uint32_t> m_band_starts;     // The first entry of each band, plus the end.
+  std::vector<uint32_t> m_band_segments;   // The segments of each band, stored contiguously.
+};
+
+}  // namespace graphick::geom
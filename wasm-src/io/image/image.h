@@ -18,6 +18,7 @@ struct Image {
   uint8_t* data;     // A pointer to the image data.
   ivec2 size;        // The size of the image.
   uint8_t channels;  // The number of channels of the image.
+  uint8_t level = 0; // The size of the original image is halved level times.
 };
 
 }  // namespace graphick::io
@@ -0,0 +1,226 @@
+/**
+ * @file io/image/image_decoder.cpp
+ * @brief The file contains the implementation of the image decoder.
+ */
+
+#include "image_decoder.h"
+
+#include "../../lib/stb/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace graphick::io {
+
+/**
+ * @brief The time spent decoding images per frame on the calling thread, when there are no worker
+ * threads, in milliseconds.
+ */
+static constexpr double main_thread_budget = 4.0;
+
+/**
+ * @brief Halves the size of an image level times, averaging the pixels of each block.
+ *
+ * @param data The pixels of the image.
+ * @param size The size of the image, updated to the size of the downsampled image.
+ * @param channels The number of channels of the image.
+ * @param level The number of times to halve the image size.
+ * @return The pixels of the downsampled image, allocated with malloc() as stb_image does.
+ */
+static uint8_t* downsample(const uint8_t* data,
+                           ivec2& size,
+                           const int channels,
+                           const uint8_t level)
+{
+  const int factor = 1 << level;
+  const ivec2 image_size = size;
+
+  size = ivec2(std::max(image_size.x >> level, 1), std::max(image_size.y >> level, 1));
+
+  uint8_t* pixels = static_cast<uint8_t*>(
+      std::malloc(static_cast<size_t>(size.x) * size.y * channels));
+
+  if (pixels == nullptr) {
+    return nullptr;
+  }
+
+  uint32_t sums[4];
+
+  for (int y = 0; y < size.y; y++) {
+    const int y0 = y * factor;
+    const int y1 = std::min(y0 + factor, image_size.y);
+
+    for (int x = 0; x < size.x; x++) {
+      const int x0 = x * factor;
+      const int x1 = std::min(x0 + factor, image_size.x);
+
+      std::fill(sums, sums + channels, 0);
+
+      for (int j = y0; j < y1; j++) {
+        const uint8_t* row = data + (static_cast<size_t>(j) * image_size.x + x0) * channels;
+
+        for (int i = 0; i < (x1 - x0) * channels; i++) {
+          sums[i % channels] += row[i];
+        }
+      }
+
+      const uint32_t count = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+      uint8_t* pixel = pixels + (static_cast<size_t>(y) * size.x + x) * channels;
+
+      for (int c = 0; c < channels; c++) {
+        pixel[c] = static_cast<uint8_t>((sums[c] + count / 2) / count);
+      }
+    }
+  }
+
+  return pixels;
+}
+
+/**
+ * @brief Returns the current time in milliseconds.
+ */
+static inline double now_ms()
+{
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+ImageDecoder::ImageDecoder(const size_t workers_count) : m_workers_count(workers_count) {}
+
+ImageDecoder::~ImageDecoder()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_queued.notify_all();
+
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+
+  for (const Result& result : m_results) {
+    stbi_image_free(result.data);
+  }
+}
+
+void ImageDecoder::submit(const uuid id,
+                          const uint8_t* data,
+                          const size_t size,
+                          const uint8_t level)
+{
+  if (m_workers.empty() && m_workers_count > 0) {
+    m_workers.reserve(m_workers_count);
+
+    for (size_t i = 0; i < m_workers_count; i++) {
+      m_workers.emplace_back(&ImageDecoder::worker_loop, this);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(Job{id, data, size, level});
+  }
+
+  m_queued.notify_one();
+  m_pending++;
+}
+
+std::vector<ImageDecoder::Result> ImageDecoder::collect(const bool wait)
+{
+  std::vector<Result> results;
+
+  if (m_pending == 0) {
+    return results;
+  }
+
+  if (m_workers.empty()) {
+    /* An image can take longer than the budget, the following calls pay off the excess. */
+    if (!wait && m_decode_debt > 0.0) {
+      m_decode_debt = std::max(m_decode_debt - main_thread_budget, 0.0);
+      return results;
+    }
+
+    const double start = now_ms();
+
+    /* Without workers the images are decoded here, within the budget unless waiting. */
+    do {
+      results.push_back(decode(m_jobs.front()));
+      m_jobs.pop_front();
+    } while (!m_jobs.empty() && (wait || now_ms() - start < main_thread_budget));
+
+    m_decode_debt = wait ? 0.0 : std::max(now_ms() - start - main_thread_budget, 0.0);
+  } else {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (wait) {
+      m_decoded.wait(lock, [this]() { return m_results.size() == m_pending; });
+    }
+
+    results.swap(m_results);
+  }
+
+  m_pending -= results.size();
+
+  return results;
+}
+
+ImageDecoder::Result ImageDecoder::decode(const Job& job)
+{
+  int width, height, channels;
+
+  uint8_t* data = stbi_load_from_memory(
+      job.data, static_cast<int>(job.size), &width, &height, &channels, 0);
+
+  if (data == nullptr) {
+    return Result{job.id, nullptr, ivec2::zero(), 0, 0};
+  }
+
+  ivec2 size = ivec2(width, height);
+
+  if (job.level > 0) {
+    uint8_t* pixels = downsample(data, size, channels, job.level);
+
+    stbi_image_free(data);
+    data = pixels;
+
+    if (data == nullptr) {
+      return Result{job.id, nullptr, ivec2::zero(), 0, 0};
+    }
+  }
+
+  return Result{job.id, data, size, static_cast<uint8_t>(channels), job.level};
+}
+
+void ImageDecoder::worker_loop()
+{
+  while (true) {
+    Job job{uuid::null, nullptr, 0, 0};
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_queued.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+
+      if (m_stop) {
+        return;
+      }
+
+      job = m_jobs.front();
+      m_jobs.pop_front();
+    }
+
+    const Result result = decode(job);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_results.push_back(result);
+    }
+
+    m_decoded.notify_one();
+  }
+}
+
+}  // namespace graphick::io
@@ -0,0 +1,130 @@
+/**
+ * @file io/image/image_decoder.h
+ * @brief The file contains the definition of the image decoder.
+ */
+
+#pragma once
+
+#include "../../math/vec2.h"
+
+#include "../../utils/uuid.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace graphick::io {
+
+/**
+ * @brief The ImageDecoder class decodes encoded images on a pool of background threads.
+ *
+ * The worker threads are spawned with the first submitted image. Decoded images are handed back
+ * to the owning thread by collect(), so the caches of the ResourceManager are never touched by the
+ * workers. Without worker threads (e.g. WebAssembly builds without pthreads) the images are
+ * decoded on the calling thread by collect(), within a time budget per call: when an image takes
+ * longer than that, the following calls decode nothing until the excess is paid off.
+ */
+class ImageDecoder {
+ public:
+  /**
+   * @brief A decoded image, the data is allocated by stb_image and owned by the receiver.
+   *
+   * If the image could not be decoded, data is nullptr.
+   */
+  struct Result {
+    uuid id;           // The id of the image.
+    uint8_t* data;     // The decoded pixels, nullptr if the image could not be decoded.
+    ivec2 size;        // The size of the decoded pixels.
+    uint8_t channels;  // The number of channels of the image.
+    uint8_t level;     // The image size is halved level times.
+  };
+ public:
+  /**
+   * @brief Constructs a new image decoder.
+   *
+   * @param workers_count The number of worker threads to spawn once an image is submitted.
+   */
+  ImageDecoder(const size_t workers_count);
+
+  /**
+   * @brief Deleted copy and move constructors.
+   */
+  ImageDecoder(const ImageDecoder&) = delete;
+  ImageDecoder(ImageDecoder&&) = delete;
+
+  /**
+   * @brief Joins the worker threads, discarding the images that are still queued.
+   */
+  ~ImageDecoder();
+
+  /**
+   * @brief Returns the number of images submitted and not collected yet.
+   *
+   * @return The number of images being decoded.
+   */
+  inline size_t pending() const
+  {
+    return m_pending;
+  }
+
+  /**
+   * @brief Queues an image to be decoded.
+   *
+   * @param id The id of the image.
+   * @param data The encoded image, it must stay valid until the image is collected.
+   * @param size The size of the encoded image.
+   * @param level The number of times to halve the size of the decoded image, default is 0.
+   */
+  void submit(const uuid id, const uint8_t* data, const size_t size, const uint8_t level = 0);
+
+  /**
+   * @brief Takes the images decoded since the last call.
+   *
+   * @param wait Whether to block until all of the submitted images are decoded.
+   * @return The decoded images, the caller takes ownership of their data.
+   */
+  std::vector<Result> collect(const bool wait = false);
+
+ private:
+  /**
+   * @brief An image waiting to be decoded.
+   */
+  struct Job {
+    uuid id;              // The id of the image.
+    const uint8_t* data;  // The encoded image.
+    size_t size;          // The size of the encoded image.
+    uint8_t level;        // The number of times to halve the size of the decoded image.
+  };
+ private:
+  /**
+   * @brief Decodes an image, downsampling it to the level of the job.
+   *
+   * @param job The image to decode.
+   * @return The decoded image.
+   */
+  static Result decode(const Job& job);
+
+  /**
+   * @brief The loop executed by each worker thread.
+   */
+  void worker_loop();
+
+ private:
+  size_t m_workers_count;              // The number of worker threads to spawn.
+  std::vector<std::thread> m_workers;  // The worker threads, empty until an image is submitted.
+
+  std::mutex m_mutex;                  // Protects the queues below.
+  std::condition_variable m_queued;    // Notified when an image is queued.
+  std::condition_variable m_decoded;   // Notified when an image is decoded.
+
+  std::deque<Job> m_jobs;              // The images waiting to be decoded.
+  std::vector<Result> m_results;       // The decoded images waiting to be collected.
+  bool m_stop = false;                 // Whether the workers should exit.
+
+  size_t m_pending = 0;                // The images submitted and not collected yet.
+  double m_decode_debt = 0.0;          // The decoding time over budget, without workers, in ms.
+};
+
+}  // namespace graphick::io
@@ -9,10 +9,13 @@
 
 #include "../utils/console.h"
 #include "../utils/defines.h"
+#include "../utils/job_system.h"
 
 #include "../lib/stb/stb_image.h"
 #include "../lib/stb/stb_truetype.h"
 
+#include <algorithm>
+
 static uint8_t default_image_data[4] = {255, 0, 255, 255};
 
 static const std::string shader_include_names[] = {"quadratic", "cubic", "texture"};
@@ -27,7 +30,7 @@ static const std::string shader_names[] = {"tile",
 
 namespace graphick::io {
 
-ResourceManager* ResourceManager::s_instance = nullptr;
+thread_local ResourceManager* ResourceManager::s_instance = nullptr;
 
 void ResourceManager::init()
 {
@@ -41,7 +44,16 @@ void ResourceManager::init()
   s_instance->prefetch_shaders();
 }
 
-void ResourceManager::shutdown() {}
+void ResourceManager::shutdown()
+{
+  if (s_instance == nullptr) {
+    console::error("ResourceManager already shutdown, call init() before shutting down!");
+    return;
+  }
+
+  delete s_instance;
+  s_instance = nullptr;
+}
 
 std::string ResourceManager::get_shader(const std::string& name)
 {
@@ -59,15 +71,23 @@ uuid ResourceManager::load_image(const uint8_t* data, const size_t size)
     return uuid::null;
   }
 
-  uint8_t* buffer = stbi_load_from_memory(data, size, &width, &height, &channels, 0);
-
-  if (buffer == nullptr) {
+  if (!stbi_info_from_memory(data, size, &width, &height, &channels)) {
     console::error("Failed to load image from memory!");
     return uuid::null;
   }
 
-  s_instance->m_images.insert(
-      std::make_pair(id, ImageData{buffer, ivec2(width, height), static_cast<uint8_t>(channels)}));
+  ImageData image(nullptr,
+                  ivec2(width, height),
+                  static_cast<uint8_t>(channels),
+                  std::vector<uint8_t>(data, data + size));
+
+  /* Moving the image keeps the buffer of the encoded copy, so the workers can keep reading it. */
+  image.decoding = true;
+  image.ready = false;
+  s_instance->m_decoder.submit(id, image.encoded.data(), image.encoded.size());
+  s_instance->m_loading++;
+
+  s_instance->m_images.insert(std::make_pair(id, std::move(image)));
 
   return id;
 }
@@ -108,7 +128,156 @@ Image ResourceManager::get_image(const uuid id)
     return Image{default_image_data, ivec2(1), uint8_t(4)};
   }
 
-  return Image{it->second.data, it->second.size, it->second.channels};
+  ImageData& image = it->second;
+
+  if (image.data == nullptr || image.level != 0) {
+    int width, height, channels;
+
+    stbi_image_free(image.data);
+    image.data = nullptr;
+    image.level = 0;
+
+    if (!image.encoded.empty()) {
+      image.data = stbi_load_from_memory(
+          image.encoded.data(), image.encoded.size(), &width, &height, &channels, 0);
+    }
+
+    if (image.data == nullptr) {
+      console::error("Failed to decode image from cache!");
+      return Image{default_image_data, ivec2(1), uint8_t(4)};
+    }
+  }
+
+  return Image{image.data, image.size, image.channels};
+}
+
+Image ResourceManager::get_image(const uuid id, const uint8_t level)
+{
+  const auto it = s_instance->m_images.find(id);
+
+  if (it == s_instance->m_images.end()) {
+    return get_image(id);
+  }
+
+  ImageData& image = it->second;
+
+  /* The default image and the images that could not be decoded are never decoded again: they are
+   * drawn with their resident data, if any, or with the default image. */
+  if (image.encoded.empty() && image.data == nullptr) {
+    return Image{default_image_data, ivec2(1), uint8_t(4)};
+  }
+
+  if (!image.encoded.empty() && (image.data == nullptr || image.level != level) &&
+      !image.decoding)
+  {
+    image.decoding = true;
+    s_instance->m_decoder.submit(id, image.encoded.data(), image.encoded.size(), level);
+  }
+
+  const ivec2 size = ivec2(std::max(image.size.x >> image.level, 1),
+                           std::max(image.size.y >> image.level, 1));
+
+  return Image{image.data, size, image.channels, image.level};
+}
+
+ivec2 ResourceManager::get_image_size(const uuid id)
+{
+  const auto it = s_instance->m_images.find(id);
+
+  if (it == s_instance->m_images.end()) {
+    console::error("Image not found in cache!");
+    return ivec2(1);
+  }
+
+  return it->second.size;
+}
+
+uint8_t ResourceManager::get_image_channels(const uuid id)
+{
+  const auto it = s_instance->m_images.find(id);
+
+  if (it == s_instance->m_images.end()) {
+    console::error("Image not found in cache!");
+    return uint8_t(4);
+  }
+
+  return it->second.channels;
+}
+
+void ResourceManager::release_image_data(const uuid id)
+{
+  const auto it = s_instance->m_images.find(id);
+
+  /* Images without an encoded copy could not be decoded again. */
+  if (it == s_instance->m_images.end() || it->second.encoded.empty()) {
+    return;
+  }
+
+  stbi_image_free(it->second.data);
+  it->second.data = nullptr;
+  it->second.level = 0;
+}
+
+bool ResourceManager::is_image_ready(const uuid id)
+{
+  const auto it = s_instance->m_images.find(id);
+  return it == s_instance->m_images.end() || it->second.ready;
+}
+
+size_t ResourceManager::poll_images(const bool wait)
+{
+  const std::vector<ImageDecoder::Result> results = s_instance->m_decoder.collect(wait);
+
+  for (const ImageDecoder::Result& result : results) {
+    ImageData& image = s_instance->m_images.at(result.id);
+
+    image.decoding = false;
+
+    if (!image.ready) {
+      image.ready = true;
+
+      s_instance->m_loading--;
+      s_instance->m_decoded++;
+    }
+
+    if (result.data == nullptr) {
+      console::error("Failed to decode image!");
+
+      /* The image is not decoded again, it is drawn with the default image. */
+      image.encoded.clear();
+    } else if (image.data != nullptr && image.level == result.level) {
+      /* The image was already decoded on this thread by get_image(). */
+      stbi_image_free(result.data);
+    } else {
+      stbi_image_free(image.data);
+
+      image.data = result.data;
+      image.level = result.level;
+    }
+  }
+
+  if (s_instance->m_loading == 0) {
+    s_instance->m_decoded = 0;
+  }
+
+  return results.size();
+}
+
+size_t ResourceManager::pending_images()
+{
+  return s_instance->m_loading;
+}
+
+float ResourceManager::images_progress()
+{
+  const size_t pending = s_instance->m_loading;
+
+  if (pending == 0) {
+    return 1.0f;
+  }
+
+  return static_cast<float>(s_instance->m_decoded) /
+         static_cast<float>(s_instance->m_decoded + pending);
 }
 
 const text::Font& ResourceManager::get_font(const uuid id)
@@ -123,7 +292,7 @@ const text::Font& ResourceManager::get_font(const uuid id)
   return it->second;
 }
 
-ResourceManager::ResourceManager()
+ResourceManager::ResourceManager() : m_decoder(utils::JobSystem::default_workers_count())
 {
   text::Font font(default_font_data, std::size(default_font_data));
   m_fonts.insert(std::make_pair(uuid::null, std::move(font)));
@@ -132,9 +301,16 @@ ResourceManager::ResourceManager()
   m_images.insert(std::make_pair(uuid::null, std::move(image)));
 }
 
+ResourceManager::~ResourceManager()
+{
+  /* The default image is not allocated by stb_image, so it must not be freed. */
+  m_images.at(uuid::null).data = nullptr;
+}
+
 void ResourceManager::prefetch_shaders()
 {
-  static std::string shader_include_sources[std::size(shader_include_names)] = {
+  /* The sources are patched in place, so they are not shared between threads. */
+  std::string shader_include_sources[std::size(shader_include_names)] = {
 #include "../renderer/gpu/shaders/include/quadratic.glsl"
       ,
 #include "../renderer/gpu/shaders/include/cubic.glsl"
@@ -142,7 +318,7 @@ void ResourceManager::prefetch_shaders()
 #include "../renderer/gpu/shaders/include/texture.glsl"
   };
 
-  static std::string shader_sources[std::size(shader_names) * 2] = {
+  std::string shader_sources[std::size(shader_names) * 2] = {
 #include "../renderer/gpu/shaders/tile.vs.glsl"
       ,
 #include "../renderer/gpu/shaders/tile.fs.glsl"
@@ -181,13 +357,22 @@ void ResourceManager::prefetch_shaders()
   }
 }
 
-ResourceManager::ImageData::ImageData(uint8_t* data, ivec2 size, uint8_t channels)
-    : data(data), size(size), channels(channels)
+ResourceManager::ImageData::ImageData(uint8_t* data,
+                                      ivec2 size,
+                                      uint8_t channels,
+                                      std::vector<uint8_t> encoded)
+    : data(data), size(size), channels(channels), encoded(std::move(encoded))
 {
 }
 
 ResourceManager::ImageData::ImageData(ImageData&& other) noexcept
-    : data(other.data), size(other.size), channels(other.channels)
+    : data(other.data),
+      size(other.size),
+      channels(other.channels),
+      encoded(std::move(other.encoded)),
+      decoding(other.decoding),
+      level(other.level),
+      ready(other.ready)
 {
   other.data = nullptr;
 }
@@ -198,6 +383,10 @@ ResourceManager::ImageData& ResourceManager::ImageData::operator=(ImageData&& ot
     data = other.data;
     size = other.size;
     channels = other.channels;
+    encoded = std::move(other.encoded);
+    decoding = other.decoding;
+    level = other.level;
+    ready = other.ready;
 
     other.data = nullptr;
   }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "image/image.h"
+#include "image/image_decoder.h"
 #include "text/font.h"
 
 #include "../utils/uuid.h"
@@ -15,6 +16,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace graphick::io {
 
@@ -22,6 +24,7 @@ namespace graphick::io {
  * @brief The class that represents the resource manager.
  *
  * It is responsible for loading and caching static resources such as shaders and fonts.
+ * Each thread that calls init() gets its own caches.
  */
 class ResourceManager {
  public:
@@ -53,6 +56,9 @@ class ResourceManager {
   /**
    * @brief Loads an image into the cache.
    *
+   * Only the header is read here, the image is decoded in the background: until poll_images()
+   * collects it, is_image_ready() returns false and the renderer draws a placeholder instead.
+   *
    * @param data The image data.
    * @param size The size of the image data.
    * @return The UUID of the image.
@@ -78,13 +84,86 @@ class ResourceManager {
   static uuid load_default_font(const uint8_t* data, const size_t size);
 
   /**
-   * @brief Retrieves an image from the cache.
+   * @brief Retrieves an image from the cache, at full resolution.
+   *
+   * If the decoded data was released, is downsampled or is not ready yet, the image is decoded on
+   * this thread.
    *
    * @param id The UUID of the image.
    * @return A lightweight wrapper around the image data.
    */
   static Image get_image(uuid id);
 
+  /**
+   * @brief Retrieves an image from the cache with its size halved level times, without blocking.
+   *
+   * If the image is not decoded at that level, it is decoded and downsampled in the background,
+   * the data decoded at another level is returned until poll_images() collects it.
+   *
+   * @param id The UUID of the image.
+   * @param level The number of times the image size is halved.
+   * @return A lightweight wrapper around the image data, data is nullptr if nothing is decoded.
+   */
+  static Image get_image(const uuid id, const uint8_t level);
+
+  /**
+   * @brief Retrieves the size of an image from the cache, without decoding it.
+   *
+   * @param id The UUID of the image.
+   * @return The size of the image in pixels.
+   */
+  static ivec2 get_image_size(const uuid id);
+
+  /**
+   * @brief Retrieves the number of channels of an image from the cache, without decoding it.
+   *
+   * @param id The UUID of the image.
+   * @return The number of channels of the image.
+   */
+  static uint8_t get_image_channels(const uuid id);
+
+  /**
+   * @brief Frees the decoded data of an image, i.e. once it is uploaded to the GPU.
+   *
+   * The encoded image is kept, so that it can be decoded again by get_image() at any level.
+   *
+   * @param id The UUID of the image.
+   */
+  static void release_image_data(const uuid id);
+
+  /**
+   * @brief Checks whether an image was decoded once since it was loaded, i.e. whether it can be
+   * drawn.
+   *
+   * @param id The UUID of the image.
+   * @return true if the image is not being loaded in the background, false otherwise.
+   */
+  static bool is_image_ready(const uuid id);
+
+  /**
+   * @brief Moves the images decoded in the background into the cache.
+   *
+   * It should be called once per frame by the thread that loaded the images.
+   *
+   * @param wait Whether to block until all of the loaded images are decoded.
+   * @return The number of images decoded, loaded or decoded again at another level.
+   */
+  static size_t poll_images(const bool wait = false);
+
+  /**
+   * @brief Retrieves the number of images that are being loaded in the background.
+   *
+   * @return The number of images not ready yet, images decoded again are not counted.
+   */
+  static size_t pending_images();
+
+  /**
+   * @brief Retrieves the progress of the images loaded since all of the images were last ready.
+   *
+   * @return The fraction of the images that are ready, in the range [0, 1].
+   */
+  static float images_progress();
+
   static const text::Font& get_font(const uuid id);
 
  private:
@@ -92,11 +171,20 @@ class ResourceManager {
    * @brief The struct that represents the image data in the cache.
    */
   struct ImageData {
-    uint8_t* data;     // A pointer to the image data (allocated by stb_image).
-    ivec2 size;        // The size of the image.
-    uint8_t channels;  // The number of channels of the image.
+    uint8_t* data;                 // A pointer to the image data (allocated by stb_image).
+    ivec2 size;                    // The size of the image.
+    uint8_t channels;              // The number of channels of the image.
+
+    std::vector<uint8_t> encoded;  // The encoded image, empty for the default image.
+    bool decoding = false;         // Whether the image is being decoded in the background.
 
-    ImageData(uint8_t* data, ivec2 size, uint8_t channels);
+    uint8_t level = 0;             // The size of the decoded data is halved level times.
+    bool ready = true;             // Whether the image was decoded once since it was loaded.
+
+    ImageData(uint8_t* data,
+              ivec2 size,
+              uint8_t channels,
+              std::vector<uint8_t> encoded = std::vector<uint8_t>());
     ImageData(const ImageData&) = delete;
     ImageData(ImageData&& other) noexcept;
     ImageData& operator=(const ImageData&) = delete;
@@ -113,7 +201,7 @@ class ResourceManager {
    * @brief Default constructor and destructor.
    */
   ResourceManager();
-  ~ResourceManager() = default;
+  ~ResourceManager();
 
   /**
    * @brief Prefetches the shaders and loads them into the cache.
@@ -126,8 +214,12 @@ class ResourceManager {
   std::unordered_map<std::string, std::string> m_shaders;  // The cache of shaders.
   std::unordered_map<uuid, ImageData> m_images;            // The cache of images.
   std::unordered_map<uuid, text::Font> m_fonts;            // The cache of fonts.
+
+  ImageDecoder m_decoder;  // Decodes the images, destroyed before the encoded data it reads.
+  size_t m_decoded = 0;    // The images loaded since the decoder was last idle.
+  size_t m_loading = 0;    // The images loaded and not decoded yet.
  private:
-  static ResourceManager* s_instance;  // The instance of the resource manager singleton.
+  static thread_local ResourceManager* s_instance;  // The resource manager of this thread.
 };
 
 }  // namespace graphick::io
@@ -11,6 +11,8 @@
 #include "scalar.h"
 #include "vector.h"
 
+#include <algorithm>
+#include <cstring>
 #include <optional>
 #include <tuple>
 #include <vector>
@@ -241,7 +243,8 @@ inline int hash(std::initializer_list<T> numbers)
   int h = 1;
 
   for (T n : numbers) {
-    int i = *(int*)(&n);
+    int i = 0;
+    std::memcpy(&i, &n, std::min(sizeof(T), sizeof(int)));
     h = 31 * h + i;
   }
 
@@ -263,7 +266,8 @@ inline int hash(const std::vector<T>& vec, const size_t offset, const size_t cou
   int h = 1;
 
   for (size_t i = offset; i < offset + count; i++) {
-    int n = *(int*)(&vec[i]);
+    int n = 0;
+    std::memcpy(&n, &vec[i], std::min(sizeof(T), sizeof(int)));
     h = 31 * h + n;
   }
 
@@ -271,4 +275,45 @@ inline int hash(const std::vector<T>& vec, const size_t offset, const size_t cou
   return h ^ (h >> 7) ^ (h >> 4);
 }
 
+/**
+ * @brief Calculates a 64-bit hash value of a block of memory.
+ *
+ * The hash is fast but not collision free, equal hashes should be followed by an equality check.
+ *
+ * @param data The data to hash.
+ * @param size The size of the data in bytes.
+ * @param seed The seed of the hash, i.e. the hash of the preceding data.
+ * @return The hash value.
+ */
+inline uint64_t hash64(const void* data, const size_t size, const uint64_t seed = 0)
+{
+  constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+  constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ size ^ seed;
+
+  for (size_t i = 0; i < size; i += 8) {
+    uint64_t k = 0;
+    std::memcpy(&k, bytes + i, std::min(size - i, size_t(8)));
+
+    k *= c1;
+    k = (k << 31) | (k >> 33);
+    k *= c2;
+
+    h ^= k;
+    h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+  }
+
+  /* Final avalanche of MurmurHash3. */
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+
+  return h;
+}
+
 }  // namespace graphick::math
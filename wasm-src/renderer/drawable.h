@@ -9,6 +9,7 @@
 
 #include "properties.h"
 
+#include "../math/mat2x3.h"
 #include "../math/rect.h"
 #include "../math/vec2.h"
 
@@ -17,59 +18,67 @@
 namespace graphick::renderer {
 
 enum class CurvesType : uint8_t {
-  None = 0,  // Treat as a fill
+  None = 0,       // Treat as a fill
   Quadratic = 1,
   Cubic = 2,
+  CubicHalf = 3,  // Cubic curves in the half precision curves texture, normalized per row.
 };
 
 /**
- * @brief Represents a vertex used by the tile shader (40 bytes).
+ * @brief Represents a tile drawn by the tile shader with instancing (48 bytes).
  *
+ * The four corners of the tile are expanded in the vertex stage, the texture coordinates used for
+ * painting are stored separately in TileTexCoords, because only texture paints need them.
  *
  * @note In attr 1, 7 bits for paint type are probably too much.
  * @note In attr_2, paint_coord is 10 bits instead of 8
  * @note In attr_3, there are a few wasted bits (16 bits is more than enough for both)
  */
-struct TileVertex {
-  vec2 position;          // | position.x (32) | position.y (32) |
-  uvec4 color;            // | color.rgba (32) |
-  vec2 tex_coord;         // | tex_coord.x (32) - tex_coord.y (32) |
-  vec2 tex_coord_curves;  // | tex_coord_curves.x (32) - tex_coord_curves.y (32) |
-  uint32_t attr_1;        // | blend (5) - paint_type (7) - curves_offset (20) |
-  uint32_t attr_2;        // | z_index (20) - curves_type (2) - is_eodd (1) - paint_coord (9) |
-  uint32_t attr_3;        // | winding (16) - curves_count (16) |
+struct TileInstance {
+  vec2 min;                   // | min.x (32) | min.y (32) |
+  vec2 max;                   // | max.x (32) | max.y (32) |
+  vec2 tex_coord_curves_min;  // | tex_coord_curves_min.x (32) - tex_coord_curves_min.y (32) |
+  vec2 tex_coord_curves_max;  // | tex_coord_curves_max.x (32) - tex_coord_curves_max.y (32) |
+  uvec4 color;                // | color.rgba (32) |
+  uint32_t attr_1;            // | blend (5) - paint_type (7) - curves_offset (20) |
+  uint32_t attr_2;            // | z_index (20) - curves_type (2) - is_eodd (1) - paint_coord (9) |
+  uint32_t attr_3;            // | winding (16) - curves_count (16) |
 
   /**
    * @brief Default constructor.
    */
-  TileVertex() = default;
+  TileInstance() = default;
 
   /**
-   * @brief Constructs a new TileVertex object.
+   * @brief Constructs a new TileInstance object.
    *
-   * @param position The position of the vertex.
-   * @param color The color of the vertex.
-   * @param tex_coord The texture coordinate used for painting, can be outside the range [0, 1].
-   * @param tex_coord_curves The texture coordinate used for rasterization, should be in the range
-   * [0, 1].
-   * @param attr_1 The attributes of the vertex, should be created using
-   * TileVertex::create_attr_1()
-   * @param attr_2 The attributes of the vertex, should be created using
-   * TileVertex::create_attr_2()
-   * @param attr_3 The attributes of the vertex, should be created using
-   * TileVertex::create_attr_3()
+   * @param min The minimum corner of the tile.
+   * @param max The maximum corner of the tile.
+   * @param tex_coord_curves_min The texture coordinate used for rasterization at the minimum
+   * corner.
+   * @param tex_coord_curves_max The texture coordinate used for rasterization at the maximum
+   * corner.
+   * @param color The color of the tile.
+   * @param attr_1 The attributes of the tile, should be created using
+   * TileInstance::create_attr_1()
+   * @param attr_2 The attributes of the tile, should be created using
+   * TileInstance::create_attr_2()
+   * @param attr_3 The attributes of the tile, should be created using
+   * TileInstance::create_attr_3()
    */
-  TileVertex(const vec2 position,
-             const uvec4 color,
-             const vec2 tex_coord,
-             const vec2 tex_coord_curves,
-             const uint32_t attr_1,
-             const uint32_t attr_2,
-             const uint32_t attr_3)
-      : position(position),
+  TileInstance(const vec2 min,
+               const vec2 max,
+               const vec2 tex_coord_curves_min,
+               const vec2 tex_coord_curves_max,
+               const uvec4 color,
+               const uint32_t attr_1,
+               const uint32_t attr_2,
+               const uint32_t attr_3)
+      : min(min),
+        max(max),
+        tex_coord_curves_min(tex_coord_curves_min),
+        tex_coord_curves_max(tex_coord_curves_max),
         color(color),
-        tex_coord(tex_coord),
-        tex_coord_curves(tex_coord_curves),
         attr_1(attr_1),
         attr_2(attr_2),
         attr_3(attr_3)
@@ -140,11 +149,15 @@ struct TileVertex {
   /**
    * @brief Adds an offset to the curves texture coordinates.
    *
-   * @param offset The offset to add.
+   * @param offset The offset to add if the curves are in the full precision texture.
+   * @param half_offset The offset to add if the curves are in the half precision texture.
    */
-  inline void add_offset_to_curves(const size_t offset)
+  inline void add_offset_to_curves(const size_t offset, const size_t half_offset)
   {
-    const uint32_t u_curves_offset = ((attr_1 & 0xFFFFFU) + offset) << 12 >> 12;
+    const bool is_half = ((attr_2 >> 10) & 0x3U) == static_cast<uint32_t>(CurvesType::CubicHalf);
+    const uint32_t u_curves_offset = ((attr_1 & 0xFFFFFU) + (is_half ? half_offset : offset))
+                                     << 12 >> 12;
+
     attr_1 = (attr_1 >> 20 << 20) | (u_curves_offset);
   }
 
@@ -169,6 +182,16 @@ struct TileVertex {
     attr_2 = (attr_2 << 20 >> 20) | (z_index << 12);
   }
 
+  /**
+   * @brief Gets the z-index of the tile.
+   *
+   * @return The z-index.
+   */
+  inline uint32_t z_index() const
+  {
+    return attr_2 >> 12;
+  }
+
   /**
    * @brief Updates the paint coordinate of the vertex.
    *
@@ -182,6 +205,18 @@ struct TileVertex {
   }
 };
 
+/**
+ * @brief Represents the texture coordinates used for painting a tile (24 bytes).
+ *
+ * The coordinates of a rectangle are an affine map of its corners, so the corner (max.x, max.y)
+ * is tex_coord + tex_coord_x + tex_coord_y.
+ */
+struct TileTexCoords {
+  vec2 tex_coord;    // The texture coordinate of the minimum corner.
+  vec2 tex_coord_x;  // The difference between the (max.x, min.y) corner and the minimum one.
+  vec2 tex_coord_y;  // The difference between the (min.x, max.y) corner and the minimum one.
+};
+
 /**
  * @brief Represents a vertex used by the fill shader (28 bytes).
  *
@@ -209,9 +244,9 @@ struct FillVertex {
    * @param color The color of the vertex.
    * @param tex_coord The texture coordinate used for painting, can be outside the range [0, 1].
    * @param attr_1 The attributes of the vertex, should be created using
-   * FillVertex::create_attr_1() or TileVertex::create_attr_1().
+   * FillVertex::create_attr_1() or TileInstance::create_attr_1().
    * @param attr_2 The attributes of the vertex, should be created using
-   * FillVertex::create_attr_2() or TileVertex::create_attr_2().
+   * FillVertex::create_attr_2() or TileInstance::create_attr_2().
    */
   FillVertex(const vec2 position,
              const uvec4 color,
@@ -265,6 +300,16 @@ struct FillVertex {
     attr_2 = (attr_2 << 20 >> 20) | (z_index << 12);
   }
 
+  /**
+   * @brief Gets the z-index of the vertex.
+   *
+   * @return The z-index.
+   */
+  inline uint32_t z_index() const
+  {
+    return attr_2 >> 12;
+  }
+
   /**
    * @brief Updates the paint coordinate of the vertex.
    *
@@ -304,18 +349,52 @@ struct DrawablePaintBinding {
  * @brief The Drawable class is the only object that can be directly drawn by the renderer.
  */
 struct Drawable {
-  uint8_t LOD;                               // The level of detail of the drawable.
-  drect bounding_rect;                       // The bounding rectangle of the drawable.
-  drect valid_rect;                          // The rect where the drawable is always valid.
+  uint8_t LOD;                                 // The level of detail of the drawable.
+  drect bounding_rect;                         // The bounding rectangle of the drawable.
+  drect valid_rect;                            // The rect where the drawable is always valid.
+
+  std::vector<vec2> curves;                    // The curves of the drawable.
+  std::vector<utils::half> half_curves;        // The half precision curves, xy pairs per point.
+  uint64_t curves_hash = 0;                    // The hash of the curves, to share them in a batch.
+
+  std::vector<TileInstance> tiles;             // The tiles of the drawable.
+  std::vector<TileTexCoords> tile_tex_coords;  // The paint coordinates of the tiles, if needed.
+  std::vector<FillVertex> fills;               // The fills of the drawable.
+
+  std::vector<DrawablePaintBinding> paints;    // The paint bindings of the drawable.
 
-  std::vector<vec2> curves;                  // The curves of the drawable.
+  Appearance appearance;                       // The appearance of the drawable.
 
-  std::vector<TileVertex> tiles;             // The tiles of the drawable.
-  std::vector<FillVertex> fills;             // The fills of the drawable.
+  mat2x3 transform;                            // The transform it was built or moved with.
+  double transform_error = 0.0;                // The error accumulated by moving the drawable.
+  double moved_scale = 1.0;                    // The scale applied by the moves since tiling.
 
-  std::vector<DrawablePaintBinding> paints;  // The paint bindings of the drawable.
+  uint64_t revision = 0;                       // Changed by the cache whenever the content does.
 
-  Appearance appearance;                     // The appearance of the drawable.
+  /**
+   * @brief Moves the drawable by a uniform scale followed by a translation.
+   *
+   * The curves are normalized to the tiles, so only the vertex positions and the rectangles change.
+   * The caller is responsible for updating transform and transform_error.
+   *
+   * @param scale The uniform scale factor, should be positive.
+   * @param translation The translation to apply after scaling.
+   */
+  inline void move(const double scale, const dvec2 translation)
+  {
+    for (TileInstance& tile : tiles) {
+      tile.min = vec2(dvec2(tile.min) * scale + translation);
+      tile.max = vec2(dvec2(tile.max) * scale + translation);
+    }
+
+    for (FillVertex& vertex : fills) {
+      vertex.position = vec2(dvec2(vertex.position) * scale + translation);
+    }
+
+    bounding_rect = drect(bounding_rect.min * scale + translation,
+                          bounding_rect.max * scale + translation);
+    valid_rect = drect(valid_rect.min * scale + translation, valid_rect.max * scale + translation);
+  }
 
   inline void push_curve(const vec2 p0, const vec2 p1, const vec2 p2)
   {
@@ -331,27 +410,27 @@ struct Drawable {
                         const vec2 max,
                         const vec2 tex_coord_curve_min,
                         const vec2 tex_coord_curve_max,
-                        const std::array<vec2, 4>& tex_coords,
                         const uvec4 color,
                         const uint32_t attr_1,
                         const uint32_t attr_2,
                         const uint32_t attr_3)
   {
-    const vec2 v0 = min;
-    const vec2 v1 = {max.x, min.y};
-    const vec2 v2 = max;
-    const vec2 v3 = {min.x, max.y};
-
-    const vec2 c0 = tex_coord_curve_min;
-    const vec2 c1 = {tex_coord_curve_max.x, tex_coord_curve_min.y};
-    const vec2 c2 = tex_coord_curve_max;
-    const vec2 c3 = {tex_coord_curve_min.x, tex_coord_curve_max.y};
+    tiles.emplace_back(
+        min, max, tex_coord_curve_min, tex_coord_curve_max, color, attr_1, attr_2, attr_3);
+  }
 
-    tiles.insert(tiles.end(),
-                 {TileVertex(v0, color, tex_coords[0], c0, attr_1, attr_2, attr_3),
-                  TileVertex(v1, color, tex_coords[1], c1, attr_1, attr_2, attr_3),
-                  TileVertex(v2, color, tex_coords[2], c2, attr_1, attr_2, attr_3),
-                  TileVertex(v3, color, tex_coords[3], c3, attr_1, attr_2, attr_3)});
+  /**
+   * @brief Sets the texture coordinates used for painting the last pushed tile.
+   *
+   * Only texture paints read them, so tiles before the last one without coordinates are padded.
+   *
+   * @param tex_coords The texture coordinates of the four corners of the tile.
+   */
+  inline void push_tile_tex_coords(const std::array<vec2, 4>& tex_coords)
+  {
+    tile_tex_coords.resize(tiles.size() - 1);
+    tile_tex_coords.push_back(
+        {tex_coords[0], tex_coords[1] - tex_coords[0], tex_coords[3] - tex_coords[0]});
   }
 
   inline void push_fill(const vec2 min,
@@ -0,0 +1,103 @@
+/**
+ * @file renderer/geometry.h
+ * @brief Contains the Geometry struct definition.
+ */
+
+#pragma once
+
+#include "../geom/cubic_path.h"
+#include "../geom/options.h"
+#include "../geom/path.h"
+#include "../geom/path_builder.h"
+
+#include "../math/mat2x3.h"
+#include "../math/rect.h"
+
+namespace graphick::renderer {
+
+/**
+ * @brief The render-ready geometry of a path, in scene space.
+ *
+ * It holds everything the tiler and the stroker need, so that retiling a path (i.e. when the LOD
+ * changes) doesn't require transforming and splitting it again.
+ */
+struct Geometry {
+  geom::dpath path;                   // The transformed path, only built for strokes and outlines.
+  geom::dcubic_multipath cubic_path;  // The closed monotonic cubic multipath, only built for fills.
+  drect bounding_rect;                // The exact bounding rectangle of the transformed path.
+
+  mat2x3 transform;                   // The transform applied to the path.
+  bool has_transform = false;         // Whether the transform is not the identity.
+
+  /**
+   * @brief Builds the missing representations of the path, with the transform of the geometry.
+   *
+   * The cubic multipath is streamed from the untransformed path in a single pass, without the
+   * intermediate transformed path.
+   *
+   * @param source The path of the element, in local space.
+   * @param cubic Whether the cubic multipath is needed.
+   * @param transformed Whether the transformed path is needed.
+   */
+  inline void build(const geom::path& source, const bool cubic, const bool transformed)
+  {
+    if (cubic && cubic_path.empty()) {
+      source.stream<double>(transform, cubic_path);
+    }
+
+    if (transformed && path.empty()) {
+      path = source.transformed<double>(transform);
+    }
+  }
+
+  /**
+   * @brief Returns the approximate number of bytes used by the geometry.
+   *
+   * @return The memory footprint of the geometry.
+   */
+  inline size_t memory() const
+  {
+    return sizeof(Geometry) + path.points_count() * sizeof(dvec2) + path.size() / 4 + 1 +
+           cubic_path.points.size() * sizeof(dvec2) + cubic_path.starts.size() * sizeof(size_t);
+  }
+};
+
+/**
+ * @brief The render-ready outline of a stroke, in scene space.
+ *
+ * The outline doesn't depend on the tile size, so it is reused when retiling (i.e. when the LOD
+ * changes) as long as the path, its transform and the stroking options are the same.
+ */
+struct StrokeGeometry {
+  geom::StrokeOutline<double> outline;    // The outline of the stroke and its bounding rectangle.
+  geom::StrokingOptions<double> options;  // The options used to stroke the path.
+  mat2x3 transform;                       // The transform applied to the stroked path.
+
+  /**
+   * @brief Checks whether the outline was built with the given transform and options.
+   *
+   * @param transform The transform of the path.
+   * @param options The stroking options.
+   * @return true if the outline can be reused, false otherwise.
+   */
+  inline bool matches(const mat2x3& transform, const geom::StrokingOptions<double>& options) const
+  {
+    return this->transform == transform && this->options.width == options.width &&
+           this->options.tolerance == options.tolerance &&
+           this->options.miter_limit == options.miter_limit && this->options.cap == options.cap &&
+           this->options.join == options.join;
+  }
+
+  /**
+   * @brief Returns the approximate number of bytes used by the outline.
+   *
+   * @return The memory footprint of the outline.
+   */
+  inline size_t memory() const
+  {
+    return sizeof(StrokeGeometry) + outline.path.points.size() * sizeof(dvec2) +
+           outline.path.starts.size() * sizeof(size_t);
+  }
+};
+
+}  // namespace graphick::renderer
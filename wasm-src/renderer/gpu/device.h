@@ -2,7 +2,8 @@
  * @file renderer/gpu/device.h
  * @brief Contains the main GPU device.
  *
- * Currently the only backend is OpenGL 3.0+, so everything falls back to that.
+ * The backend is OpenGL 3.0+ unless GK_SOFTWARE is defined, in which case rendering happens on the
+ * CPU through the software rasterizer in gpu/software.
  *
  * @note If later on we decide to add more backends, effort must be made to extract all platform
  * agnostic structs out of the gpu/gl directory.
@@ -10,7 +11,9 @@
 
 #pragma once
 
-#if defined(GK_GLES3) || defined(GK_GL3)
+#if defined(GK_SOFTWARE)
+#  include "software/sw_device.h"
+#elif defined(GK_GLES3) || defined(GK_GL3)
 #  include "opengl/gl_device.h"
 #else
 #  include "opengl/gl_device.h"
@@ -22,6 +25,10 @@ namespace graphick::renderer::GPU {
  * @brief The device is the main entry point for the GPU rendering. It is responsible for creating
  * and managing the GPU resources.
  */
+#if defined(GK_SOFTWARE)
+using Device = SW::SWDevice;
+#else
 using Device = GL::GLDevice;
+#endif
 
 }  // namespace graphick::renderer::GPU
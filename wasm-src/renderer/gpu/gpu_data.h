@@ -16,11 +16,12 @@
 namespace graphick::renderer::GPU {
 
 /**
- * @brief The version/dialect of OpenGL we should render with.
+ * @brief The version/dialect of OpenGL we should render with, or the software rasterizer.
  */
 enum class DeviceVersion {
-  GL3 = 0,    // OpenGL 3.0+, core profile.
-  GLES3 = 1,  // OpenGL ES 3.0+.
+  GL3 = 0,       // OpenGL 3.0+, core profile.
+  GLES3 = 1,     // OpenGL ES 3.0+.
+  Software = 2,  // CPU rasterizer, requires GK_SOFTWARE.
 };
 
 /**
@@ -3,11 +3,13 @@
  * @brief The file contains the implementation of the OpenGL GPU data.
  */
 
-#include "gl_data.h"
+#ifndef GK_SOFTWARE
 
-#include "opengl.h"
+#  include "gl_data.h"
 
-#include <utility>
+#  include "opengl.h"
+
+#  include <utility>
 
 namespace graphick::renderer::GPU::GL {
 
@@ -702,3 +704,5 @@ void GLBuffer::upload(const void* data, const size_t size, const size_t offset)
 }
 
 }  // namespace graphick::renderer::GPU::GL
+
+#endif
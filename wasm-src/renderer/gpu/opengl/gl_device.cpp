@@ -3,13 +3,15 @@
  * @brief The file contains the implementation of the OpenGL device.
  */
 
-#include "gl_device.h"
+#ifndef GK_SOFTWARE
 
-#include "opengl.h"
+#  include "gl_device.h"
 
-#include "../../../io/resource_manager.h"
+#  include "opengl.h"
 
-#include "../../../utils/console.h"
+#  include "../../../io/resource_manager.h"
+
+#  include "../../../utils/console.h"
 
 namespace graphick::renderer::GPU::GL {
 
@@ -94,7 +96,7 @@ inline static GLuint create_shader(
 
 /* -- Static member initialization -- */
 
-GLDevice* GLDevice::s_device = nullptr;
+thread_local GLDevice* GLDevice::s_device = nullptr;
 
 /* -- GLDevice -- */
 
@@ -158,16 +160,16 @@ GLDevice::~GLDevice()
 
 void GLDevice::begin_commands()
 {
-#ifndef EMSCRIPTEN
+#  ifndef EMSCRIPTEN
   glCall(glBeginQuery(GL_TIME_ELAPSED, s_device->m_timer_query));
-#endif
+#  endif
 }
 
 size_t GLDevice::end_commands()
 {
   glCall(glFlush());
 
-#ifndef EMSCRIPTEN
+#  ifndef EMSCRIPTEN
   glCall(glEndQuery(GL_TIME_ELAPSED));
 
   GLuint64 time;
@@ -175,9 +177,9 @@ size_t GLDevice::end_commands()
   glCall(glGetQueryObjectui64v(s_device->m_timer_query, GL_QUERY_RESULT, &time));
 
   return static_cast<size_t>(time);
-#else
+#  else
   return 0;
-#endif
+#  endif
 }
 
 void GLDevice::set_viewport(const irect viewport)
@@ -220,11 +222,11 @@ void GLDevice::clear(const ClearOps& ops)
     glCall(glDepthMask(GL_TRUE));
 
     if (ops.depth != s_device->m_state.clear_ops.depth) {
-#ifdef EMSCRIPTEN
+#  ifdef EMSCRIPTEN
       glCall(glClearDepthf(ops.depth.value()));
-#else
+#  else
       glCall(glClearDepth(ops.depth.value()));
-#endif
+#  endif
 
       s_device->m_state.clear_ops.depth = ops.depth.value();
     }
@@ -550,3 +552,5 @@ void GLDevice::set_render_state(const RenderState& render_state)
   }
 }
 }  // namespace graphick::renderer::GPU::GL
+
+#endif
@@ -289,6 +289,6 @@ class GLDevice {
 
   GLState m_state;                     // The current state.
  private:
-  static GLDevice* s_device;
+  static thread_local GLDevice* s_device;
 };
 }  // namespace graphick::renderer::GPU::GL
@@ -5,7 +5,9 @@
 
 #pragma once
 
-#if defined(GK_GLES3) || defined(GK_GL3)
+#if defined(GK_SOFTWARE)
+#  include "software/sw_data.h"
+#elif defined(GK_GLES3) || defined(GK_GL3)
 #  include "opengl/gl_data.h"
 #else
 #  include "opengl/gl_data.h"
@@ -15,6 +17,60 @@
 
 namespace graphick::renderer::GPU {
 
+#if defined(GK_SOFTWARE)
+
+/**
+ * @brief The program object.
+ */
+using Program = SW::SWProgram;
+
+/**
+ * @brief The uniform object.
+ */
+using Uniform = SW::SWUniform;
+
+/**
+ * @brief The texture uniform object.
+ */
+using TextureUniform = SW::SWTextureUniform;
+
+/**
+ * @brief The array of textures uniform object.
+ */
+using TexturesUniform = SW::SWTexturesUniform;
+
+/**
+ * @brief The vertex array object.
+ */
+using VertexArray = SW::SWVertexArray;
+
+/**
+ * @brief The vertex attribute object.
+ */
+using VertexAttribute = SW::SWVertexAttribute;
+
+/**
+ * @brief The texture object.
+ */
+using Texture = SW::SWTexture;
+
+/**
+ * @brief The framebuffer object.
+ */
+using Framebuffer = SW::SWFramebuffer;
+
+/**
+ * @brief The double framebuffer object.
+ */
+using DoubleFramebuffer = SW::SWDoubleFramebuffer;
+
+/**
+ * @brief The buffer object.
+ */
+using Buffer = SW::SWBuffer;
+
+#else
+
 /**
  * @brief The program object.
  */
@@ -65,6 +121,8 @@ using DoubleFramebuffer = GL::GLDoubleFramebuffer;
  */
 using Buffer = GL::GLBuffer;
 
+#endif
+
 /**
  * @brief A uniform binding is used to bind a uniform to a value.
  */
@@ -24,7 +24,8 @@ TileProgram::TileProgram()
       samples_uniform(Device::get_uniform(program, "u_samples")),
       curves_texture_uniform(Device::get_texture_uniform(program, "u_curves_texture")),
       textures_uniform(Device::get_textures_uniform(
-          program, "u_textures", Device::max_texture_image_units() - 2))
+          program, "u_textures", Device::max_texture_image_units() - 2)),
+      half_curves_texture_uniform(Device::get_texture_uniform(program, "u_half_curves_texture"))
 {
 }
 
@@ -61,39 +62,43 @@ DebugRectProgram::DebugRectProgram()
 
 TileVertexArray::TileVertexArray(const TileProgram& program,
                                  const Buffer& vertex_buffer,
-                                 const Buffer& index_buffer)
+                                 const Buffer& instance_buffer,
+                                 const Buffer& tex_coords_buffer)
 {
   VertexAttribute position_attr = Device::get_vertex_attribute(program.program, "a_position");
-  VertexAttribute color_attr = Device::get_vertex_attribute(program.program, "a_color");
-  VertexAttribute tex_coord_attr = Device::get_vertex_attribute(program.program, "a_tex_coord");
-  VertexAttribute tex_coord_curves_attr = Device::get_vertex_attribute(program.program,
-                                                                       "a_tex_coord_curves");
-  VertexAttribute first_attr = Device::get_vertex_attribute(program.program, "a_attr_1");
-  VertexAttribute second_attr = Device::get_vertex_attribute(program.program, "a_attr_2");
-  VertexAttribute third_attr = Device::get_vertex_attribute(program.program, "a_attr_3");
-
-  VertexAttrDescriptor position_desc = {
-      VertexAttrClass::Float, VertexAttrType::F32, 2, 40, 0, 0, 0};
-  VertexAttrDescriptor color_desc = {VertexAttrClass::Int, VertexAttrType::U8, 4, 40, 8, 0, 0};
-  VertexAttrDescriptor tex_coords_desc = {
-      VertexAttrClass::Float, VertexAttrType::F32, 2, 40, 12, 0, 0};
-  VertexAttrDescriptor tex_coords_curves_desc = {
-      VertexAttrClass::Float, VertexAttrType::F32, 2, 40, 20, 0, 0};
-  //   VertexAttrClass::Float, VertexAttrType::F16, 2, 40, 20, 0, 0};
-  VertexAttrDescriptor first_desc = {VertexAttrClass::Int, VertexAttrType::U32, 1, 40, 28, 0, 0};
-  VertexAttrDescriptor second_desc = {VertexAttrClass::Int, VertexAttrType::U32, 1, 40, 32, 0, 0};
-  VertexAttrDescriptor third_desc = {VertexAttrClass::Int, VertexAttrType::U32, 1, 40, 36, 0, 0};
+  VertexAttribute rect_attr = Device::get_vertex_attribute(program.program, "a_instance_rect");
+  VertexAttribute curves_rect_attr = Device::get_vertex_attribute(program.program,
+                                                                  "a_instance_curves_rect");
+  VertexAttribute color_attr = Device::get_vertex_attribute(program.program, "a_instance_color");
+  VertexAttribute attrs_attr = Device::get_vertex_attribute(program.program, "a_instance_attrs");
+  VertexAttribute tex_coord_attr = Device::get_vertex_attribute(program.program,
+                                                                "a_instance_tex_coord");
+  VertexAttribute tex_coord_axes_attr = Device::get_vertex_attribute(program.program,
+                                                                     "a_instance_tex_coord_axes");
 
-  index_buffer.bind(vertex_array);
+  VertexAttrDescriptor position_desc = {VertexAttrClass::Int, VertexAttrType::U8, 2, 2, 0, 0, 0};
+  VertexAttrDescriptor rect_desc = {VertexAttrClass::Float, VertexAttrType::F32, 4, 48, 0, 1, 1};
+  VertexAttrDescriptor curves_rect_desc = {
+      VertexAttrClass::Float, VertexAttrType::F32, 4, 48, 16, 1, 1};
+  VertexAttrDescriptor color_desc = {VertexAttrClass::Int, VertexAttrType::U8, 4, 48, 32, 1, 1};
+  VertexAttrDescriptor attrs_desc = {VertexAttrClass::Int, VertexAttrType::U32, 3, 48, 36, 1, 1};
+  VertexAttrDescriptor tex_coord_desc = {
+      VertexAttrClass::Float, VertexAttrType::F32, 2, 24, 0, 1, 2};
+  VertexAttrDescriptor tex_coord_axes_desc = {
+      VertexAttrClass::Float, VertexAttrType::F32, 4, 24, 8, 1, 2};
 
   vertex_buffer.bind(vertex_array);
   vertex_array.configure_attribute(position_attr, position_desc);
+
+  instance_buffer.bind(vertex_array);
+  vertex_array.configure_attribute(rect_attr, rect_desc);
+  vertex_array.configure_attribute(curves_rect_attr, curves_rect_desc);
   vertex_array.configure_attribute(color_attr, color_desc);
-  vertex_array.configure_attribute(tex_coord_attr, tex_coords_desc);
-  vertex_array.configure_attribute(tex_coord_curves_attr, tex_coords_curves_desc);
-  vertex_array.configure_attribute(first_attr, first_desc);
-  vertex_array.configure_attribute(second_attr, second_desc);
-  vertex_array.configure_attribute(third_attr, third_desc);
+  vertex_array.configure_attribute(attrs_attr, attrs_desc);
+
+  tex_coords_buffer.bind(vertex_array);
+  vertex_array.configure_attribute(tex_coord_attr, tex_coord_desc);
+  vertex_array.configure_attribute(tex_coord_axes_attr, tex_coord_axes_desc);
 }
 
 FillVertexArray::FillVertexArray(const FillProgram& program,
@@ -17,16 +17,17 @@ namespace graphick::renderer::GPU {
  * @brief The tile shader program.
  */
 struct TileProgram {
-  Program program;                        // The shader program.
+  Program program;                             // The shader program.
 
-  Uniform vp_uniform;                     // The view projection uniform.
-  Uniform samples_uniform;                // The antialiasing samples uniform.
+  Uniform vp_uniform;                          // The view projection uniform.
+  Uniform samples_uniform;                     // The antialiasing samples uniform.
 
-  TextureUniform curves_texture_uniform;  // The curves texture uniform (sampler2D), separate from
-                                          // the non float array.
-  TexturesUniform textures_uniform;       // The texture uniforms:
-                                          //  - [0] is the gradient texture
-                                          //  - [1...] are the image textures (or tiles textures).
+  TextureUniform curves_texture_uniform;       // The curves texture uniform (sampler2D),
+                                               // separate from the non float array.
+  TexturesUniform textures_uniform;            // The texture uniforms:
+                                               //  - [0] is the gradient texture
+                                               //  - [1...] are the image textures.
+  TextureUniform half_curves_texture_uniform;  // The half precision curves texture uniform.
 
   TileProgram();
 };
@@ -85,14 +86,15 @@ struct Programs {
 };
 
 /**
- * @brief Vertex array to use with TileProgram.
+ * @brief Vertex array to use with TileProgram, tiles are drawn with instancing.
  */
 struct TileVertexArray {
   VertexArray vertex_array;  // The vertex array.
 
   TileVertexArray(const TileProgram& program,
                   const Buffer& vertex_buffer,
-                  const Buffer& index_buffer);
+                  const Buffer& instance_buffer,
+                  const Buffer& tex_coords_buffer);
 };
 
 struct FillVertexArray {
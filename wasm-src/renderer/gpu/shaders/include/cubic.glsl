@@ -24,14 +24,22 @@ float calculate_cubic_root(float a, float b, float c, float d, float t0) {
   return t;
 }
 
-float cubic_horizontal_coverage(vec2 pixel_pos, float inv_pixel_size, uint curves_offset, uint curves_count) {
+float cubic_horizontal_coverage(vec2 pixel_pos, float inv_pixel_size, uint curves_offset, uint curves_count, bool is_half) {
   float coverage = 0.0;
 
   for (uint curve = 0U; curve < curves_count; curve++) {
     uint curve_offset = curves_offset + curve * 2U;
 
-    vec4 p01 = texture(u_curves_texture, to_coords(curve_offset));
-    vec4 p23 = texture(u_curves_texture, to_coords(curve_offset + 1U));
+    vec4 p01;
+    vec4 p23;
+
+    if (is_half) {
+      p01 = texture(u_half_curves_texture, to_coords(curve_offset));
+      p23 = texture(u_half_curves_texture, to_coords(curve_offset + 1U));
+    } else {
+      p01 = texture(u_curves_texture, to_coords(curve_offset));
+      p23 = texture(u_curves_texture, to_coords(curve_offset + 1U));
+    }
 
     vec2 p0 = p01.xy - pixel_pos;
     vec2 p1 = p01.zw - pixel_pos;
@@ -88,13 +96,14 @@ float cubic_coverage(int samples) {
 
   uint curves_offset = v_attr_1 & 0xFFFFFU;
   uint curves_count = v_attr_3 & 0xFFFFU;
+  bool is_half = ((v_attr_2 >> 10) & 0x3U) == 3U;
   
   float winding = float(int(v_attr_3 >> 16) - 32768);
 
   for (int offset = (1 - samples) / 2; offset <= (samples - 1) / 2; offset++) {
     vec2 sample_pos = v_tex_coord_curves + vec2(0.0, offset) * pixel_size.y / float(samples);
   
-    coverage += cubic_horizontal_coverage(sample_pos, 1.0 / pixel_size.x, curves_offset, curves_count);
+    coverage += cubic_horizontal_coverage(sample_pos, 1.0 / pixel_size.x, curves_offset, curves_count, is_half);
   }
 
   return winding * 0.00000000001 + coverage / float(samples);
@@ -5,6 +5,7 @@ precision mediump sampler2D;
 precision mediump usampler2D;
 
 uniform sampler2D u_curves_texture;
+uniform sampler2D u_half_curves_texture;
 uniform sampler2D u_textures[${MAX_TEXTURES}];
 
 uniform lowp int u_samples;
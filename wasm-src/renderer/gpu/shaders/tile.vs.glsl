@@ -5,13 +5,13 @@ R"(
 
   uniform highp mat4 u_view_projection;
 
-  in highp vec2 a_position;
-  in lowp uvec4 a_color;
-  in highp vec2 a_tex_coord;
-  in highp vec2 a_tex_coord_curves;
-  in highp uint a_attr_1;
-  in highp uint a_attr_2;
-  in highp uint a_attr_3;
+  in lowp uvec2 a_position;
+  in highp vec4 a_instance_rect;
+  in highp vec4 a_instance_curves_rect;
+  in lowp uvec4 a_instance_color;
+  in highp uvec3 a_instance_attrs;
+  in highp vec2 a_instance_tex_coord;
+  in highp vec4 a_instance_tex_coord_axes;
 
   out lowp vec4 v_color;
   out highp vec2 v_tex_coord;
@@ -22,17 +22,24 @@ R"(
   flat out highp uint v_attr_3;
 
   void main() {
-    uint z_index = a_attr_2 >> 12U;
-
-    gl_Position = u_view_projection * vec4(a_position, -float(int(z_index) - 524288) / 524288.0, 1.0);
-    
-    v_color = vec4(a_color) / 255.0;
-    v_tex_coord = a_tex_coord;
-    v_tex_coord_curves = a_tex_coord_curves;
-    
-    v_attr_1 = a_attr_1;
-    v_attr_2 = a_attr_2;
-    v_attr_3 = a_attr_3;
+    uint z_index = a_instance_attrs.y >> 12U;
+
+    vec2 corner = vec2(a_position);
+    bvec2 is_max = bvec2(a_position);
+
+    // Corners are selected, not interpolated, so adjacent tiles share their edges exactly.
+    vec2 position = mix(a_instance_rect.xy, a_instance_rect.zw, is_max);
+
+    gl_Position = u_view_projection * vec4(position, -float(int(z_index) - 524288) / 524288.0, 1.0);
+
+    v_color = vec4(a_instance_color) / 255.0;
+    v_tex_coord = a_instance_tex_coord + corner.x * a_instance_tex_coord_axes.xy +
+                  corner.y * a_instance_tex_coord_axes.zw;
+    v_tex_coord_curves = mix(a_instance_curves_rect.xy, a_instance_curves_rect.zw, is_max);
+
+    v_attr_1 = a_instance_attrs.x;
+    v_attr_2 = a_instance_attrs.y;
+    v_attr_3 = a_instance_attrs.z;
   }
 
 )"
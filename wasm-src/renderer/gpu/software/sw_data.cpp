@@ -0,0 +1,418 @@
+/**
+ * @file renderer/gpu/software/sw_data.cpp
+ * @brief The file contains the implementation of the software GPU data.
+ */
+
+#ifdef GK_SOFTWARE
+
+#  include "sw_data.h"
+
+#  include "sw_device.h"
+
+#  include "../../../math/vector.h"
+
+#  include "../../../utils/half.h"
+
+#  include <algorithm>
+#  include <cstring>
+#  include <utility>
+
+namespace graphick::renderer::GPU::SW {
+
+/* -- Static methods -- */
+
+/**
+ * @brief Returns the size of a texel of the given format in bytes.
+ *
+ * @param format The texture format.
+ * @return The number of bytes per texel.
+ */
+static constexpr size_t sw_texel_size(TextureFormat format)
+{
+  switch (format) {
+    case TextureFormat::R8:
+      return 1;
+    case TextureFormat::R16UI:
+    case TextureFormat::R16F:
+      return 2;
+    case TextureFormat::RGB8:
+      return 3;
+    case TextureFormat::RGBA8:
+    case TextureFormat::RGBA8UI:
+    case TextureFormat::R32F:
+      return 4;
+    case TextureFormat::RGBA16F:
+      return 8;
+    default:
+    case TextureFormat::RGBA32F:
+      return 16;
+  }
+}
+
+/**
+ * @brief Reads a half float from unaligned memory.
+ *
+ * @param data The address of the half float.
+ * @return The value converted to a float.
+ */
+static inline float read_half(const uint8_t* data)
+{
+  half value;
+  std::memcpy(&value.bits, data, sizeof(uint16_t));
+
+  return static_cast<float>(value);
+}
+
+/**
+ * @brief Wraps a texel coordinate with the given wrapping mode.
+ *
+ * @param x The texel coordinate.
+ * @param size The size of the texture along the coordinate axis.
+ * @param repeat Whether to repeat the texture, otherwise the coordinate is clamped to the edge.
+ * @return The wrapped coordinate.
+ */
+static inline int wrap(const int x, const int size, const bool repeat)
+{
+  if (repeat) {
+    const int r = x % size;
+    return r < 0 ? r + size : r;
+  }
+
+  return std::clamp(x, 0, size - 1);
+}
+
+/* -- SWVertexArray -- */
+
+SWVertexArray::SWVertexArray() : attributes(), vertex_buffer(nullptr), index_buffer(nullptr) {}
+
+void SWVertexArray::configure_attribute(const SWVertexAttribute attr,
+                                        const VertexAttrDescriptor& desc) const
+{
+  if (attr.attribute >= max_attributes) {
+    return;
+  }
+
+  attributes[attr.attribute] = SWVertexAttributeBinding{desc, vertex_buffer};
+}
+
+/* -- SWTexture -- */
+
+SWTexture::SWTexture(const TextureFormat format,
+                     const ivec2 size,
+                     const int sampling_flags,
+                     const void* data,
+                     [[maybe_unused]] const bool mipmaps)
+    : format(format),
+      data(new uint8_t[static_cast<size_t>(size.x) * size.y * sw_texel_size(format)]()),
+      size(size),
+      sampling_flags(sampling_flags)
+{
+  if (data) {
+    std::memcpy(
+        this->data.get(), data, static_cast<size_t>(size.x) * size.y * sw_texel_size(format));
+  }
+}
+
+void SWTexture::set_sampling_flags(const int flags)
+{
+  sampling_flags = flags;
+}
+
+void SWTexture::upload(const void* data, const irect region) const
+{
+  const size_t texel = texel_size();
+  const ivec2 origin = math::max(region.min, ivec2::zero());
+  const ivec2 end = math::min(region.max, size);
+
+  if (origin.x >= end.x || origin.y >= end.y) {
+    return;
+  }
+
+  const size_t src_stride = static_cast<size_t>(region.size().x) * texel;
+  const size_t row_size = static_cast<size_t>(end.x - origin.x) * texel;
+
+  const uint8_t* src = static_cast<const uint8_t*>(data) +
+                       static_cast<size_t>(origin.y - region.min.y) * src_stride +
+                       static_cast<size_t>(origin.x - region.min.x) * texel;
+
+  for (int y = origin.y; y < end.y; y++, src += src_stride) {
+    std::memcpy(
+        this->data.get() + (static_cast<size_t>(y) * size.x + origin.x) * texel, src, row_size);
+  }
+}
+
+void SWTexture::upload(const void* data, const size_t count, const size_t offset) const
+{
+  const size_t capacity = static_cast<size_t>(size.x) * size.y;
+
+  if (offset >= capacity) {
+    return;
+  }
+
+  const size_t texel = texel_size();
+
+  std::memcpy(this->data.get() + offset * texel, data, std::min(count, capacity - offset) * texel);
+}
+
+size_t SWTexture::texel_size() const
+{
+  return sw_texel_size(format);
+}
+
+vec4 SWTexture::fetch(const ivec2 coords) const
+{
+  const uint8_t* texel = data.get() +
+                         (static_cast<size_t>(coords.y) * size.x + coords.x) * texel_size();
+
+  switch (format) {
+    case TextureFormat::R8:
+      return vec4(texel[0] / 255.0f, 0.0f, 0.0f, 1.0f);
+    case TextureFormat::R16UI: {
+      uint16_t value;
+      std::memcpy(&value, texel, sizeof(uint16_t));
+
+      return vec4(static_cast<float>(value), 0.0f, 0.0f, 1.0f);
+    }
+    case TextureFormat::RGB8:
+      return vec4(texel[0] / 255.0f, texel[1] / 255.0f, texel[2] / 255.0f, 1.0f);
+    case TextureFormat::RGBA8:
+      return vec4(texel[0], texel[1], texel[2], texel[3]) / 255.0f;
+    case TextureFormat::RGBA8UI:
+      return vec4(texel[0], texel[1], texel[2], texel[3]);
+    case TextureFormat::R16F:
+      return vec4(read_half(texel), 0.0f, 0.0f, 1.0f);
+    case TextureFormat::R32F: {
+      float value;
+      std::memcpy(&value, texel, sizeof(float));
+
+      return vec4(value, 0.0f, 0.0f, 1.0f);
+    }
+    case TextureFormat::RGBA16F:
+      return vec4(
+          read_half(texel), read_half(texel + 2), read_half(texel + 4), read_half(texel + 6));
+    default:
+    case TextureFormat::RGBA32F: {
+      float value[4];
+      std::memcpy(value, texel, sizeof(value));
+
+      return vec4(value[0], value[1], value[2], value[3]);
+    }
+  }
+}
+
+vec4 SWTexture::sample(const vec2 tex_coord) const
+{
+  const bool repeat_u = sampling_flags & TextureSamplingFlagRepeatU;
+  const bool repeat_v = sampling_flags & TextureSamplingFlagRepeatV;
+
+  const vec2 uv = tex_coord * vec2(size);
+
+  /* Without mipmaps the level of detail is unknown, so the magnification filter is used. */
+  if (sampling_flags & TextureSamplingFlagNearestMag) {
+    return fetch({wrap(static_cast<int>(std::floor(uv.x)), size.x, repeat_u),
+                  wrap(static_cast<int>(std::floor(uv.y)), size.y, repeat_v)});
+  }
+
+  const float u = uv.x - 0.5f;
+  const float v = uv.y - 0.5f;
+  const float fu = std::floor(u);
+  const float fv = std::floor(v);
+  const float tu = u - fu;
+  const float tv = v - fv;
+
+  const int x0 = wrap(static_cast<int>(fu), size.x, repeat_u);
+  const int x1 = wrap(static_cast<int>(fu) + 1, size.x, repeat_u);
+  const int y0 = wrap(static_cast<int>(fv), size.y, repeat_v);
+  const int y1 = wrap(static_cast<int>(fv) + 1, size.y, repeat_v);
+
+  const vec4 bottom = math::lerp(fetch({x0, y0}), fetch({x1, y0}), tu);
+  const vec4 top = math::lerp(fetch({x0, y1}), fetch({x1, y1}), tu);
+
+  return math::lerp(bottom, top, tv);
+}
+
+/* -- Methods -- */
+
+void blit(const SWRenderTarget& src,
+          const SWRenderTarget& dst,
+          const irect src_rect,
+          const irect dst_rect,
+          const bool depth)
+{
+  const ivec2 src_size = src_rect.size();
+  const ivec2 dst_size = dst_rect.size();
+
+  if (src.color == nullptr || dst.color == nullptr || src_size.x <= 0 || src_size.y <= 0 ||
+      dst_size.x <= 0 || dst_size.y <= 0)
+  {
+    return;
+  }
+
+  const bool copy_depth = depth && src.depth != nullptr && dst.depth != nullptr;
+  const ivec2 min = math::max(dst_rect.min, ivec2::zero());
+  const ivec2 max = math::min(dst_rect.max, dst.size);
+
+  for (int y = min.y; y < max.y; y++) {
+    /* Nearest filtering samples the source at the center of each destination pixel. */
+    const int sy = src_rect.min.y + static_cast<int>((y - dst_rect.min.y + 0.5f) * src_size.y /
+                                                     dst_size.y);
+
+    if (sy < 0 || sy >= src.size.y) {
+      continue;
+    }
+
+    if (src_size.x == dst_size.x && src_rect.min.x >= 0 && src_rect.max.x <= src.size.x) {
+      const int sx = src_rect.min.x + (min.x - dst_rect.min.x);
+      const size_t src_offset = static_cast<size_t>(sy) * src.size.x + sx;
+      const size_t dst_offset = static_cast<size_t>(y) * dst.size.x + min.x;
+
+      std::memmove(dst.color + dst_offset * 4, src.color + src_offset * 4, (max.x - min.x) * 4);
+
+      if (copy_depth) {
+        std::memmove(
+            dst.depth + dst_offset, src.depth + src_offset, (max.x - min.x) * sizeof(float));
+      }
+
+      continue;
+    }
+
+    for (int x = min.x; x < max.x; x++) {
+      const int sx = src_rect.min.x + static_cast<int>((x - dst_rect.min.x + 0.5f) * src_size.x /
+                                                       dst_size.x);
+
+      if (sx < 0 || sx >= src.size.x) {
+        continue;
+      }
+
+      const size_t src_offset = static_cast<size_t>(sy) * src.size.x + sx;
+      const size_t dst_offset = static_cast<size_t>(y) * dst.size.x + x;
+
+      std::memcpy(dst.color + dst_offset * 4, src.color + src_offset * 4, 4);
+
+      if (copy_depth) {
+        dst.depth[dst_offset] = src.depth[src_offset];
+      }
+    }
+  }
+}
+
+/* -- SWFramebuffer -- */
+
+SWFramebuffer::SWFramebuffer(const ivec2 size, const bool has_depth)
+    : texture(TextureFormat::RGBA8, size, TextureSamplingFlagNone),
+      depth(has_depth ? static_cast<size_t>(size.x) * size.y : 0, 1.0f),
+      has_depth(has_depth),
+      complete(size.x > 0 && size.y > 0)
+{
+}
+
+SWFramebuffer::~SWFramebuffer()
+{
+  SWDevice::release_target(this);
+}
+
+SWRenderTarget SWFramebuffer::target() const
+{
+  return SWRenderTarget{
+      texture.data.get(), has_depth ? const_cast<float*>(depth.data()) : nullptr, texture.size};
+}
+
+void SWFramebuffer::bind() const
+{
+  SWDevice::bind_target(this, target());
+}
+
+void SWFramebuffer::unbind() const
+{
+  SWDevice::default_framebuffer();
+}
+
+/* -- SWDoubleFramebuffer -- */
+
+SWDoubleFramebuffer::SWDoubleFramebuffer(const ivec2 size, const bool has_depth)
+    : front_texture(TextureFormat::RGBA8, size, TextureSamplingFlagNone),
+      back_texture(TextureFormat::RGBA8, size, TextureSamplingFlagNone),
+      depth(has_depth ? static_cast<size_t>(size.x) * size.y : 0, 1.0f),
+      has_depth(has_depth),
+      complete(size.x > 0 && size.y > 0)
+{
+}
+
+SWDoubleFramebuffer::~SWDoubleFramebuffer()
+{
+  SWDevice::release_target(this);
+}
+
+void SWDoubleFramebuffer::swap()
+{
+  /* Swapping the textures keeps their storage, so the bound target still renders to the same
+   * texture, which is now the back one. */
+  std::swap(front_texture, back_texture);
+}
+
+void SWDoubleFramebuffer::blit_back_to_front() const
+{
+  const irect rect = {ivec2::zero(), size()};
+
+  SW::blit(target(back_texture), target(front_texture), rect, rect, false);
+  SWDevice::bind_target(this, target(front_texture));
+}
+
+void SWDoubleFramebuffer::blit() const
+{
+  const irect rect = {ivec2::zero(), size()};
+
+  SWDevice::default_framebuffer();
+  SW::blit(target(front_texture), SWDevice::bound_target(), rect, rect, false);
+}
+
+void SWDoubleFramebuffer::bind() const
+{
+  SWDevice::bind_target(this, target(front_texture));
+}
+
+void SWDoubleFramebuffer::unbind() const
+{
+  SWDevice::default_framebuffer();
+}
+
+SWRenderTarget SWDoubleFramebuffer::target(const SWTexture& texture) const
+{
+  return SWRenderTarget{
+      texture.data.get(), has_depth ? const_cast<float*>(depth.data()) : nullptr, texture.size};
+}
+
+/* -- SWBuffer -- */
+
+SWBuffer::SWBuffer(const BufferTarget target,
+                   const BufferUploadMode mode,
+                   const size_t size,
+                   const void* data)
+    : mode(mode), target(target), data(new uint8_t[size]()), size(size)
+{
+  if (data) {
+    std::memcpy(this->data.get(), data, size);
+  }
+}
+
+void SWBuffer::bind(const SWVertexArray& vertex_array) const
+{
+  if (target == BufferTarget::Index) {
+    vertex_array.index_buffer = this;
+  } else {
+    vertex_array.vertex_buffer = this;
+  }
+}
+
+void SWBuffer::upload(const void* data, const size_t size, const size_t offset) const
+{
+  if (offset >= this->size) {
+    return;
+  }
+
+  std::memcpy(this->data.get() + offset, data, std::min(size, this->size - offset));
+}
+
+}  // namespace graphick::renderer::GPU::SW
+
+#endif
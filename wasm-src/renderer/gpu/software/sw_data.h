@@ -0,0 +1,386 @@
+/**
+ * @file renderer/gpu/software/sw_data.h
+ * @brief The file contains the definition of the software GPU data.
+ *
+ * Resources live in main memory and mirror the OpenGL ones, so that the renderer can switch
+ * backend without changes. As in OpenGL, the state of a resource is owned by the device, which is
+ * why const handles can still be modified (i.e. uploading to a const buffer).
+ */
+
+#pragma once
+
+#include "../gpu_data.h"
+
+#include "../../../math/rect.h"
+
+#include <memory>
+#include <vector>
+
+namespace graphick::renderer::GPU::SW {
+
+/**
+ * @brief The programs the software device can run, each one is a port of the homonymous shaders.
+ */
+enum class SWProgramKind { None, Tile, Fill, Primitive, DebugRect };
+
+/**
+ * @brief The software uniform object.
+ */
+struct SWUniform {
+  int location;  // The index of the uniform in the uniform table of the device.
+
+  bool operator==(const SWUniform& other) const
+  {
+    return location == other.location;
+  }
+};
+
+/**
+ * @brief The software texture uniform object.
+ */
+struct SWTextureUniform {
+  SWUniform uniform;  // The uniform.
+  uint32_t unit;      // The texture unit.
+};
+
+/**
+ * @brief The software array of textures uniform object.
+ */
+struct SWTexturesUniform {
+  SWUniform uniform;            // The uniform.
+  std::vector<uint32_t> units;  // The texture units.
+};
+
+/**
+ * @brief The software program object.
+ */
+struct SWProgram {
+  SWProgramKind kind = SWProgramKind::None;  // The shaders to run.
+
+  std::vector<SWUniform> textures;           // Mapping from texture unit number to uniform.
+};
+
+/**
+ * @brief The software vertex attribute.
+ */
+struct SWVertexAttribute {
+  uint32_t attribute;  // The index of the attribute in the inputs of the vertex shader.
+};
+
+struct SWBuffer;
+
+/**
+ * @brief The source of a vertex attribute.
+ */
+struct SWVertexAttributeBinding {
+  VertexAttrDescriptor desc;  // The layout of the attribute.
+  const SWBuffer* buffer;     // The buffer to read from, nullptr if disabled.
+};
+
+/**
+ * @brief The software vertex array object.
+ */
+struct SWVertexArray {
+  static constexpr size_t max_attributes = 8;                   // The maximum attributes count.
+
+  mutable SWVertexAttributeBinding attributes[max_attributes];  // The attributes by location.
+
+  mutable const SWBuffer* vertex_buffer;                        // The last bound vertex buffer.
+  mutable const SWBuffer* index_buffer;                         // The index buffer, or nullptr.
+
+  SWVertexArray();
+  ~SWVertexArray() = default;
+
+  /**
+   * @brief Binds the vertex array, the vertex array is passed to draw calls through the render
+   * state so this is a no-op.
+   */
+  void bind() const {}
+
+  /**
+   * @brief Unbinds the vertex array, no-op.
+   */
+  void unbind() const {}
+
+  /**
+   * @brief Configures the given vertex attribute to read from the last bound vertex buffer.
+   *
+   * @param attr The attribute to configure.
+   * @param desc The attribute descriptor.
+   */
+  void configure_attribute(const SWVertexAttribute attr, const VertexAttrDescriptor& desc) const;
+};
+
+/**
+ * @brief The software texture object.
+ *
+ * Rows are stored from the bottom to the top of the image, as in OpenGL, and mipmaps are not
+ * generated: textures are always sampled from the base level.
+ */
+struct SWTexture {
+  TextureFormat format;             // The texture format.
+  std::unique_ptr<uint8_t[]> data;  // The texels, in the layout of the format.
+  ivec2 size;                       // The size of the texture.
+
+  int sampling_flags;               // The texture sampling flags.
+
+  SWTexture(const TextureFormat format,
+            const ivec2 size,
+            const int sampling_flags = TextureSamplingFlagNone,
+            const void* data = nullptr,
+            const bool mipmaps = false);
+  ~SWTexture() = default;
+
+  SWTexture(const SWTexture&) = delete;
+  SWTexture& operator=(const SWTexture&) = delete;
+
+  SWTexture(SWTexture&& other) noexcept = default;
+  SWTexture& operator=(SWTexture&& other) noexcept = default;
+
+  /**
+   * @brief Binds the texture, textures are passed to draw calls through the render state so this
+   * is a no-op.
+   *
+   * @param unit The texture unit to bind the texture to.
+   */
+  void bind([[maybe_unused]] uint32_t unit) const {}
+
+  /**
+   * @brief Unbinds the texture, no-op.
+   *
+   * @param unit The texture unit to unbind the texture from.
+   */
+  void unbind([[maybe_unused]] uint32_t unit) const {}
+
+  /**
+   * @brief Sets the texture sampling flags.
+   *
+   * @param sampling_flags The sampling flags to set.
+   */
+  void set_sampling_flags(const int flags);
+
+  /**
+   * @brief Uploads the data to the texture.
+   *
+   * @param data The data to upload.
+   * @param region The region to upload the data to.
+   */
+  void upload(const void* data, const irect region) const;
+
+  /**
+   * @brief Uploads the data to the texture, treating it as a 1D buffer.
+   *
+   * @param data The data to upload.
+   * @param count The number of pixels to upload.
+   * @param offset The offset to upload the data to.
+   */
+  void upload(const void* data, const size_t count, const size_t offset = 0) const;
+
+  /**
+   * @brief Returns the size of a texel in bytes.
+   *
+   * @return The number of bytes per texel.
+   */
+  size_t texel_size() const;
+
+  /**
+   * @brief Reads a texel, normalized formats are converted to the [0, 1] range.
+   *
+   * @param coords The coordinates of the texel, they must be inside the texture.
+   * @return The RGBA value of the texel, missing channels are 0 (alpha is 1).
+   */
+  vec4 fetch(const ivec2 coords) const;
+
+  /**
+   * @brief Samples the texture with the filtering and wrapping modes of its sampling flags.
+   *
+   * @param tex_coord The normalized texture coordinates.
+   * @return The filtered RGBA value.
+   */
+  vec4 sample(const vec2 tex_coord) const;
+};
+
+/**
+ * @brief The memory a draw call renders into.
+ */
+struct SWRenderTarget {
+  uint8_t* color = nullptr;  // The RGBA8 pixels, rows from bottom to top.
+  float* depth = nullptr;    // The depth values, nullptr if there is no depth buffer.
+  ivec2 size;                // The size of the target in pixels.
+};
+
+/**
+ * @brief Copies a region of a render target to another one, scaling it with nearest filtering.
+ *
+ * @param src The source target.
+ * @param dst The destination target.
+ * @param src_rect The source rectangle.
+ * @param dst_rect The destination rectangle.
+ * @param depth Whether to copy the depth values too, if both targets have them.
+ */
+void blit(const SWRenderTarget& src,
+          const SWRenderTarget& dst,
+          const irect src_rect,
+          const irect dst_rect,
+          const bool depth);
+
+/**
+ * @brief The software framebuffer object.
+ */
+struct SWFramebuffer {
+  SWTexture texture;         // The texture to render to.
+  std::vector<float> depth;  // The depth buffer, empty if the framebuffer has no depth.
+
+  bool has_depth;            // Whether the framebuffer has a depth buffer.
+  bool complete;             // Whether the framebuffer was successfully created.
+
+  SWFramebuffer(const ivec2 size, const bool has_depth);
+  ~SWFramebuffer();
+
+  SWFramebuffer(const SWFramebuffer&) = delete;
+  SWFramebuffer& operator=(const SWFramebuffer&) = delete;
+
+  SWFramebuffer(SWFramebuffer&& other) noexcept = default;
+  SWFramebuffer& operator=(SWFramebuffer&& other) noexcept = default;
+
+  /**
+   * @brief Returns the size of the framebuffer.
+   *
+   * @return The size of the framebuffer.
+   */
+  inline ivec2 size() const
+  {
+    return texture.size;
+  }
+
+  /**
+   * @brief Returns the memory of the framebuffer.
+   *
+   * @return The render target of the framebuffer.
+   */
+  SWRenderTarget target() const;
+
+  /**
+   * @brief Binds the framebuffer.
+   */
+  void bind() const;
+
+  /**
+   * @brief Unbinds the framebuffer.
+   */
+  void unbind() const;
+};
+
+/**
+ * @brief The software double framebuffer object.
+ */
+struct SWDoubleFramebuffer {
+  SWTexture front_texture;   // The front framebuffer texture.
+  SWTexture back_texture;    // The back framebuffer texture.
+  std::vector<float> depth;  // The shared depth buffer, empty if there is no depth.
+
+  bool has_depth;            // Whether the framebuffer has a depth buffer.
+  bool complete;             // Whether the framebuffer was successfully created.
+
+  SWDoubleFramebuffer(const ivec2 size, const bool has_depth = true);
+  ~SWDoubleFramebuffer();
+
+  SWDoubleFramebuffer(const SWDoubleFramebuffer&) = delete;
+  SWDoubleFramebuffer& operator=(const SWDoubleFramebuffer&) = delete;
+
+  SWDoubleFramebuffer(SWDoubleFramebuffer&& other) noexcept = default;
+  SWDoubleFramebuffer& operator=(SWDoubleFramebuffer&& other) noexcept = default;
+
+  /**
+   * @brief Returns the size of the framebuffer.
+   *
+   * @return The size of the framebuffer.
+   */
+  inline ivec2 size() const
+  {
+    return front_texture.size;
+  }
+
+  /**
+   * @brief Swaps the front and back framebuffers.
+   *
+   * As in OpenGL, the bound framebuffer keeps rendering to the same texture.
+   */
+  void swap();
+
+  /**
+   * @brief Blits the back framebuffer to the front framebuffer, leaving the front one bound.
+   */
+  void blit_back_to_front() const;
+
+  /**
+   * @brief Blits the front framebuffer to the default one, leaving the default one bound.
+   */
+  void blit() const;
+
+  /**
+   * @brief Binds the front framebuffer.
+   */
+  void bind() const;
+
+  /**
+   * @brief Unbinds the framebuffers.
+   */
+  void unbind() const;
+
+ private:
+  /**
+   * @brief Returns the memory of one of the two framebuffers.
+   *
+   * @param texture The color texture of the framebuffer.
+   * @return The render target.
+   */
+  SWRenderTarget target(const SWTexture& texture) const;
+};
+
+/**
+ * @brief The software buffer object.
+ */
+struct SWBuffer {
+  BufferUploadMode mode;            // The buffer upload mode.
+  BufferTarget target;              // The buffer target.
+  std::unique_ptr<uint8_t[]> data;  // The content of the buffer.
+  size_t size;                      // The size of the buffer in bytes.
+
+  SWBuffer(const BufferTarget target,
+           const BufferUploadMode mode,
+           const size_t size,
+           const void* data = nullptr);
+  ~SWBuffer() = default;
+
+  /**
+   * @brief Binds the buffer, no-op.
+   */
+  void bind() const {}
+
+  /**
+   * @brief Binds the buffer to a vertex array.
+   *
+   * Index buffers become the index buffer of the vertex array, vertex buffers are used by the
+   * attributes configured afterwards.
+   *
+   * @param vertex_array The vertex array to bind the buffer to.
+   */
+  void bind(const SWVertexArray& vertex_array) const;
+
+  /**
+   * @brief Unbinds the buffer, no-op.
+   */
+  void unbind() const {}
+
+  /**
+   * @brief Uploads the data to the buffer.
+   *
+   * @param data The data to upload.
+   * @param size The size of the data in bytes.
+   * @param offset The offset to upload the data to.
+   */
+  void upload(const void* data, const size_t size, const size_t offset = 0) const;
+};
+
+}  // namespace graphick::renderer::GPU::SW
@@ -0,0 +1,438 @@
+/**
+ * @file renderer/gpu/software/sw_device.cpp
+ * @brief The file contains the implementation of the software device.
+ */
+
+#ifdef GK_SOFTWARE
+
+#  include "sw_device.h"
+
+#  include "../../renderer_settings.h"
+
+#  include "../../../utils/console.h"
+
+#  include <algorithm>
+#  include <chrono>
+#  include <cstring>
+
+namespace graphick::renderer::GPU::SW {
+
+/* -- Static member initialization -- */
+
+thread_local SWDevice* SWDevice::s_device = nullptr;
+
+/* -- SWDevice -- */
+
+void SWDevice::init(const DeviceVersion version)
+{
+  if (s_device != nullptr) {
+    console::error("Device already initialized, call shutdown() before reinitializing!");
+    return;
+  }
+
+  if (version != DeviceVersion::Software) {
+    console::error("Invalid device version, try using a different version!");
+    return;
+  }
+
+  s_device = new SWDevice();
+}
+
+void SWDevice::shutdown()
+{
+  if (s_device == nullptr) {
+    console::error("Device already shutdown, call init() before shutting down!");
+    return;
+  }
+
+  delete s_device;
+  s_device = nullptr;
+}
+
+SWDevice::SWDevice()
+    : m_uniforms(static_cast<size_t>(SWProgramKind::DebugRect) + 1),
+      m_color_mask{true, true, true, true},
+      m_target_owner(nullptr),
+      m_default_size(ivec2::zero()),
+      m_rasterizer(std::make_unique<SWRasterizer>(
+          std::min(utils::JobSystem::default_workers_count(), RendererSettings::max_workers))),
+      m_commands_time(0)
+{
+  console::info("Initializing Device:");
+
+  m_device_name = "CPU (" + std::to_string(m_rasterizer->concurrency()) + " threads)";
+  m_backend_name = "Software";
+
+  console::info("  Device Name", m_device_name);
+  console::info("  Backend Name", m_backend_name);
+
+  m_state.viewport = irect{ivec2::zero(), ivec2::zero()};
+  m_state.program = SWProgram{};
+  m_state.vertex_array = nullptr;
+
+  console::info("Device Initialized!");
+}
+
+/**
+ * @brief Returns the current time of a monotonic clock.
+ *
+ * @return The time in nanoseconds.
+ */
+static inline int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void SWDevice::begin_commands()
+{
+  s_device->m_commands_time = 0;
+}
+
+size_t SWDevice::end_commands()
+{
+  return static_cast<size_t>(s_device->m_commands_time);
+}
+
+void SWDevice::set_viewport(const irect viewport)
+{
+  if (s_device->m_target_owner == nullptr && viewport.max != s_device->m_default_size) {
+    s_device->resize_default_framebuffer(viewport.max);
+  }
+
+  s_device->m_state.viewport = viewport;
+}
+
+void SWDevice::set_color_mask(const bool red, const bool green, const bool blue, const bool alpha)
+{
+  s_device->m_color_mask[0] = red;
+  s_device->m_color_mask[1] = green;
+  s_device->m_color_mask[2] = blue;
+  s_device->m_color_mask[3] = alpha;
+}
+
+void SWDevice::clear(const ClearOps& ops)
+{
+  const SWRenderTarget& target = s_device->m_target;
+  const size_t pixels = static_cast<size_t>(target.size.x) * target.size.y;
+
+  if (ops.color.has_value() && target.color != nullptr) {
+    const vec4 color = math::min(math::max(ops.color.value(), vec4::zero()), vec4(1.0f)) *
+                       255.0f;
+    const uint8_t rgba[4] = {static_cast<uint8_t>(color.r + 0.5f),
+                             static_cast<uint8_t>(color.g + 0.5f),
+                             static_cast<uint8_t>(color.b + 0.5f),
+                             static_cast<uint8_t>(color.a + 0.5f)};
+
+    /* As in the OpenGL device, clearing the color buffer resets the color mask. */
+    set_color_mask(true, true, true, true);
+
+    for (size_t i = 0; i < pixels; i++) {
+      std::memcpy(target.color + i * 4, rgba, 4);
+    }
+
+    s_device->m_state.clear_ops.color = ops.color.value();
+  }
+
+  if (ops.depth.has_value() && target.depth != nullptr) {
+    std::fill(target.depth, target.depth + pixels, ops.depth.value());
+
+    s_device->m_state.clear_ops.depth = ops.depth.value();
+  }
+}
+
+SWProgram SWDevice::create_program(
+    const std::string& name,
+    [[maybe_unused]] const std::vector<std::pair<std::string, std::string>>& variables)
+{
+  const SWProgramInfo* info = program_info(name);
+
+  if (info == nullptr) {
+    console::error("Program " + name + " has no software implementation");
+    return SWProgram{};
+  }
+
+  return SWProgram{info->kind, {}};
+}
+
+SWUniform SWDevice::get_uniform(const SWProgram& program, const std::string& name)
+{
+  const SWProgramInfo* info = program_info(program.kind);
+
+  if (info != nullptr) {
+    for (const SWUniformLocation location : info->uniforms) {
+      if (name == uniform_name(location)) {
+        return SWUniform{static_cast<int>(location)};
+      }
+    }
+  }
+
+  console::error("Uniform " + name + " not found in program!");
+
+  return SWUniform{0};
+}
+
+SWTextureUniform SWDevice::get_texture_uniform(SWProgram& program, const std::string& name)
+{
+  SWUniform uniform = get_uniform(program, name);
+  uint32_t unit;
+
+  auto it = std::find(program.textures.begin(), program.textures.end(), uniform);
+
+  if (it != program.textures.end()) {
+    unit = static_cast<uint32_t>(std::distance(program.textures.begin(), it));
+  } else {
+    unit = static_cast<uint32_t>(program.textures.size());
+    program.textures.push_back(uniform);
+  }
+
+  return SWTextureUniform{uniform, unit};
+}
+
+SWTexturesUniform SWDevice::get_textures_uniform(SWProgram& program,
+                                                 const std::string& name,
+                                                 const size_t count)
+{
+  SWUniform uniform = get_uniform(program, name);
+  std::vector<uint32_t> units(count);
+
+  for (uint32_t i = 0; i < units.size(); i++) {
+    units[i] = static_cast<uint32_t>(program.textures.size());
+    program.textures.push_back(uniform);
+  }
+
+  return SWTexturesUniform{uniform, units};
+}
+
+SWVertexAttribute SWDevice::get_vertex_attribute(const SWProgram& program, const std::string& name)
+{
+  const SWProgramInfo* info = program_info(program.kind);
+
+  if (info != nullptr) {
+    for (size_t i = 0; i < info->attributes.size(); i++) {
+      if (info->attributes[i] == name) {
+        return SWVertexAttribute{static_cast<uint32_t>(i)};
+      }
+    }
+  }
+
+  console::error("Attribute " + name + " not found in program!");
+
+  return SWVertexAttribute{0};
+}
+
+void SWDevice::draw_elements(const size_t index_count, const RenderState& render_state)
+{
+  s_device->draw(render_state, index_count, 1, true);
+}
+
+void SWDevice::draw_arrays(const size_t vertex_count, const RenderState& render_state)
+{
+  s_device->draw(render_state, vertex_count, 1, false);
+}
+
+void SWDevice::draw_arrays_instanced(const size_t vertex_count,
+                                     const size_t instance_count,
+                                     const RenderState& render_state)
+{
+  s_device->draw(render_state, vertex_count, instance_count, false);
+}
+
+void SWDevice::default_framebuffer()
+{
+  s_device->m_target_owner = nullptr;
+  s_device->m_target = SWRenderTarget{s_device->m_default_color.data(),
+                                      s_device->m_default_depth.data(),
+                                      s_device->m_default_size};
+}
+
+void SWDevice::blit_framebuffer(const SWFramebuffer& src,
+                                const irect src_rect,
+                                const irect dst_rect,
+                                const bool reverse)
+{
+  const int64_t start = now_ns();
+
+  default_framebuffer();
+
+  if (reverse) {
+    blit(s_device->m_target, src.target(), dst_rect, src_rect, src.has_depth);
+  } else {
+    blit(src.target(), s_device->m_target, src_rect, dst_rect, src.has_depth);
+  }
+
+  s_device->m_commands_time += now_ns() - start;
+}
+
+void SWDevice::blit_framebuffer(const SWFramebuffer& src,
+                                const SWFramebuffer& dst,
+                                const irect src_rect,
+                                const irect dst_rect)
+{
+  const int64_t start = now_ns();
+
+  blit(src.target(), dst.target(), src_rect, dst_rect, src.has_depth && dst.has_depth);
+
+  s_device->m_commands_time += now_ns() - start;
+}
+
+void SWDevice::read_pixels(const irect region, uint8_t* data)
+{
+  const SWRenderTarget& target = s_device->m_target;
+  const ivec2 size = region.size();
+
+  for (int y = 0; y < size.y; y++) {
+    for (int x = 0; x < size.x; x++) {
+      const ivec2 pixel = region.min + ivec2(x, y);
+      uint8_t* dst = data + (static_cast<size_t>(y) * size.x + x) * 4;
+
+      if (target.color == nullptr || pixel.x < 0 || pixel.y < 0 || pixel.x >= target.size.x ||
+          pixel.y >= target.size.y)
+      {
+        std::memset(dst, 0, 4);
+      } else {
+        const size_t offset = static_cast<size_t>(pixel.y) * target.size.x + pixel.x;
+        std::memcpy(dst, target.color + offset * 4, 4);
+      }
+    }
+  }
+}
+
+void SWDevice::bind_target(const void* owner, const SWRenderTarget& target)
+{
+  s_device->m_target_owner = owner;
+  s_device->m_target = target;
+}
+
+void SWDevice::release_target(const void* owner)
+{
+  if (s_device != nullptr && s_device->m_target_owner == owner) {
+    default_framebuffer();
+  }
+}
+
+SWRenderTarget SWDevice::bound_target()
+{
+  return s_device->m_target;
+}
+
+void SWDevice::resize_default_framebuffer(const ivec2 size)
+{
+  const size_t pixels = static_cast<size_t>(std::max(size.x, 0)) * std::max(size.y, 0);
+
+  m_default_size = math::max(size, ivec2::zero());
+  m_default_color.assign(pixels * 4, 0);
+  m_default_depth.assign(pixels, 1.0f);
+
+  default_framebuffer();
+}
+
+void SWDevice::set_uniforms(SWUniforms& values, const std::vector<UniformBinding>& uniforms)
+{
+  for (const auto& [uniform, data] : uniforms) {
+    switch (static_cast<SWUniformLocation>(uniform.location)) {
+      case SWUniformLocation::ViewProjection:
+        if (const mat4* value = std::get_if<mat4>(&data)) {
+          values.view_projection = *value;
+        }
+        break;
+      case SWUniformLocation::Samples:
+        if (const int* value = std::get_if<int>(&data)) {
+          values.samples = *value;
+        } else if (const uint32_t* value = std::get_if<uint32_t>(&data)) {
+          values.samples = static_cast<int>(*value);
+        }
+        break;
+      case SWUniformLocation::Zoom:
+        if (const float* value = std::get_if<float>(&data)) {
+          values.zoom = *value;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void SWDevice::set_textures(SWUniforms& values, const std::vector<TextureBinding>& textures)
+{
+  for (const auto& [texture_uniform, texture] : textures) {
+    switch (static_cast<SWUniformLocation>(texture_uniform.uniform.location)) {
+      case SWUniformLocation::CurvesTexture:
+        values.curves_texture = texture;
+        break;
+      case SWUniformLocation::HalfCurvesTexture:
+        values.half_curves_texture = texture;
+        break;
+      case SWUniformLocation::Texture:
+        values.texture = texture;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void SWDevice::set_texture_arrays(SWUniforms& values,
+                                  const std::vector<TextureArrayBinding>& texture_arrays)
+{
+  for (const auto& [textures_uniform, textures] : texture_arrays) {
+    if (static_cast<SWUniformLocation>(textures_uniform.uniform.location) ==
+        SWUniformLocation::Textures)
+    {
+      values.textures.assign(textures.begin(), textures.end());
+    }
+  }
+}
+
+void SWDevice::draw(const RenderState& render_state,
+                    const size_t vertex_count,
+                    const size_t instance_count,
+                    const bool indexed)
+{
+  const int64_t start = now_ns();
+
+  set_viewport(render_state.viewport);
+  clear(render_state.clear_ops);
+
+  /* Uniforms keep their values between draw calls, as they are part of the program state. */
+  SWUniforms& uniforms = m_uniforms[static_cast<size_t>(render_state.program.kind)];
+
+  m_state.program = render_state.program;
+  m_state.vertex_array = render_state.vertex_array;
+  m_state.primitive = render_state.primitive;
+  m_state.blend = render_state.blend;
+  m_state.depth = render_state.depth;
+
+  set_uniforms(uniforms, render_state.uniforms);
+  set_textures(uniforms, render_state.textures);
+  set_texture_arrays(uniforms, render_state.texture_arrays);
+
+  const SWProgramInfo* program = program_info(render_state.program.kind);
+
+  if (program == nullptr || render_state.vertex_array == nullptr || m_target.color == nullptr ||
+      vertex_count == 0 || instance_count == 0)
+  {
+    m_commands_time += now_ns() - start;
+    return;
+  }
+
+  SWPipeline pipeline{program,
+                      &uniforms,
+                      render_state.vertex_array,
+                      render_state.primitive,
+                      m_target,
+                      render_state.viewport,
+                      render_state.blend,
+                      render_state.depth,
+                      {m_color_mask[0], m_color_mask[1], m_color_mask[2], m_color_mask[3]}};
+
+  m_rasterizer->draw(pipeline, vertex_count, instance_count, indexed);
+
+  m_commands_time += now_ns() - start;
+}
+
+}  // namespace graphick::renderer::GPU::SW
+
+#endif
@@ -0,0 +1,357 @@
+/**
+ * @file renderer/gpu/software/sw_device.h
+ * @brief The file contains the definition of the software GPU device.
+ */
+
+#pragma once
+
+#include "sw_rasterizer.h"
+
+#include "../render_state.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace graphick::renderer::GPU::SW {
+
+/**
+ * @brief The software render state
+ */
+struct SWState : public RenderState {
+  SWState() : RenderState() {}
+};
+
+/**
+ * @brief The class that represents the software GPU device.
+ *
+ * The device renders into main memory on the CPU, so it can be used where no GPU context is
+ * available (i.e. headless rendering, tests, servers). The default framebuffer is an in-memory
+ * RGBA8 image sized by the viewport, its content can be read back with read_pixels().
+ */
+class SWDevice {
+ public:
+  /**
+   * @brief This class is a singleton, so every public constructor/destructor is deleted.
+   */
+  SWDevice(const SWDevice&) = delete;
+  SWDevice(SWDevice&&) = delete;
+  SWDevice& operator=(const SWDevice&) = delete;
+  SWDevice& operator=(SWDevice&&) = delete;
+
+  /**
+   * @brief Initializes the device with the given version.
+   *
+   * @param version Backend version to initialize the device with, must be DeviceVersion::Software.
+   */
+  static void init(const DeviceVersion version);
+
+  /**
+   * @brief Shuts down the device.
+   *
+   * It is necessary to call this method before reinitializing the device.
+   */
+  static void shutdown();
+
+  /**
+   * @brief Returns the current backend name.
+   *
+   * @return The backend name.
+   */
+  inline static const std::string& backend_name()
+  {
+    return s_device->m_backend_name;
+  }
+
+  /**
+   * @brief Returns the current device name.
+   *
+   * @return The device name.
+   */
+  inline static const std::string& device_name()
+  {
+    return s_device->m_device_name;
+  }
+
+  /**
+   * @brief Gets the maximum number of vertex uniform vectors.
+   *
+   * @return The maximum number of vertex uniform vectors.
+   */
+  inline static size_t max_vertex_uniform_vectors()
+  {
+    return 1024;
+  }
+
+  /**
+   * @brief Gets the maximum number of texture image units in the fragment shader.
+   *
+   * @return The maximum number of texture image units.
+   */
+  inline static size_t max_texture_image_units()
+  {
+    return 16;
+  }
+
+  /**
+   * @brief Prepares the device to execute commands.
+   */
+  static void begin_commands();
+
+  /**
+   * @brief Finishes the commands.
+   *
+   * @return The time spent executing the commands (draw calls and blits) in nanoseconds.
+   */
+  static size_t end_commands();
+
+  /**
+   * @brief Sets the viewport size.
+   *
+   * If the default framebuffer is bound, it is resized to contain the viewport.
+   *
+   * @param viewport The new viewport.
+   */
+  static void set_viewport(const irect viewport);
+
+  /**
+   * @brief Sets the color mask.
+   *
+   * @param red Whether to enable red color channel.
+   * @param green Whether to enable green color channel.
+   * @param blue Whether to enable blue color channel.
+   * @param alpha Whether to enable alpha color channel.
+   */
+  static void set_color_mask(const bool red, const bool green, const bool blue, const bool alpha);
+
+  /**
+   * @brief Clears the current render target, the stencil buffer is not supported.
+   *
+   * @param ops The clear operations.
+   */
+  static void clear(const ClearOps& ops);
+
+  /**
+   * @brief Creates a new shader program.
+   *
+   * Shaders are C++ ports of the GLSL ones, so variables are ignored: the texture cases are
+   * resolved at runtime.
+   *
+   * @param name The name of the program
+   * @return The new program.
+   */
+  static SWProgram create_program(
+      const std::string& name,
+      const std::vector<std::pair<std::string, std::string>>& variables = {});
+
+  /**
+   * @brief Queries the location of the uniform with the given name in the given program.
+   *
+   * @param program The program to search the uniform location into.
+   * @param name The uniform name to query.
+   * @return The location of the given uniform.
+   */
+  static SWUniform get_uniform(const SWProgram& program, const std::string& name);
+
+  /**
+   * @brief Creates a new texture uniform.
+   *
+   * @param program The program to create the texture uniform for.
+   * @param name The name of the texture uniform.
+   * @return The new texture uniform.
+   */
+  static SWTextureUniform get_texture_uniform(SWProgram& program, const std::string& name);
+
+  /**
+   * @brief Creates a new array of textures uniform.
+   *
+   * @param program The program to create the textures uniform for.
+   * @param name The name of the textures uniform.
+   * @return The new textures uniform.
+   */
+  static SWTexturesUniform get_textures_uniform(SWProgram& program,
+                                                const std::string& name,
+                                                const size_t count);
+
+  /**
+   * @brief Queries the location of the attribute with the given name in the given program.
+   *
+   * @param program The program to search the attribute location into.
+   * @param name The attribute name to query.
+   * @return The location of the given attribute.
+   */
+  static SWVertexAttribute get_vertex_attribute(const SWProgram& program, const std::string& name);
+
+  /**
+   * @brief Draws the binded index array with the given index count.
+   *
+   * @param index_count The number of indices to draw.
+   * @param render_state The render state to use.
+   */
+  static void draw_elements(const size_t index_count, const RenderState& render_state);
+
+  /**
+   * @brief Draws the binded vertex array.
+   *
+   * @param vertex_count The number of vertices to draw.
+   * @param render_state The render state to use.
+   */
+  static void draw_arrays(const size_t vertex_count, const RenderState& render_state);
+
+  /**
+   * @brief Draws the binded vertex array with instancing.
+   *
+   * @param vertex_count The number of vertices to draw.
+   * @param instance_count The number of instances to draw.
+   * @param render_state The render state to use.
+   */
+  static void draw_arrays_instanced(const size_t vertex_count,
+                                    const size_t instance_count,
+                                    const RenderState& render_state);
+
+  /**
+   * @brief Binds the default framebuffer.
+   */
+  static void default_framebuffer();
+
+  /**
+   * @brief Blits the given framebuffer to the default framebuffer.
+   *
+   * @param src The source framebuffer.
+   * @param src_rect The source rectangle.
+   * @param dst_rect The destination rectangle.
+   * @param reverse Whether to reverse the blit (default framebuffer to provided framebuffer).
+   */
+  static void blit_framebuffer(const SWFramebuffer& src,
+                               const irect src_rect,
+                               const irect dst_rect,
+                               const bool reverse);
+
+  /**
+   * @brief Blits the given source framebuffer to the destination framebuffer.
+   *
+   * @param src The source framebuffer.
+   * @param dst The destination framebuffer.
+   * @param src_rect The source rectangle.
+   * @param dst_rect The destination rectangle.
+   */
+  static void blit_framebuffer(const SWFramebuffer& src,
+                               const SWFramebuffer& dst,
+                               const irect src_rect,
+                               const irect dst_rect);
+
+  /**
+   * @brief Reads the RGBA8 pixels of the bound render target, as glReadPixels() does.
+   *
+   * Rows are written from the bottom to the top of the region, pixels outside of the target are
+   * transparent black.
+   *
+   * @param region The region to read.
+   * @param data The output buffer, it must hold region.area() * 4 bytes.
+   */
+  static void read_pixels(const irect region, uint8_t* data);
+
+ private:
+  /**
+   * @brief SWDevice constructor.
+   */
+  SWDevice();
+
+  /**
+   * @brief SWDevice destructor.
+   */
+  ~SWDevice() = default;
+
+  /**
+   * @brief Sets the memory the next draw calls render into.
+   *
+   * @param owner The framebuffer that owns the memory.
+   * @param target The memory to render into.
+   */
+  static void bind_target(const void* owner, const SWRenderTarget& target);
+
+  /**
+   * @brief Binds the default framebuffer if the given framebuffer is bound, called when a
+   * framebuffer is destroyed.
+   *
+   * @param owner The framebuffer being destroyed.
+   */
+  static void release_target(const void* owner);
+
+  /**
+   * @brief Returns the memory of the bound framebuffer.
+   *
+   * @return The bound render target.
+   */
+  static SWRenderTarget bound_target();
+
+  /**
+   * @brief Resizes the default framebuffer, discarding its content.
+   *
+   * @param size The new size.
+   */
+  void resize_default_framebuffer(const ivec2 size);
+
+  /**
+   * @brief Sets the given uniforms to the correct values.
+   *
+   * @param values The uniform values of the program.
+   * @param uniforms The uniforms to set.
+   */
+  static void set_uniforms(SWUniforms& values, const std::vector<UniformBinding>& uniforms);
+
+  /**
+   * @brief Binds the given textures to their uniforms.
+   *
+   * @param values The uniform values of the program.
+   * @param textures The textures to set.
+   */
+  static void set_textures(SWUniforms& values, const std::vector<TextureBinding>& textures);
+
+  /**
+   * @brief Binds the given texture arrays to their uniforms.
+   *
+   * @param values The uniform values of the program.
+   * @param texture_arrays The texture arrays to set.
+   */
+  static void set_texture_arrays(SWUniforms& values,
+                                 const std::vector<TextureArrayBinding>& texture_arrays);
+
+  /**
+   * @brief Updates the render state and executes a draw call.
+   *
+   * @param render_state The render state to use.
+   * @param vertex_count The number of vertices (or indices) to draw.
+   * @param instance_count The number of instances to draw.
+   * @param indexed Whether to draw through the index buffer of the vertex array.
+   */
+  void draw(const RenderState& render_state,
+            const size_t vertex_count,
+            const size_t instance_count,
+            const bool indexed);
+
+ private:
+  friend struct SWFramebuffer;
+  friend struct SWDoubleFramebuffer;
+ private:
+  std::string m_backend_name;                  // The backend name.
+  std::string m_device_name;                   // The device name.
+
+  SWState m_state;                             // The current state.
+  std::vector<SWUniforms> m_uniforms;          // The values of the uniforms, by program kind.
+  bool m_color_mask[4];                        // The current color mask.
+
+  const void* m_target_owner;                  // The bound framebuffer, nullptr if default.
+  SWRenderTarget m_target;                     // The memory of the bound framebuffer.
+
+  std::vector<uint8_t> m_default_color;        // The pixels of the default framebuffer.
+  std::vector<float> m_default_depth;          // The depth buffer of the default framebuffer.
+  ivec2 m_default_size;                        // The size of the default framebuffer.
+
+  std::unique_ptr<SWRasterizer> m_rasterizer;  // The rasterizer that executes draw calls.
+
+  int64_t m_commands_time;                     // Time spent executing commands, in nanoseconds.
+ private:
+  static thread_local SWDevice* s_device;
+};
+}  // namespace graphick::renderer::GPU::SW
@@ -0,0 +1,876 @@
+/**
+ * @file renderer/gpu/software/sw_rasterizer.cpp
+ * @brief The file contains the implementation of the software rasterizer.
+ */
+
+#ifdef GK_SOFTWARE
+
+#  include "sw_rasterizer.h"
+
+#  include "../../../math/vector.h"
+
+#  include "../../../utils/half.h"
+
+#  include <algorithm>
+#  include <cmath>
+#  include <cstring>
+
+namespace graphick::renderer::GPU::SW {
+
+/* -- Static methods -- */
+
+/**
+ * @brief Returns the size of a vertex attribute component in bytes.
+ *
+ * @param type The vertex attribute type.
+ * @return The size of a component.
+ */
+static constexpr size_t sw_component_size(VertexAttrType type)
+{
+  switch (type) {
+    case VertexAttrType::I8:
+    case VertexAttrType::U8:
+      return 1;
+    case VertexAttrType::F16:
+    case VertexAttrType::I16:
+    case VertexAttrType::U16:
+      return 2;
+    default:
+    case VertexAttrType::F32:
+    case VertexAttrType::I32:
+    case VertexAttrType::U32:
+      return 4;
+  }
+}
+
+/**
+ * @brief Reads a vertex attribute component, converting it as the attribute class requires.
+ *
+ * @param data The address of the component.
+ * @param desc The layout of the attribute.
+ * @param value The attribute value to write the component into.
+ * @param component The index of the component.
+ */
+static void fetch_component(const uint8_t* data,
+                            const VertexAttrDescriptor& desc,
+                            SWAttributeValue& value,
+                            const size_t component)
+{
+  double number;
+  double norm = 1.0;
+
+  switch (desc.attr_type) {
+    case VertexAttrType::F16: {
+      half h;
+      std::memcpy(&h.bits, data, sizeof(uint16_t));
+      number = static_cast<float>(h);
+      break;
+    }
+    case VertexAttrType::F32: {
+      float f;
+      std::memcpy(&f, data, sizeof(float));
+      number = f;
+      break;
+    }
+    case VertexAttrType::I8: {
+      number = *reinterpret_cast<const int8_t*>(data);
+      norm = 127.0;
+      break;
+    }
+    case VertexAttrType::I16: {
+      int16_t i;
+      std::memcpy(&i, data, sizeof(int16_t));
+      number = i;
+      norm = 32767.0;
+      break;
+    }
+    case VertexAttrType::I32: {
+      int32_t i;
+      std::memcpy(&i, data, sizeof(int32_t));
+      number = i;
+      norm = 2147483647.0;
+      break;
+    }
+    case VertexAttrType::U8: {
+      number = *data;
+      norm = 255.0;
+      break;
+    }
+    case VertexAttrType::U16: {
+      uint16_t u;
+      std::memcpy(&u, data, sizeof(uint16_t));
+      number = u;
+      norm = 65535.0;
+      break;
+    }
+    default:
+    case VertexAttrType::U32: {
+      uint32_t u;
+      std::memcpy(&u, data, sizeof(uint32_t));
+      number = u;
+      norm = 4294967295.0;
+      break;
+    }
+  }
+
+  switch (desc.attr_class) {
+    case VertexAttrClass::Int:
+      value.u[component] = static_cast<uint32_t>(static_cast<int64_t>(number));
+      break;
+    case VertexAttrClass::FloatNorm:
+      value.f[component] = static_cast<float>(std::max(number / norm, -1.0));
+      break;
+    default:
+    case VertexAttrClass::Float:
+      value.f[component] = static_cast<float>(number);
+      break;
+  }
+}
+
+/**
+ * @brief Reads a vertex attribute, missing components default to (0, 0, 0, 1) as in OpenGL.
+ *
+ * @param binding The source of the attribute.
+ * @param vertex The index of the vertex.
+ * @param instance The index of the instance.
+ * @param value The attribute value to write.
+ */
+static void fetch_attribute(const SWVertexAttributeBinding& binding,
+                            const size_t vertex,
+                            const size_t instance,
+                            SWAttributeValue& value)
+{
+  const VertexAttrDescriptor& desc = binding.desc;
+  const bool is_int = binding.buffer != nullptr && desc.attr_class == VertexAttrClass::Int;
+
+  if (is_int) {
+    value.u[0] = value.u[1] = value.u[2] = 0;
+    value.u[3] = 1;
+  } else {
+    value.f[0] = value.f[1] = value.f[2] = 0.0f;
+    value.f[3] = 1.0f;
+  }
+
+  if (binding.buffer == nullptr) {
+    return;
+  }
+
+  const size_t index = desc.divisor ? instance / desc.divisor : vertex;
+  const size_t component_size = sw_component_size(desc.attr_type);
+  const size_t components = std::min<size_t>(desc.size, 4);
+  const size_t offset = desc.offset + index * desc.stride;
+
+  if (offset + components * component_size > binding.buffer->size) {
+    return;
+  }
+
+  const uint8_t* data = binding.buffer->data.get() + offset;
+
+  for (size_t i = 0; i < components; i++) {
+    fetch_component(data + i * component_size, desc, value, i);
+  }
+}
+
+/**
+ * @brief Integer division rounding towards negative infinity.
+ *
+ * @param n The numerator.
+ * @param d The denominator, must be positive.
+ * @return The floor of n / d.
+ */
+static inline int64_t floor_div(const int64_t n, const int64_t d)
+{
+  return n >= 0 ? n / d : -((-n + d - 1) / d);
+}
+
+/**
+ * @brief Clips a convex polygon against an axis aligned half plane.
+ *
+ * @param in The vertices of the polygon.
+ * @param in_size The number of vertices of the polygon.
+ * @param out The vertices of the clipped polygon.
+ * @param axis The axis of the half plane, 0 for x and 1 for y.
+ * @param value The position of the half plane along the axis.
+ * @param keep_less Whether to keep the side with smaller coordinates.
+ * @return The number of vertices of the clipped polygon.
+ */
+static size_t clip_polygon(const dvec2* in,
+                           const size_t in_size,
+                           dvec2* out,
+                           const int axis,
+                           const double value,
+                           const bool keep_less)
+{
+  size_t out_size = 0;
+
+  for (size_t i = 0; i < in_size; i++) {
+    const dvec2 a = in[i];
+    const dvec2 b = in[(i + 1) % in_size];
+
+    const double da = keep_less ? value - a[axis] : a[axis] - value;
+    const double db = keep_less ? value - b[axis] : b[axis] - value;
+
+    if (da >= 0.0) {
+      out[out_size++] = a;
+    }
+
+    if ((da >= 0.0) != (db >= 0.0)) {
+      out[out_size++] = a + (b - a) * (da / (da - db));
+    }
+  }
+
+  return out_size;
+}
+
+/**
+ * @brief Returns a blend factor for each lane.
+ *
+ * @param factor The blend factor.
+ * @param src_alpha The alpha of the source color.
+ * @param dst_alpha The alpha of the destination color.
+ * @param dst The destination channel the factor multiplies.
+ * @return The value of the factor.
+ */
+static inline f32x4 blend_factor(const BlendFactor factor,
+                                 const f32x4 src_alpha,
+                                 const f32x4 dst_alpha,
+                                 const f32x4 dst)
+{
+  switch (factor) {
+    case BlendFactor::Zero:
+      return f32x4(0.0f);
+    case BlendFactor::One:
+      return f32x4(1.0f);
+    case BlendFactor::SrcAlpha:
+      return src_alpha;
+    case BlendFactor::OneMinusSrcAlpha:
+      return f32x4(1.0f) - src_alpha;
+    case BlendFactor::DestAlpha:
+      return dst_alpha;
+    case BlendFactor::OneMinusDestAlpha:
+      return f32x4(1.0f) - dst_alpha;
+    default:
+    case BlendFactor::DestColor:
+      return dst;
+  }
+}
+
+/**
+ * @brief Blends a source and a destination channel.
+ *
+ * @param op The blend operation.
+ * @param src The weighted source channel.
+ * @param dst The weighted destination channel.
+ * @return The blended channel.
+ */
+static inline f32x4 blend_op(const BlendOp op, const f32x4 src, const f32x4 dst)
+{
+  switch (op) {
+    case BlendOp::Add:
+      return src + dst;
+    case BlendOp::Subtract:
+      return src - dst;
+    case BlendOp::ReverseSubtract:
+      return dst - src;
+    case BlendOp::Min:
+      return min(src, dst);
+    default:
+    case BlendOp::Max:
+      return max(src, dst);
+  }
+}
+
+/**
+ * @brief Compares the fragment depths with the depth buffer.
+ *
+ * @param func The depth function.
+ * @param z The depths of the fragments.
+ * @param depth The values in the depth buffer.
+ * @return The fragments that pass the test.
+ */
+static inline m32x4 depth_test(const DepthFunc func, const f32x4 z, const f32x4 depth)
+{
+  switch (func) {
+    case DepthFunc::Less:
+      return z < depth;
+    case DepthFunc::Greater:
+      return z > depth;
+    case DepthFunc::Gequal:
+      return z >= depth;
+    case DepthFunc::Always:
+      return m32x4::from_bits(0xF);
+    default:
+    case DepthFunc::Lequal:
+      return z <= depth;
+  }
+}
+
+/* -- SWRasterizer -- */
+
+void SWRasterizer::draw(const SWPipeline& pipeline,
+                        const size_t vertex_count,
+                        const size_t instance_count,
+                        const bool indexed)
+{
+  const size_t primitive_size = pipeline.primitive == Primitive::Lines ? 2 : 3;
+
+  if (indexed) {
+    const SWBuffer* index_buffer = pipeline.vertex_array->index_buffer;
+
+    if (index_buffer == nullptr) {
+      return;
+    }
+
+    const size_t count = std::min(vertex_count, index_buffer->size / sizeof(uint16_t)) /
+                         primitive_size * primitive_size;
+    const uint16_t* indices = reinterpret_cast<const uint16_t*>(index_buffer->data.get());
+
+    m_indices.assign(indices, indices + count);
+
+    const uint32_t max_index = m_indices.empty() ?
+                                   0 :
+                                   *std::max_element(m_indices.begin(), m_indices.end());
+
+    shade_vertices(pipeline, max_index + 1, 1);
+  } else {
+    const size_t primitives_per_instance = vertex_count / primitive_size;
+
+    m_indices.resize(primitives_per_instance * primitive_size * instance_count);
+
+    for (size_t instance = 0, i = 0; instance < instance_count; instance++) {
+      for (size_t v = 0; v < primitives_per_instance * primitive_size; v++, i++) {
+        m_indices[i] = static_cast<uint32_t>(instance * vertex_count + v);
+      }
+    }
+
+    shade_vertices(pipeline, vertex_count, instance_count);
+  }
+
+  const size_t primitives_count = m_indices.size() / primitive_size;
+
+  if (primitives_count == 0) {
+    return;
+  }
+
+  m_primitives.resize(primitives_count);
+  m_polygons.resize(primitives_count);
+
+  const size_t chunk_size = 256;
+
+  m_jobs.parallel_for((primitives_count + chunk_size - 1) / chunk_size,
+                      [&](const size_t chunk, const size_t) {
+                        const size_t end = std::min(primitives_count, (chunk + 1) * chunk_size);
+
+                        for (size_t i = chunk * chunk_size; i < end; i++) {
+                          setup(pipeline,
+                                m_indices.data() + i * primitive_size,
+                                m_primitives[i],
+                                m_polygons[i]);
+                        }
+                      });
+
+  const irect viewport = {math::max(pipeline.viewport.min, ivec2::zero()),
+                          math::min(pipeline.viewport.max, pipeline.target.size)};
+
+  if (viewport.min.x >= viewport.max.x || viewport.min.y >= viewport.max.y) {
+    return;
+  }
+
+  bin(viewport);
+
+  m_jobs.parallel_for(static_cast<size_t>(m_bins_count.x) * m_bins_count.y,
+                      [&](const size_t bin, const size_t) {
+                        const uint32_t start = m_bin_starts[bin];
+                        const uint32_t end = m_bin_starts[bin + 1];
+
+                        if (start == end) {
+                          return;
+                        }
+
+                        const ivec2 bin_min = viewport.min +
+                                              ivec2(static_cast<int>(bin % m_bins_count.x),
+                                                    static_cast<int>(bin / m_bins_count.x)) *
+                                                  bin_size;
+                        const irect bin_rect = {bin_min,
+                                                math::min(bin_min + bin_size, viewport.max)};
+
+                        for (uint32_t i = start; i < end; i++) {
+                          const uint32_t p = m_bin_primitives[i];
+                          const SWPrimitive& primitive = m_primitives[p];
+                          const irect rect = {math::max(primitive.bounds.min, bin_rect.min),
+                                              math::min(primitive.bounds.max, bin_rect.max)};
+
+                          if (primitive.line) {
+                            rasterize_line(pipeline, primitive, m_polygons[p], rect);
+                          } else {
+                            rasterize_polygon(pipeline, primitive, m_polygons[p], rect);
+                          }
+                        }
+                      });
+}
+
+void SWRasterizer::shade_vertices(const SWPipeline& pipeline,
+                                  const size_t vertex_count,
+                                  const size_t instance_count)
+{
+  const SWProgramInfo* program = pipeline.program;
+  const size_t attributes_count = std::min(program->attributes.size(),
+                                           SWVertexArray::max_attributes);
+  const size_t count = vertex_count * instance_count;
+  const size_t chunk_size = 256;
+
+  m_vertices.resize(count);
+
+  m_jobs.parallel_for(
+      (count + chunk_size - 1) / chunk_size, [&](const size_t chunk, const size_t) {
+        SWAttributeValue inputs[SWVertexArray::max_attributes];
+
+        const size_t end = std::min(count, (chunk + 1) * chunk_size);
+
+        for (size_t i = chunk * chunk_size; i < end; i++) {
+          const size_t vertex = i % vertex_count;
+          const size_t instance = i / vertex_count;
+
+          for (size_t a = 0; a < attributes_count; a++) {
+            fetch_attribute(pipeline.vertex_array->attributes[a], vertex, instance, inputs[a]);
+          }
+
+          m_vertices[i] = program->vertex(inputs, *pipeline.uniforms);
+        }
+      });
+}
+
+void SWRasterizer::setup(const SWPipeline& pipeline,
+                         const uint32_t* vertices,
+                         SWPrimitive& primitive,
+                         Polygon& polygon) const
+{
+  const bool line = pipeline.primitive == Primitive::Lines;
+  const size_t size = line ? 2 : 3;
+  const size_t varyings_count = pipeline.program->varyings_count;
+  const double subpixel = static_cast<double>(1 << subpixel_bits);
+
+  const dvec2 viewport_min = dvec2(pipeline.viewport.min);
+  const dvec2 viewport_size = dvec2(pipeline.viewport.size());
+
+  const SWVertex* v[3];
+
+  dvec2 window[3];
+  double depth[3];
+
+  polygon.size = 0;
+  primitive.line = line;
+  primitive.bounds = {ivec2::zero(), ivec2::zero()};
+
+  for (size_t i = 0; i < size; i++) {
+    v[i] = &m_vertices[vertices[i]];
+
+    const vec4 position = v[i]->position;
+
+    /* Only orthographic projections are used by the renderer, so near plane clipping is not
+     * needed: primitives behind the camera are discarded. */
+    if (!(position.w > 0.0f)) {
+      return;
+    }
+
+    const dvec2 ndc = dvec2(position.x, position.y) / static_cast<double>(position.w);
+
+    window[i] = (ndc + 1.0) * 0.5 * viewport_size + viewport_min;
+    depth[i] = position.z / static_cast<double>(position.w) * 0.5 + 0.5;
+
+    if (!std::isfinite(window[i].x) || !std::isfinite(window[i].y)) {
+      return;
+    }
+  }
+
+  /* The provoking vertex is the last one, as in OpenGL. */
+  std::memcpy(primitive.flats, v[size - 1]->flats, sizeof(primitive.flats));
+
+  const dvec2 clip_min = dvec2(math::max(pipeline.viewport.min, ivec2::zero())) - 1.0;
+  const dvec2 clip_max = dvec2(math::min(pipeline.viewport.max, pipeline.target.size)) + 1.0;
+
+  dvec2 min = window[0];
+  dvec2 max = window[0];
+
+  for (size_t i = 1; i < size; i++) {
+    min = math::min(min, window[i]);
+    max = math::max(max, window[i]);
+  }
+
+  const irect bounds = {
+      math::max(ivec2(static_cast<int>(std::floor(std::max(min.x, clip_min.x))),
+                      static_cast<int>(std::floor(std::max(min.y, clip_min.y)))),
+                math::max(pipeline.viewport.min, ivec2::zero())),
+      math::min(ivec2(static_cast<int>(std::ceil(std::min(max.x, clip_max.x))) + 1,
+                      static_cast<int>(std::ceil(std::min(max.y, clip_max.y))) + 1),
+                math::min(pipeline.viewport.max, pipeline.target.size))};
+
+  if (bounds.min.x >= bounds.max.x || bounds.min.y >= bounds.max.y) {
+    return;
+  }
+
+  const dvec2 origin = dvec2(bounds.min);
+
+  double ddx[SWVertex::max_varyings + 1];
+  double ddy[SWVertex::max_varyings + 1];
+
+  /* The depth is interpolated as an additional varying. */
+  auto value = [&](const size_t vertex, const size_t i) {
+    return i < varyings_count ? static_cast<double>(v[vertex]->varyings[i]) : depth[vertex];
+  };
+
+  if (line) {
+    const dvec2 d = window[1] - window[0];
+    const double length_squared = math::squared_length(d);
+
+    if (length_squared == 0.0) {
+      return;
+    }
+
+    for (size_t i = 0; i <= varyings_count; i++) {
+      const double delta = (value(1, i) - value(0, i)) / length_squared;
+
+      ddx[i] = delta * d.x;
+      ddy[i] = delta * d.y;
+    }
+
+    for (size_t i = 0; i < 2; i++) {
+      polygon.x[i] = static_cast<int32_t>(std::llround(window[i].x * subpixel));
+      polygon.y[i] = static_cast<int32_t>(std::llround(window[i].y * subpixel));
+    }
+
+    polygon.size = 2;
+  } else {
+    const dvec2 e1 = window[1] - window[0];
+    const dvec2 e2 = window[2] - window[0];
+    const double det = e1.x * e2.y - e2.x * e1.y;
+
+    if (det == 0.0) {
+      return;
+    }
+
+    for (size_t i = 0; i <= varyings_count; i++) {
+      const double d1 = value(1, i) - value(0, i);
+      const double d2 = value(2, i) - value(0, i);
+
+      ddx[i] = (d1 * e2.y - d2 * e1.y) / det;
+      ddy[i] = (d2 * e1.x - d1 * e2.x) / det;
+    }
+
+    dvec2 points[max_polygon_size + 1] = {window[0], window[1], window[2]};
+    size_t points_count = 3;
+
+    /* Fixed point coordinates must fit in 32 bits, vertices far outside of the viewport are
+     * clipped to it (the planes are unaffected, so interpolation is still exact). */
+    if (min.x < -guard_band || min.y < -guard_band || max.x > guard_band || max.y > guard_band) {
+      dvec2 clipped[max_polygon_size + 1];
+
+      points_count = clip_polygon(points, points_count, clipped, 0, clip_min.x, false);
+      points_count = clip_polygon(clipped, points_count, points, 0, clip_max.x, true);
+      points_count = clip_polygon(points, points_count, clipped, 1, clip_min.y, false);
+      points_count = clip_polygon(clipped, points_count, points, 1, clip_max.y, true);
+
+      if (points_count < 3) {
+        return;
+      }
+    }
+
+    int64_t area = 0;
+
+    for (size_t i = 0; i < points_count; i++) {
+      polygon.x[i] = static_cast<int32_t>(std::llround(points[i].x * subpixel));
+      polygon.y[i] = static_cast<int32_t>(std::llround(points[i].y * subpixel));
+    }
+
+    for (size_t i = 0; i < points_count; i++) {
+      const size_t j = (i + 1) % points_count;
+      area += static_cast<int64_t>(polygon.x[i]) * polygon.y[j] -
+              static_cast<int64_t>(polygon.x[j]) * polygon.y[i];
+    }
+
+    if (area == 0) {
+      return;
+    }
+
+    /* Rasterization expects counter-clockwise polygons, there is no face culling. */
+    if (area < 0) {
+      std::reverse(polygon.x, polygon.x + points_count);
+      std::reverse(polygon.y, polygon.y + points_count);
+    }
+
+    polygon.size = static_cast<uint8_t>(points_count);
+  }
+
+  /* Planes are rebased to the corner of the bounds to keep the fragment offsets small. */
+  const dvec2 offset = origin - window[0];
+
+  for (size_t i = 0; i < varyings_count; i++) {
+    primitive.varyings[i] = static_cast<float>(value(0, i) + ddx[i] * offset.x +
+                                               ddy[i] * offset.y);
+    primitive.ddx[i] = static_cast<float>(ddx[i]);
+    primitive.ddy[i] = static_cast<float>(ddy[i]);
+  }
+
+  primitive.z = static_cast<float>(depth[0] + ddx[varyings_count] * offset.x +
+                                   ddy[varyings_count] * offset.y);
+  primitive.dzdx = static_cast<float>(ddx[varyings_count]);
+  primitive.dzdy = static_cast<float>(ddy[varyings_count]);
+
+  primitive.origin = vec2(origin);
+  primitive.bounds = bounds;
+}
+
+void SWRasterizer::bin(const irect viewport)
+{
+  const ivec2 size = viewport.size();
+
+  m_bins_count = (size + bin_size - 1) / bin_size;
+  m_bin_starts.assign(static_cast<size_t>(m_bins_count.x) * m_bins_count.y + 1, 0);
+
+  /* The bins covered by a primitive, the maximum is exclusive. */
+  auto bins_rect = [&](const SWPrimitive& primitive) {
+    return irect{(primitive.bounds.min - viewport.min) / bin_size,
+                 (primitive.bounds.max - viewport.min + bin_size - 1) / bin_size};
+  };
+
+  for (size_t p = 0; p < m_primitives.size(); p++) {
+    if (m_polygons[p].size == 0) {
+      continue;
+    }
+
+    const irect rect = bins_rect(m_primitives[p]);
+
+    for (int y = rect.min.y; y < rect.max.y; y++) {
+      for (int x = rect.min.x; x < rect.max.x; x++) {
+        m_bin_starts[static_cast<size_t>(y) * m_bins_count.x + x + 1]++;
+      }
+    }
+  }
+
+  for (size_t i = 1; i < m_bin_starts.size(); i++) {
+    m_bin_starts[i] += m_bin_starts[i - 1];
+  }
+
+  m_bin_primitives.resize(m_bin_starts.back());
+
+  std::vector<uint32_t> cursors(m_bin_starts.begin(), m_bin_starts.end() - 1);
+
+  for (size_t p = 0; p < m_primitives.size(); p++) {
+    if (m_polygons[p].size == 0) {
+      continue;
+    }
+
+    const irect rect = bins_rect(m_primitives[p]);
+
+    for (int y = rect.min.y; y < rect.max.y; y++) {
+      for (int x = rect.min.x; x < rect.max.x; x++) {
+        m_bin_primitives[cursors[static_cast<size_t>(y) * m_bins_count.x + x]++] =
+            static_cast<uint32_t>(p);
+      }
+    }
+  }
+}
+
+void SWRasterizer::rasterize_polygon(const SWPipeline& pipeline,
+                                     const SWPrimitive& primitive,
+                                     const Polygon& polygon,
+                                     const irect rect) const
+{
+  const int64_t one = int64_t(1) << subpixel_bits;
+  const int64_t half = one / 2;
+
+  int64_t a[max_polygon_size];
+  int64_t b[max_polygon_size];
+  int64_t c[max_polygon_size];
+  int64_t bias[max_polygon_size];
+
+  /* Edge functions are positive inside of the polygon. Pixel centers on an edge are covered only
+   * by the polygon on its top or left side, so that shared edges are rasterized once. */
+  for (size_t i = 0; i < polygon.size; i++) {
+    const size_t j = (i + 1) % polygon.size;
+
+    a[i] = static_cast<int64_t>(polygon.y[i]) - polygon.y[j];
+    b[i] = static_cast<int64_t>(polygon.x[j]) - polygon.x[i];
+    c[i] = -(a[i] * polygon.x[i] + b[i] * polygon.y[i]);
+    bias[i] = a[i] > 0 || (a[i] == 0 && b[i] > 0) ? 0 : 1;
+  }
+
+  for (int y = rect.min.y; y < rect.max.y; y++) {
+    const int64_t py = y * one + half;
+
+    int64_t x_min = rect.min.x;
+    int64_t x_max = rect.max.x - 1;
+
+    for (size_t i = 0; i < polygon.size && x_min <= x_max; i++) {
+      /* The edge function at the center of the pixel x is e0 + ex * x. */
+      const int64_t e0 = a[i] * half + b[i] * py + c[i];
+      const int64_t ex = a[i] * one;
+
+      if (ex > 0) {
+        x_min = std::max(x_min, -floor_div(e0 - bias[i], ex));
+      } else if (ex < 0) {
+        x_max = std::min(x_max, floor_div(e0 - bias[i], -ex));
+      } else if (e0 < bias[i]) {
+        x_max = x_min - 1;
+      }
+    }
+
+    for (int64_t x = x_min; x <= x_max; x += 4) {
+      const int64_t remaining = x_max - x + 1;
+      const int mask = remaining >= 4 ? 0xF : (1 << remaining) - 1;
+
+      shade(pipeline, primitive, static_cast<int>(x), y, mask);
+    }
+  }
+}
+
+void SWRasterizer::rasterize_line(const SWPipeline& pipeline,
+                                  const SWPrimitive& primitive,
+                                  const Polygon& polygon,
+                                  const irect rect) const
+{
+  const float inv_subpixel = 1.0f / static_cast<float>(1 << subpixel_bits);
+
+  const vec2 p0 = vec2(polygon.x[0], polygon.y[0]) * inv_subpixel;
+  const vec2 p1 = vec2(polygon.x[1], polygon.y[1]) * inv_subpixel;
+  const vec2 d = p1 - p0;
+
+  /* Lines are one pixel wide: each pixel center along the major axis covers one pixel. */
+  const int major = std::abs(d.x) >= std::abs(d.y) ? 0 : 1;
+  const int minor = 1 - major;
+
+  const float start = std::min(p0[major], p1[major]);
+  const float end = std::max(p0[major], p1[major]);
+
+  const int first = std::max(static_cast<int>(std::ceil(start - 0.5f)), rect.min[major]);
+  const int last = std::min(static_cast<int>(std::ceil(end - 0.5f)), rect.max[major]);
+
+  for (int i = first; i < last; i++) {
+    const float t = (i + 0.5f - p0[major]) / d[major];
+    const int j = static_cast<int>(std::floor(p0[minor] + t * d[minor]));
+
+    if (j < rect.min[minor] || j >= rect.max[minor]) {
+      continue;
+    }
+
+    if (major == 0) {
+      shade(pipeline, primitive, i, j, 1);
+    } else {
+      shade(pipeline, primitive, j, i, 1);
+    }
+  }
+}
+
+void SWRasterizer::shade(const SWPipeline& pipeline,
+                         const SWPrimitive& primitive,
+                         const int x,
+                         const int y,
+                         int mask) const
+{
+  const SWRenderTarget& target = pipeline.target;
+  const size_t offset = static_cast<size_t>(y) * target.size.x + x;
+
+  SWFragment fragment;
+
+  fragment.dx = f32x4(x + 0.5f - primitive.origin.x) + f32x4(0.0f, 1.0f, 2.0f, 3.0f);
+  fragment.dy = f32x4(y + 0.5f - primitive.origin.y);
+
+  /* Fragments outside of the depth range are clipped, then tested before shading. */
+  const f32x4 z = f32x4(primitive.z) + f32x4(primitive.dzdx) * fragment.dx +
+                  f32x4(primitive.dzdy) * fragment.dy;
+
+  m32x4 lanes = m32x4::from_bits(mask) & (z >= f32x4(0.0f)) & (z <= f32x4(1.0f));
+
+  const bool depth_test_enabled = pipeline.depth.has_value() && target.depth != nullptr;
+
+  if (depth_test_enabled) {
+    float depth[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    for (int i = 0; i < 4; i++) {
+      if (mask & (1 << i)) {
+        depth[i] = target.depth[offset + i];
+      }
+    }
+
+    lanes = lanes & depth_test(pipeline.depth->func, z, f32x4::load(depth));
+  }
+
+  mask = lanes.bits();
+
+  if (!mask) {
+    return;
+  }
+
+  fragment.mask = lanes;
+
+  f32x4 color[4];
+
+  pipeline.program->fragment(primitive, fragment, *pipeline.uniforms, color);
+
+  uint8_t* pixels = target.color + offset * 4;
+
+  float dst[4][4] = {};
+
+  if (pipeline.blend.has_value()) {
+    for (int i = 0; i < 4; i++) {
+      if (mask & (1 << i)) {
+        for (int c = 0; c < 4; c++) {
+          dst[c][i] = pixels[i * 4 + c] * (1.0f / 255.0f);
+        }
+      }
+    }
+
+    const BlendState& blend = pipeline.blend.value();
+    const f32x4 src_alpha = color[3];
+    const f32x4 dst_alpha = f32x4::load(dst[3]);
+
+    for (int c = 0; c < 4; c++) {
+      const f32x4 d = f32x4::load(dst[c]);
+
+      if (blend.op == BlendOp::Min || blend.op == BlendOp::Max) {
+        color[c] = blend_op(blend.op, color[c], d);
+        continue;
+      }
+
+      const BlendFactor src_factor = c < 3 ? blend.src_rgb_factor : blend.src_alpha_factor;
+      const BlendFactor dst_factor = c < 3 ? blend.dest_rgb_factor : blend.dest_alpha_factor;
+
+      color[c] = blend_op(blend.op,
+                          color[c] * blend_factor(src_factor, src_alpha, dst_alpha, d),
+                          d * blend_factor(dst_factor, src_alpha, dst_alpha, d));
+    }
+  }
+
+  float out[4][4];
+
+  for (int c = 0; c < 4; c++) {
+    (clamp(color[c], f32x4(0.0f), f32x4(1.0f)) * f32x4(255.0f) + f32x4(0.5f)).store(out[c]);
+  }
+
+  for (int i = 0; i < 4; i++) {
+    if (!(mask & (1 << i))) {
+      continue;
+    }
+
+    for (int c = 0; c < 4; c++) {
+      if (pipeline.color_mask[c]) {
+        pixels[i * 4 + c] = static_cast<uint8_t>(out[c][i]);
+      }
+    }
+  }
+
+  if (depth_test_enabled && pipeline.depth->write) {
+    float depth[4];
+    z.store(depth);
+
+    for (int i = 0; i < 4; i++) {
+      if (mask & (1 << i)) {
+        target.depth[offset + i] = depth[i];
+      }
+    }
+  }
+}
+
+}  // namespace graphick::renderer::GPU::SW
+
+#endif
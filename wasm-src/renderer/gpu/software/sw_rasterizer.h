@@ -0,0 +1,176 @@
+/**
+ * @file renderer/gpu/software/sw_rasterizer.h
+ * @brief The file contains the definition of the software rasterizer.
+ */
+
+#pragma once
+
+#include "sw_shaders.h"
+
+#include "../../../utils/job_system.h"
+
+#include <optional>
+#include <vector>
+
+namespace graphick::renderer::GPU::SW {
+
+/**
+ * @brief The state of a draw call.
+ */
+struct SWPipeline {
+  const SWProgramInfo* program;       // The program to run.
+  const SWUniforms* uniforms;         // The values of the uniforms.
+  const SWVertexArray* vertex_array;  // The vertex attributes and the index buffer.
+  Primitive primitive;                // The primitive to assemble.
+
+  SWRenderTarget target;              // The memory to render into.
+  irect viewport;                     // The viewport, in window coordinates.
+
+  std::optional<BlendState> blend;    // The blend state, if std::nullopt blending is disabled.
+  std::optional<DepthState> depth;    // The depth state, if std::nullopt the test is disabled.
+  bool color_mask[4];                 // Which channels to write.
+};
+
+/**
+ * @brief The software rasterizer, it runs the draw calls of the software device.
+ *
+ * Vertices are shaded and primitives are set up in parallel, then primitives are binned into
+ * screen tiles in submission order. Each bin is rasterized by a single worker, so the fragments of
+ * a pixel are always blended in order without synchronization.
+ */
+class SWRasterizer {
+ public:
+  static constexpr int subpixel_bits = 8;          // The fractional bits of vertex positions.
+  static constexpr int bin_size = 64;              // The size of a bin in pixels.
+  static constexpr double guard_band = 1048576.0;  // Primitives past it are clipped, in pixels.
+  static constexpr size_t max_polygon_size = 7;    // A triangle clipped by a rectangle.
+ public:
+  /**
+   * @brief Constructs a new software rasterizer.
+   *
+   * @param workers_count The number of worker threads, in addition to the calling thread.
+   */
+  SWRasterizer(const size_t workers_count = utils::JobSystem::default_workers_count())
+      : m_jobs(workers_count)
+  {
+  }
+
+  /**
+   * @brief Returns the number of threads used to execute draw calls.
+   *
+   * @return The number of threads.
+   */
+  inline size_t concurrency() const
+  {
+    return m_jobs.concurrency();
+  }
+
+  /**
+   * @brief Executes a draw call.
+   *
+   * @param pipeline The state of the draw call.
+   * @param vertex_count The number of vertices (or indices, if indexed) to draw.
+   * @param instance_count The number of instances to draw.
+   * @param indexed Whether to read the vertices through the index buffer of the vertex array.
+   */
+  void draw(const SWPipeline& pipeline,
+            const size_t vertex_count,
+            const size_t instance_count,
+            const bool indexed);
+
+ private:
+  /**
+   * @brief A primitive after clipping, with the vertices of its (convex) polygon.
+   */
+  struct Polygon {
+    int32_t x[max_polygon_size];  // The fixed point x coordinates of the vertices.
+    int32_t y[max_polygon_size];  // The fixed point y coordinates of the vertices.
+    uint8_t size;                 // The number of vertices, 0 if the primitive is culled.
+  };
+
+  /**
+   * @brief Runs the vertex shader on every vertex referenced by the draw call.
+   *
+   * @param pipeline The state of the draw call.
+   * @param vertex_count The number of vertices per instance.
+   * @param instance_count The number of instances.
+   */
+  void shade_vertices(const SWPipeline& pipeline,
+                      const size_t vertex_count,
+                      const size_t instance_count);
+
+  /**
+   * @brief Transforms a primitive to window space, clips it and calculates its plane equations.
+   *
+   * @param pipeline The state of the draw call.
+   * @param vertices The indices of the vertices of the primitive.
+   * @param primitive The primitive to set up.
+   * @param polygon The clipped polygon of the primitive.
+   */
+  void setup(const SWPipeline& pipeline,
+             const uint32_t* vertices,
+             SWPrimitive& primitive,
+             Polygon& polygon) const;
+
+  /**
+   * @brief Sorts the primitives into bins, preserving the submission order.
+   *
+   * @param viewport The rectangle to rasterize.
+   */
+  void bin(const irect viewport);
+
+  /**
+   * @brief Rasterizes a triangle, or its clipped polygon, inside a rectangle.
+   *
+   * @param pipeline The state of the draw call.
+   * @param primitive The primitive to rasterize.
+   * @param polygon The polygon of the primitive.
+   * @param rect The pixels to rasterize.
+   */
+  void rasterize_polygon(const SWPipeline& pipeline,
+                         const SWPrimitive& primitive,
+                         const Polygon& polygon,
+                         const irect rect) const;
+
+  /**
+   * @brief Rasterizes a line inside a rectangle.
+   *
+   * @param pipeline The state of the draw call.
+   * @param primitive The primitive to rasterize.
+   * @param polygon The two endpoints of the line.
+   * @param rect The pixels to rasterize.
+   */
+  void rasterize_line(const SWPipeline& pipeline,
+                      const SWPrimitive& primitive,
+                      const Polygon& polygon,
+                      const irect rect) const;
+
+  /**
+   * @brief Shades up to 4 horizontally adjacent pixels, then depth tests and blends them.
+   *
+   * @param pipeline The state of the draw call.
+   * @param primitive The primitive being rasterized.
+   * @param x The x coordinate of the first pixel.
+   * @param y The y coordinate of the pixels.
+   * @param mask The pixels to shade, bit i is the pixel (x + i, y).
+   */
+  void shade(const SWPipeline& pipeline,
+             const SWPrimitive& primitive,
+             const int x,
+             const int y,
+             int mask) const;
+
+ private:
+  utils::JobSystem m_jobs;                 // The workers used to shade vertices and bins.
+
+  std::vector<SWVertex> m_vertices;        // The shaded vertices.
+  std::vector<uint32_t> m_indices;         // The vertices of each primitive.
+  std::vector<SWPrimitive> m_primitives;   // The primitives of the draw call.
+  std::vector<Polygon> m_polygons;         // The clipped polygons of the primitives.
+
+  ivec2 m_bins_count;                      // The number of bins along each axis.
+  std::vector<uint32_t> m_bin_starts;      // The first entry of each bin, plus the end.
+  std::vector<uint32_t> m_bin_primitives;  // The primitives of each bin, stored contiguously.
+};
+
+}  // namespace graphick::renderer::GPU::SW
@@ -0,0 +1,674 @@
+/**
+ * @file renderer/gpu/software/sw_shaders.cpp
+ * @brief The file contains the implementation of the software shaders.
+ */
+
+#ifdef GK_SOFTWARE
+
+#  include "sw_shaders.h"
+
+#  include "../../../math/vector.h"
+
+#  include "../../../utils/half.h"
+
+namespace graphick::renderer::GPU::SW {
+
+/* -- Helpers -- */
+
+/**
+ * @brief Lane-wise version of the GLSL smoothstep() function.
+ *
+ * @param edge0 The value of x for which the result is 0.
+ * @param edge1 The value of x for which the result is 1.
+ * @param x The values to interpolate.
+ * @return The Hermite interpolation of x.
+ */
+static inline f32x4 smoothstep(const f32x4 edge0, const f32x4 edge1, const f32x4 x)
+{
+  const f32x4 t = clamp((x - edge0) / (edge1 - edge0), f32x4(0.0f), f32x4(1.0f));
+  return t * t * (f32x4(3.0f) - f32x4(2.0f) * t);
+}
+
+/**
+ * @brief Writes the premultiplied version of a straight alpha color multiplied by alpha.
+ *
+ * @param rgba The straight alpha color.
+ * @param alpha The coverage of each fragment.
+ * @param color The output color.
+ */
+static inline void premultiply(const f32x4 rgba[4], const f32x4 alpha, f32x4 color[4])
+{
+  const f32x4 a = rgba[3] * alpha;
+
+  color[0] = rgba[0] * a;
+  color[1] = rgba[1] * a;
+  color[2] = rgba[2] * a;
+  color[3] = a;
+}
+
+/**
+ * @brief Port of texture.glsl, samples the texture paint of each fragment.
+ *
+ * @param texture_index The index of the texture in u_textures, 0 is not a valid texture.
+ * @param fragment The fragments to shade.
+ * @param s The horizontal texture coordinates.
+ * @param t The vertical texture coordinates.
+ * @param uniforms The uniforms of the program.
+ * @param rgba The output color, with straight alpha.
+ */
+static void texture_fill(const uint32_t texture_index,
+                         const SWFragment& fragment,
+                         const f32x4 s,
+                         const f32x4 t,
+                         const SWUniforms& uniforms,
+                         f32x4 rgba[4])
+{
+  if (texture_index == 0 || uniforms.textures.empty()) {
+    rgba[0] = rgba[1] = rgba[2] = f32x4(0.0f);
+    rgba[3] = f32x4(1.0f);
+    return;
+  }
+
+  /* As in the OpenGL device, units past the bound textures repeat the last texture. */
+  const SWTexture* texture = texture_index < uniforms.textures.size() ?
+                                 uniforms.textures[texture_index] :
+                                 uniforms.textures.back();
+
+  const int mask = fragment.mask.bits();
+
+  float ss[4], ts[4];
+  float channels[4][4] = {};
+
+  s.store(ss);
+  t.store(ts);
+
+  for (int lane = 0; lane < 4; lane++) {
+    if ((mask & (1 << lane)) == 0) {
+      continue;
+    }
+
+    const vec4 texel = texture->sample(vec2(ss[lane], ts[lane]));
+
+    channels[0][lane] = texel.r;
+    channels[1][lane] = texel.g;
+    channels[2][lane] = texel.b;
+    channels[3][lane] = texel.a;
+  }
+
+  for (int i = 0; i < 4; i++) {
+    rgba[i] = f32x4::load(channels[i]);
+  }
+}
+
+/**
+ * @brief Port of calculate_cubic_root() in cubic.glsl, refines a root with Halley's method.
+ */
+static inline f32x4 calculate_cubic_root(
+    const float a, const float b, const float c, const f32x4 d, const f32x4 t0)
+{
+  const f32x4 av = f32x4(a);
+  const f32x4 bv = f32x4(b);
+  const f32x4 cv = f32x4(c);
+  const f32x4 a1 = f32x4(3.0f * a);
+  const f32x4 b1 = f32x4(2.0f * b);
+  const f32x4 a2 = f32x4(6.0f * a);
+
+  f32x4 t = t0;
+
+  for (int i = 0; i < 3; i++) {
+    const f32x4 t_sq = t * t;
+    const f32x4 f = av * t_sq * t + bv * t_sq + cv * t + d;
+    const f32x4 f_prime = a1 * t_sq + b1 * t + cv;
+    const f32x4 f_second = a2 * t + b1;
+
+    t = t - f32x4(3.0f) * f * (f32x4(3.0f) * f_prime * f_prime - f * f_second) /
+                (f32x4(9.0f) * f_prime * f_prime * f_prime -
+                 f32x4(9.0f) * f * f_prime * f_second + f * f * a2);
+  }
+
+  return t;
+}
+
+/**
+ * @brief Port of cubic_horizontal_coverage() in cubic.glsl.
+ *
+ * Control points don't depend on the fragment, so the degenerate curve test is done once per
+ * curve, while the remaining branches become lane masks.
+ *
+ * @tparam T The type of the texel components, float or half.
+ * @param curves The curves of the batch, two RGBA32F (or RGBA16F) texels per curve.
+ * @param px The horizontal sample positions.
+ * @param py The vertical sample positions.
+ * @param inv_pixel_size The inverse of the horizontal size of a pixel in curve space.
+ * @param curves_count The number of curves to process.
+ * @param mask The fragments to shade.
+ * @return The signed horizontal coverage of each fragment.
+ */
+template<typename T>
+static f32x4 cubic_horizontal_coverage(const T* curves,
+                                       const f32x4 px,
+                                       const f32x4 py,
+                                       const float inv_pixel_size,
+                                       const uint32_t curves_count,
+                                       m32x4 mask)
+{
+  constexpr float epsilon = 1e-7f;
+
+  const f32x4 inv = f32x4(inv_pixel_size);
+  const f32x4 zero = f32x4(0.0f);
+  const f32x4 one = f32x4(1.0f);
+  const f32x4 half = f32x4(0.5f);
+
+  f32x4 coverage = zero;
+
+  for (uint32_t curve = 0; curve < curves_count; curve++) {
+    float c[8];
+
+    for (int i = 0; i < 8; i++) {
+      c[i] = static_cast<float>(curves[curve * 8 + i]);
+    }
+
+    const f32x4 p0x = f32x4(c[0]) - px;
+    const f32x4 p0y = f32x4(c[1]) - py;
+    const f32x4 p3x = f32x4(c[6]) - px;
+    const f32x4 p3y = f32x4(c[7]) - py;
+
+    /* Lanes break out of the loop independently. */
+    mask = and_not(mask, max(p0x, p3x) * inv < -half);
+
+    if (!mask.any()) {
+      break;
+    }
+
+    const m32x4 is_downwards = (p0y > zero) | (p3y < zero);
+    const m32x4 skip_downwards = is_downwards & (((p0y < zero) & (p3y <= zero)) |
+                                                 ((p0y > zero) & (p3y >= zero)));
+    const m32x4 skip_upwards = and_not(((p0y <= zero) & (p3y < zero)) |
+                                           ((p0y >= zero) & (p3y > zero)),
+                                       is_downwards);
+    const m32x4 lanes = and_not(mask, skip_downwards | skip_upwards);
+
+    if (!lanes.any()) {
+      continue;
+    }
+
+    const f32x4 delta_x = p3x - p0x;
+    const f32x4 delta_y = p3y - p0y;
+
+    const f32x4 t0 = -p0y / delta_y;
+    f32x4 intersect = delta_x * t0 + p0x;
+
+    const m32x4 is_far = min(p0x, p3x) * inv > half;
+
+    const bool b01 = std::abs(c[2] - c[0]) + std::abs(c[3] - c[1]) < epsilon;
+    const bool b23 = std::abs(c[6] - c[4]) + std::abs(c[7] - c[5]) < epsilon;
+    const bool b12 = std::abs(c[4] - c[2]) + std::abs(c[5] - c[3]) < epsilon;
+    const bool is_line = (b01 && (b23 || b12)) || (b23 && b12);
+
+    if (!is_line && and_not(lanes, is_far).any()) {
+      const float a_x = 3.0f * c[2] - 3.0f * c[4] + c[6] - c[0];
+      const float a_y = 3.0f * c[3] - 3.0f * c[5] + c[7] - c[1];
+      const float b_x = 3.0f * (c[0] - 2.0f * c[2] + c[4]);
+      const float b_y = 3.0f * (c[1] - 2.0f * c[3] + c[5]);
+      const float c_x = 3.0f * (c[2] - c[0]);
+      const float c_y = 3.0f * (c[3] - c[1]);
+
+      const f32x4 t = calculate_cubic_root(a_y, b_y, c_y, p0y, t0);
+      const f32x4 t_sq = t * t;
+
+      intersect = select(is_far,
+                         intersect,
+                         f32x4(a_x) * t_sq * t + f32x4(b_x) * t_sq + f32x4(c_x) * t + p0x);
+    }
+
+    const f32x4 sign = select(is_downwards, one, -one);
+    const f32x4 contribution = clamp(half + intersect * inv, zero, one) * sign;
+
+    coverage = coverage + select(lanes, contribution, zero);
+  }
+
+  return coverage;
+}
+
+/**
+ * @brief Port of cubic_coverage() in cubic.glsl.
+ *
+ * @param primitive The primitive being rasterized.
+ * @param fragment The fragments to shade.
+ * @param uniforms The uniforms of the program.
+ * @param samples The number of vertical samples, odd.
+ * @param is_half Whether the curves are in the half precision curves texture.
+ * @return The signed coverage of each fragment.
+ */
+static f32x4 cubic_coverage(const SWPrimitive& primitive,
+                            const SWFragment& fragment,
+                            const SWUniforms& uniforms,
+                            const int samples,
+                            const bool is_half)
+{
+  const SWTexture* texture = is_half ? uniforms.half_curves_texture : uniforms.curves_texture;
+
+  if (!texture) {
+    return f32x4(0.0f);
+  }
+
+  const float pixel_size_x = SWFragment::fwidth(primitive, 6);
+  const float pixel_size_y = SWFragment::fwidth(primitive, 7);
+
+  const uint32_t curves_offset = primitive.flats[0] & 0xFFFFF;
+  const uint32_t curves_count = primitive.flats[2] & 0xFFFF;
+
+  const f32x4 x = fragment.varying(primitive, 6);
+  const f32x4 y = fragment.varying(primitive, 7);
+
+  f32x4 coverage = f32x4(0.0f);
+
+  for (int offset = (1 - samples) / 2; offset <= (samples - 1) / 2; offset++) {
+    const f32x4 sample_y = y + f32x4(static_cast<float>(offset) * pixel_size_y /
+                                     static_cast<float>(samples));
+
+    const float inv_pixel_size = 1.0f / pixel_size_x;
+
+    if (is_half) {
+      const utils::half* curves = reinterpret_cast<const utils::half*>(texture->data.get()) +
+                                  curves_offset * 4;
+
+      coverage = coverage + cubic_horizontal_coverage(
+                                curves, x, sample_y, inv_pixel_size, curves_count, fragment.mask);
+    } else {
+      const float* curves = reinterpret_cast<const float*>(texture->data.get()) +
+                            curves_offset * 4;
+
+      coverage = coverage + cubic_horizontal_coverage(
+                                curves, x, sample_y, inv_pixel_size, curves_count, fragment.mask);
+    }
+  }
+
+  return coverage / f32x4(static_cast<float>(samples));
+}
+
+/* -- Tile -- */
+
+/**
+ * @brief Port of tile.vs.glsl.
+ */
+static SWVertex tile_vertex(const SWAttributeValue* inputs, const SWUniforms& uniforms)
+{
+  const uint32_t z_index = inputs[4].u[1] >> 12;
+  const float z = -static_cast<float>(static_cast<int>(z_index) - 524288) / 524288.0f;
+
+  const int x = inputs[0].u[0] ? 2 : 0;
+  const int y = inputs[0].u[1] ? 3 : 1;
+  const float corner_x = static_cast<float>(inputs[0].u[0]);
+  const float corner_y = static_cast<float>(inputs[0].u[1]);
+
+  SWVertex vertex;
+
+  vertex.position = uniforms.view_projection * vec4(inputs[1].f[x], inputs[1].f[y], z, 1.0f);
+
+  for (int i = 0; i < 4; i++) {
+    vertex.varyings[i] = static_cast<float>(inputs[3].u[i]) / 255.0f;
+  }
+
+  vertex.varyings[4] = inputs[5].f[0] + corner_x * inputs[6].f[0] + corner_y * inputs[6].f[2];
+  vertex.varyings[5] = inputs[5].f[1] + corner_x * inputs[6].f[1] + corner_y * inputs[6].f[3];
+  vertex.varyings[6] = inputs[2].f[x];
+  vertex.varyings[7] = inputs[2].f[y];
+
+  vertex.flats[0] = inputs[4].u[0];
+  vertex.flats[1] = inputs[4].u[1];
+  vertex.flats[2] = inputs[4].u[2];
+
+  return vertex;
+}
+
+/**
+ * @brief Port of tile.fs.glsl.
+ */
+static void tile_fragment(const SWPrimitive& primitive,
+                          const SWFragment& fragment,
+                          const SWUniforms& uniforms,
+                          f32x4 color[4])
+{
+  const uint32_t attr_1 = primitive.flats[0];
+  const uint32_t attr_2 = primitive.flats[1];
+
+  const bool is_even_odd = (attr_2 >> 9) & 0x1;
+  const uint32_t curves_type = (attr_2 >> 10) & 0x3;
+  const uint32_t paint_type = (attr_1 >> 20) & 0x7F;
+
+  const int samples = uniforms.samples % 2 == 0 ? uniforms.samples + 1 : uniforms.samples;
+
+  const bool is_half = curves_type == 3;
+
+  const f32x4 coverage = curves_type == 0 ?
+                             f32x4(1.0f) :
+                             cubic_coverage(primitive, fragment, uniforms, samples, is_half);
+  f32x4 alpha;
+
+  if (is_even_odd) {
+    alpha = abs(coverage - f32x4(2.0f) * round(f32x4(0.5f) * coverage));
+  } else {
+    alpha = min(abs(coverage), f32x4(1.0f));
+  }
+
+  f32x4 rgba[4];
+
+  if (paint_type == 3) {
+    texture_fill(attr_2 & 0x3FF,
+                 fragment,
+                 fragment.varying(primitive, 4),
+                 fragment.varying(primitive, 5),
+                 uniforms,
+                 rgba);
+  } else {
+    for (int i = 0; i < 4; i++) {
+      rgba[i] = fragment.varying(primitive, i);
+    }
+  }
+
+  premultiply(rgba, alpha, color);
+}
+
+/* -- Fill -- */
+
+/**
+ * @brief Port of fill.vs.glsl.
+ */
+static SWVertex fill_vertex(const SWAttributeValue* inputs, const SWUniforms& uniforms)
+{
+  const uint32_t z_index = inputs[4].u[0] >> 12;
+  const float z = -static_cast<float>(static_cast<int>(z_index) - 524288) / 524288.0f;
+
+  SWVertex vertex;
+
+  vertex.position = uniforms.view_projection * vec4(inputs[0].f[0], inputs[0].f[1], z, 1.0f);
+
+  for (int i = 0; i < 4; i++) {
+    vertex.varyings[i] = static_cast<float>(inputs[1].u[i]) / 255.0f;
+  }
+
+  vertex.varyings[4] = inputs[2].f[0];
+  vertex.varyings[5] = inputs[2].f[1];
+
+  vertex.flats[0] = inputs[3].u[0];
+  vertex.flats[1] = inputs[4].u[0];
+
+  return vertex;
+}
+
+/**
+ * @brief Port of fill.fs.glsl.
+ */
+static void fill_fragment(const SWPrimitive& primitive,
+                          const SWFragment& fragment,
+                          const SWUniforms& uniforms,
+                          f32x4 color[4])
+{
+  const uint32_t paint_type = (primitive.flats[0] >> 20) & 0x7F;
+
+  f32x4 rgba[4];
+
+  if (paint_type == 3) {
+    texture_fill(primitive.flats[1] & 0x3FF,
+                 fragment,
+                 fragment.varying(primitive, 4),
+                 fragment.varying(primitive, 5),
+                 uniforms,
+                 rgba);
+  } else {
+    for (int i = 0; i < 4; i++) {
+      rgba[i] = fragment.varying(primitive, i);
+    }
+  }
+
+  premultiply(rgba, f32x4(1.0f), color);
+}
+
+/* -- Primitive -- */
+
+/**
+ * @brief Port of primitive.vs.glsl.
+ */
+static SWVertex primitive_vertex(const SWAttributeValue* inputs, const SWUniforms& uniforms)
+{
+  const vec2 attr_1 = vec2(inputs[1].f[0], inputs[1].f[1]);
+  const vec2 attr_2 = vec2(inputs[2].f[0], inputs[2].f[1]);
+  const uint32_t attr_3 = inputs[3].u[0];
+
+  const uint32_t type = attr_3 & 0xF;
+  const vec2 vertex_pos = vec2(static_cast<float>(inputs[0].u[0]),
+                               static_cast<float>(inputs[0].u[1]));
+
+  SWVertex vertex;
+  vec2 position;
+
+  if (type == 0) {
+    const float width = static_cast<float>(attr_3 >> 8) / 1024.0f;
+    const float elongation = 0.25f / uniforms.zoom;
+
+    const vec2 dir = attr_2 - attr_1;
+    const vec2 normalized_dir = math::normalize(dir);
+    const vec2 normal = width * vec2(-normalized_dir.y, normalized_dir.x);
+
+    position = attr_1 + vertex_pos.x * dir +
+               elongation * (2.0f * vertex_pos.x - 1.0f) * normalized_dir +
+               normal * (1.0f - 2.0f * vertex_pos.y) / uniforms.zoom;
+
+    vertex.varyings[4] = 1.0f;
+    vertex.varyings[5] = 1.0f - 2.0f * vertex_pos.y;
+    vertex.varyings[6] = width;
+  } else {
+    const vec2 size = type == 2 ? attr_2 * 2.0f : attr_2;
+
+    position = attr_1 + vertex_pos * size - size / 2.0f;
+
+    vertex.varyings[4] = vertex_pos.x - 0.5f;
+    vertex.varyings[5] = vertex_pos.y - 0.5f;
+    vertex.varyings[6] = attr_2.x;
+  }
+
+  for (int i = 0; i < 4; i++) {
+    vertex.varyings[i] = static_cast<float>(inputs[4].u[i]) / 255.0f;
+  }
+
+  const vec4 clip = uniforms.view_projection * vec4(position.x, position.y, 0.0f, 1.0f);
+
+  vertex.position = vec4(clip.x, clip.y, clip.z, 1.0f);
+  vertex.flats[0] = attr_3;
+
+  return vertex;
+}
+
+/**
+ * @brief Port of primitive.fs.glsl.
+ */
+static void primitive_fragment(const SWPrimitive& primitive,
+                               const SWFragment& fragment,
+                               const SWUniforms& uniforms,
+                               f32x4 color[4])
+{
+  const uint32_t type = primitive.flats[0] & 0xF;
+  const f32x4 parameter = fragment.varying(primitive, 6);
+
+  f32x4 alpha = f32x4(1.0f);
+
+  switch (type) {
+    case 0: {
+      const f32x4 factor = parameter * (f32x4(1.0f) - abs(fragment.varying(primitive, 5)));
+      alpha = smoothstep(parameter - f32x4(1.25f), parameter, factor);
+      break;
+    }
+    case 2: {
+      const f32x4 s = fragment.varying(primitive, 4);
+      const f32x4 t = fragment.varying(primitive, 5);
+      const f32x4 dist = f32x4(2.0f) * parameter * sqrt(s * s + t * t);
+      alpha = smoothstep(parameter, parameter - f32x4(1.0f / uniforms.zoom), dist);
+      break;
+    }
+    default:
+      break;
+  }
+
+  f32x4 rgba[4];
+
+  for (int i = 0; i < 4; i++) {
+    rgba[i] = fragment.varying(primitive, i);
+  }
+
+  premultiply(rgba, alpha, color);
+}
+
+/* -- DebugRect -- */
+
+/**
+ * @brief Port of debug_rect.vs.glsl.
+ */
+static SWVertex debug_rect_vertex(const SWAttributeValue* inputs, const SWUniforms& uniforms)
+{
+  const vec4 clip = uniforms.view_projection * vec4(inputs[0].f[0], inputs[0].f[1], 0.0f, 1.0f);
+
+  SWVertex vertex;
+
+  vertex.position = vec4(clip.x, clip.y, clip.z, 1.0f);
+  vertex.varyings[0] = inputs[1].f[0];
+  vertex.varyings[1] = inputs[1].f[1];
+
+  for (int i = 0; i < 4; i++) {
+    vertex.varyings[i + 2] = static_cast<float>(inputs[2].u[i]) / 255.0f;
+  }
+
+  vertex.flats[0] = inputs[3].u[0];
+
+  return vertex;
+}
+
+/**
+ * @brief Port of debug_rect.fs.glsl.
+ */
+static void debug_rect_fragment(const SWPrimitive& primitive,
+                                const SWFragment& fragment,
+                                const SWUniforms& uniforms,
+                                f32x4 color[4])
+{
+  f32x4 rgba[4];
+
+  for (int i = 0; i < 4; i++) {
+    rgba[i] = fragment.varying(primitive, i + 2);
+  }
+
+  premultiply(rgba, f32x4(1.0f), color);
+
+  if (primitive.flats[0] != 1 || !uniforms.texture) {
+    return;
+  }
+
+  const f32x4 s = fragment.varying(primitive, 0);
+  const f32x4 t = fragment.varying(primitive, 1);
+  const int mask = fragment.mask.bits();
+
+  float ss[4], ts[4], alphas[4] = {};
+
+  s.store(ss);
+  t.store(ts);
+
+  for (int lane = 0; lane < 4; lane++) {
+    if (mask & (1 << lane)) {
+      alphas[lane] = uniforms.texture->sample(vec2(ss[lane], ts[lane])).r;
+    }
+  }
+
+  /* The color is premultiplied twice, as in the GLSL shader. */
+  const f32x4 alpha = color[3] * f32x4::load(alphas);
+
+  color[0] = color[0] * alpha;
+  color[1] = color[1] * alpha;
+  color[2] = color[2] * alpha;
+  color[3] = alpha;
+}
+
+/* -- Programs -- */
+
+static const char* s_uniform_names[] = {
+    "u_view_projection",
+    "u_samples",
+    "u_zoom",
+    "u_curves_texture",
+    "u_texture",
+    "u_textures",
+    "u_half_curves_texture"};
+
+static const SWProgramInfo s_programs[] = {
+    {"tile",
+     SWProgramKind::Tile,
+     {"a_position",
+      "a_instance_rect",
+      "a_instance_curves_rect",
+      "a_instance_color",
+      "a_instance_attrs",
+      "a_instance_tex_coord",
+      "a_instance_tex_coord_axes"},
+     {SWUniformLocation::ViewProjection,
+      SWUniformLocation::Samples,
+      SWUniformLocation::CurvesTexture,
+      SWUniformLocation::Textures,
+      SWUniformLocation::HalfCurvesTexture},
+     8,
+     tile_vertex,
+     tile_fragment},
+    {"fill",
+     SWProgramKind::Fill,
+     {"a_position", "a_color", "a_tex_coord", "a_attr_1", "a_attr_2"},
+     {SWUniformLocation::ViewProjection, SWUniformLocation::Textures},
+     6,
+     fill_vertex,
+     fill_fragment},
+    {"primitive",
+     SWProgramKind::Primitive,
+     {"a_position",
+      "a_instance_attr_1",
+      "a_instance_attr_2",
+      "a_instance_attr_3",
+      "a_instance_color"},
+     {SWUniformLocation::ViewProjection, SWUniformLocation::Zoom},
+     7,
+     primitive_vertex,
+     primitive_fragment},
+    {"debug_rect",
+     SWProgramKind::DebugRect,
+     {"a_position", "a_tex_coord", "a_color", "a_primitive"},
+     {SWUniformLocation::ViewProjection, SWUniformLocation::Texture},
+     6,
+     debug_rect_vertex,
+     debug_rect_fragment}};
+
+const char* uniform_name(const SWUniformLocation location)
+{
+  return s_uniform_names[static_cast<int>(location)];
+}
+
+const SWProgramInfo* program_info(const std::string& name)
+{
+  for (const SWProgramInfo& program : s_programs) {
+    if (name == program.name) {
+      return &program;
+    }
+  }
+
+  return nullptr;
+}
+
+const SWProgramInfo* program_info(const SWProgramKind kind)
+{
+  for (const SWProgramInfo& program : s_programs) {
+    if (kind == program.kind) {
+      return &program;
+    }
+  }
+
+  return nullptr;
+}
+
+}  // namespace graphick::renderer::GPU::SW
+
+#endif
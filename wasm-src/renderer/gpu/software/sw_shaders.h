@@ -0,0 +1,178 @@
+/**
+ * @file renderer/gpu/software/sw_shaders.h
+ * @brief The file contains the C++ ports of the shaders run by the software device.
+ *
+ * Each program mirrors the homonymous GLSL shaders in renderer/gpu/shaders: the vertex shader runs
+ * once per vertex, the fragment shader runs on groups of 4 horizontally adjacent pixels, one per
+ * SIMD lane.
+ */
+
+#pragma once
+
+#include "sw_data.h"
+#include "sw_simd.h"
+
+#include "../../../math/mat4.h"
+
+#include <string>
+#include <vector>
+
+namespace graphick::renderer::GPU::SW {
+
+/**
+ * @brief The uniforms known to the software device, the location of a uniform is its index.
+ */
+enum class SWUniformLocation {
+  ViewProjection = 0,  // u_view_projection
+  Samples,             // u_samples
+  Zoom,                // u_zoom
+  CurvesTexture,       // u_curves_texture
+  Texture,             // u_texture
+  Textures,            // u_textures
+  HalfCurvesTexture,   // u_half_curves_texture
+  Count
+};
+
+/**
+ * @brief The values of the uniforms, set through the render state of each draw call.
+ */
+struct SWUniforms {
+  mat4 view_projection = mat4::identity();         // u_view_projection
+  int samples = 1;                                 // u_samples
+  float zoom = 1.0f;                               // u_zoom
+
+  const SWTexture* curves_texture = nullptr;       // u_curves_texture
+  const SWTexture* half_curves_texture = nullptr;  // u_half_curves_texture
+  const SWTexture* texture = nullptr;              // u_texture
+  std::vector<const SWTexture*> textures;          // u_textures
+};
+
+/**
+ * @brief The value of a vertex attribute, its class determines which member is valid.
+ */
+union SWAttributeValue {
+  float f[4];     // Float and FloatNorm attributes.
+  uint32_t u[4];  // Int attributes.
+};
+
+/**
+ * @brief The output of a vertex shader.
+ */
+struct SWVertex {
+  static constexpr size_t max_varyings = 8;  // The maximum number of interpolated outputs.
+  static constexpr size_t max_flats = 3;     // The maximum number of flat outputs.
+
+  vec4 position;                             // The clip space position (gl_Position).
+  float varyings[max_varyings];              // The outputs to interpolate.
+  uint32_t flats[max_flats];                 // The flat outputs.
+};
+
+/**
+ * @brief A triangle or a line ready to be rasterized, in window space.
+ *
+ * Varyings and depth are stored as plane equations relative to the corner of the bounds, so that
+ * their screen space derivatives (needed by fwidth()) are available to the fragment shader.
+ */
+struct SWPrimitive {
+  irect bounds;                            // The covered pixels, clamped to the viewport.
+  vec2 origin;                             // The window position the planes are relative to.
+  bool line;                               // Whether the primitive is a line.
+
+  float z;                                 // The window depth at the origin.
+  float dzdx;                              // The horizontal derivative of the depth.
+  float dzdy;                              // The vertical derivative of the depth.
+
+  float varyings[SWVertex::max_varyings];  // The varyings at the origin.
+  float ddx[SWVertex::max_varyings];       // The horizontal derivatives of the varyings.
+  float ddy[SWVertex::max_varyings];       // The vertical derivatives of the varyings.
+  uint32_t flats[SWVertex::max_flats];     // The flat outputs of the provoking vertex.
+};
+
+/**
+ * @brief A group of 4 horizontally adjacent fragments.
+ */
+struct SWFragment {
+  f32x4 dx;    // The horizontal offsets of the pixel centers from the primitive origin.
+  f32x4 dy;    // The vertical offsets of the pixel centers from the primitive origin.
+  m32x4 mask;  // The fragments covered by the primitive.
+
+  /**
+   * @brief Interpolates a varying at the fragments.
+   *
+   * @param primitive The primitive being rasterized.
+   * @param i The index of the varying.
+   * @return The value of the varying at each fragment.
+   */
+  inline f32x4 varying(const SWPrimitive& primitive, const size_t i) const
+  {
+    return f32x4(primitive.varyings[i]) + f32x4(primitive.ddx[i]) * dx +
+           f32x4(primitive.ddy[i]) * dy;
+  }
+
+  /**
+   * @brief Returns the sum of the absolute derivatives of a varying, as fwidth() does.
+   *
+   * @param primitive The primitive being rasterized.
+   * @param i The index of the varying.
+   * @return The screen space width of the varying.
+   */
+  static inline float fwidth(const SWPrimitive& primitive, const size_t i)
+  {
+    return std::abs(primitive.ddx[i]) + std::abs(primitive.ddy[i]);
+  }
+};
+
+/**
+ * @brief A vertex shader, inputs are indexed by attribute location.
+ */
+using SWVertexShader = SWVertex (*)(const SWAttributeValue* inputs, const SWUniforms& uniforms);
+
+/**
+ * @brief A fragment shader, it outputs the premultiplied RGBA color of each fragment.
+ */
+using SWFragmentShader = void (*)(const SWPrimitive& primitive,
+                                  const SWFragment& fragment,
+                                  const SWUniforms& uniforms,
+                                  f32x4 color[4]);
+
+/**
+ * @brief The description of a software program.
+ */
+struct SWProgramInfo {
+  const char* name;                         // The name of the GLSL shaders it ports.
+  SWProgramKind kind;                       // The kind of the program.
+
+  std::vector<std::string> attributes;      // The vertex attributes, by location.
+  std::vector<SWUniformLocation> uniforms;  // The uniforms declared by the shaders.
+
+  size_t varyings_count;                    // The number of interpolated outputs.
+
+  SWVertexShader vertex;                    // The vertex shader.
+  SWFragmentShader fragment;                // The fragment shader.
+};
+
+/**
+ * @brief Returns the name of a uniform, as declared in the GLSL shaders.
+ *
+ * @param location The location of the uniform.
+ * @return The name of the uniform.
+ */
+const char* uniform_name(const SWUniformLocation location);
+
+/**
+ * @brief Returns the software program with the given name.
+ *
+ * @param name The name of the program.
+ * @return The program description, nullptr if there is no software port of the program.
+ */
+const SWProgramInfo* program_info(const std::string& name);
+
+/**
+ * @brief Returns the software program of the given kind.
+ *
+ * @param kind The kind of the program.
+ * @return The program description, nullptr if kind is SWProgramKind::None.
+ */
+const SWProgramInfo* program_info(const SWProgramKind kind);
+
+}  // namespace graphick::renderer::GPU::SW
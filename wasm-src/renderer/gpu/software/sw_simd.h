@@ -0,0 +1,468 @@
+/**
+ * @file renderer/gpu/software/sw_simd.h
+ * @brief The file contains the 4-wide float vector used by the software rasterizer.
+ *
+ * The vector maps to SSE2 on x86, to SIMD128 on WebAssembly builds with -msimd128 and to plain
+ * arrays everywhere else.
+ */
+
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define GK_SW_SSE2 1
+#  include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#  define GK_SW_WASM_SIMD 1
+#  include <wasm_simd128.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace graphick::renderer::GPU::SW {
+
+/**
+ * @brief A 4-wide lane mask, the result of a comparison between two f32x4.
+ */
+struct m32x4 {
+#if defined(GK_SW_SSE2)
+  __m128 v;
+#elif defined(GK_SW_WASM_SIMD)
+  v128_t v;
+#else
+  bool v[4];
+#endif
+
+  /**
+   * @brief Returns the lanes of the mask as the lowest 4 bits of an integer.
+   *
+   * @return The bit mask, bit i is set if lane i is set.
+   */
+  inline int bits() const
+  {
+#if defined(GK_SW_SSE2)
+    return _mm_movemask_ps(v);
+#elif defined(GK_SW_WASM_SIMD)
+    return static_cast<int>(wasm_i32x4_bitmask(v));
+#else
+    return int(v[0]) | (int(v[1]) << 1) | (int(v[2]) << 2) | (int(v[3]) << 3);
+#endif
+  }
+
+  /**
+   * @brief Checks whether any lane is set.
+   *
+   * @return true if at least one lane is set, false otherwise.
+   */
+  inline bool any() const
+  {
+    return bits() != 0;
+  }
+
+  /**
+   * @brief Creates a mask from the lowest 4 bits of an integer.
+   *
+   * @param bits The bit mask, bit i sets lane i.
+   * @return The lane mask.
+   */
+  static inline m32x4 from_bits(const int bits)
+  {
+#if defined(GK_SW_SSE2)
+    const __m128i lanes = _mm_and_si128(_mm_set1_epi32(bits), _mm_setr_epi32(1, 2, 4, 8));
+    return {_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, _mm_setr_epi32(1, 2, 4, 8)))};
+#elif defined(GK_SW_WASM_SIMD)
+    const v128_t lanes = wasm_v128_and(wasm_i32x4_splat(bits), wasm_i32x4_make(1, 2, 4, 8));
+    return {wasm_i32x4_eq(lanes, wasm_i32x4_make(1, 2, 4, 8))};
+#else
+    return {{(bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0, (bits & 8) != 0}};
+#endif
+  }
+};
+
+inline m32x4 operator&(const m32x4 a, const m32x4 b)
+{
+#if defined(GK_SW_SSE2)
+  return {_mm_and_ps(a.v, b.v)};
+#elif defined(GK_SW_WASM_SIMD)
+  return {wasm_v128_and(a.v, b.v)};
+#else
+  return {{a.v[0] && b.v[0], a.v[1] && b.v[1], a.v[2] && b.v[2], a.v[3] && b.v[3]}};
+#endif
+}
+
+inline m32x4 operator|(const m32x4 a, const m32x4 b)
+{
+#if defined(GK_SW_SSE2)
+  return {_mm_or_ps(a.v, b.v)};
+#elif defined(GK_SW_WASM_SIMD)
+  return {wasm_v128_or(a.v, b.v)};
+#else
+  return {{a.v[0] || b.v[0], a.v[1] || b.v[1], a.v[2] || b.v[2], a.v[3] || b.v[3]}};
+#endif
+}
+
+/**
+ * @brief Returns the lanes set in a but not in b.
+ */
+inline m32x4 and_not(const m32x4 a, const m32x4 b)
+{
+#if defined(GK_SW_SSE2)
+  return {_mm_andnot_ps(b.v, a.v)};
+#elif defined(GK_SW_WASM_SIMD)
+  return {wasm_v128_andnot(a.v, b.v)};
+#else
+  return {{a.v[0] && !b.v[0], a.v[1] && !b.v[1], a.v[2] && !b.v[2], a.v[3] && !b.v[3]}};
+#endif
+}
+
+/**
+ * @brief A 4-wide float vector, each lane usually holds the value of a different pixel.
+ */
+struct f32x4 {
+#if defined(GK_SW_SSE2)
+  __m128 v;
+#elif defined(GK_SW_WASM_SIMD)
+  v128_t v;
+#else
+  float v[4];
+#endif
+
+  f32x4() = default;
+
+#if defined(GK_SW_SSE2)
+  f32x4(const __m128 v) : v(v) {}
+  f32x4(const float x) : v(_mm_set1_ps(x)) {}
+  f32x4(const float a, const float b, const float c, const float d) : v(_mm_setr_ps(a, b, c, d))
+  {
+  }
+#elif defined(GK_SW_WASM_SIMD)
+  f32x4(const v128_t v) : v(v) {}
+  f32x4(const float x) : v(wasm_f32x4_splat(x)) {}
+  f32x4(const float a, const float b, const float c, const float d)
+      : v(wasm_f32x4_make(a, b, c, d))
+  {
+  }
+#else
+  f32x4(const float x) : v{x, x, x, x} {}
+  f32x4(const float a, const float b, const float c, const float d) : v{a, b, c, d} {}
+#endif
+
+  /**
+   * @brief Loads 4 consecutive floats.
+   *
+   * @param data The floats to load, they don't need to be aligned.
+   * @return The loaded vector.
+   */
+  static inline f32x4 load(const float* data)
+  {
+#if defined(GK_SW_SSE2)
+    return _mm_loadu_ps(data);
+#elif defined(GK_SW_WASM_SIMD)
+    return wasm_v128_load(data);
+#else
+    return f32x4(data[0], data[1], data[2], data[3]);
+#endif
+  }
+
+  /**
+   * @brief Stores the lanes to 4 consecutive floats.
+   *
+   * @param data The destination, it doesn't need to be aligned.
+   */
+  inline void store(float* data) const
+  {
+#if defined(GK_SW_SSE2)
+    _mm_storeu_ps(data, v);
+#elif defined(GK_SW_WASM_SIMD)
+    wasm_v128_store(data, v);
+#else
+    std::copy(v, v + 4, data);
+#endif
+  }
+};
+
+#if defined(GK_SW_SSE2)
+
+inline f32x4 operator+(const f32x4 a, const f32x4 b)
+{
+  return _mm_add_ps(a.v, b.v);
+}
+
+inline f32x4 operator-(const f32x4 a, const f32x4 b)
+{
+  return _mm_sub_ps(a.v, b.v);
+}
+
+inline f32x4 operator*(const f32x4 a, const f32x4 b)
+{
+  return _mm_mul_ps(a.v, b.v);
+}
+
+inline f32x4 operator/(const f32x4 a, const f32x4 b)
+{
+  return _mm_div_ps(a.v, b.v);
+}
+
+inline f32x4 operator-(const f32x4 a)
+{
+  return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f));
+}
+
+inline m32x4 operator<(const f32x4 a, const f32x4 b)
+{
+  return {_mm_cmplt_ps(a.v, b.v)};
+}
+
+inline m32x4 operator<=(const f32x4 a, const f32x4 b)
+{
+  return {_mm_cmple_ps(a.v, b.v)};
+}
+
+inline m32x4 operator>(const f32x4 a, const f32x4 b)
+{
+  return {_mm_cmpgt_ps(a.v, b.v)};
+}
+
+inline m32x4 operator>=(const f32x4 a, const f32x4 b)
+{
+  return {_mm_cmpge_ps(a.v, b.v)};
+}
+
+inline f32x4 min(const f32x4 a, const f32x4 b)
+{
+  return _mm_min_ps(a.v, b.v);
+}
+
+inline f32x4 max(const f32x4 a, const f32x4 b)
+{
+  return _mm_max_ps(a.v, b.v);
+}
+
+inline f32x4 abs(const f32x4 a)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v);
+}
+
+inline f32x4 sqrt(const f32x4 a)
+{
+  return _mm_sqrt_ps(a.v);
+}
+
+/**
+ * @brief Rounds each lane to the nearest integer, halfway cases are rounded to even.
+ */
+inline f32x4 round(const f32x4 a)
+{
+  return _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v));
+}
+
+/**
+ * @brief Returns the lanes of a where the mask is set, the lanes of b otherwise.
+ */
+inline f32x4 select(const m32x4 mask, const f32x4 a, const f32x4 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+#elif defined(GK_SW_WASM_SIMD)
+
+inline f32x4 operator+(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_add(a.v, b.v);
+}
+
+inline f32x4 operator-(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_sub(a.v, b.v);
+}
+
+inline f32x4 operator*(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_mul(a.v, b.v);
+}
+
+inline f32x4 operator/(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_div(a.v, b.v);
+}
+
+inline f32x4 operator-(const f32x4 a)
+{
+  return wasm_f32x4_neg(a.v);
+}
+
+inline m32x4 operator<(const f32x4 a, const f32x4 b)
+{
+  return {wasm_f32x4_lt(a.v, b.v)};
+}
+
+inline m32x4 operator<=(const f32x4 a, const f32x4 b)
+{
+  return {wasm_f32x4_le(a.v, b.v)};
+}
+
+inline m32x4 operator>(const f32x4 a, const f32x4 b)
+{
+  return {wasm_f32x4_gt(a.v, b.v)};
+}
+
+inline m32x4 operator>=(const f32x4 a, const f32x4 b)
+{
+  return {wasm_f32x4_ge(a.v, b.v)};
+}
+
+inline f32x4 min(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_pmin(a.v, b.v);
+}
+
+inline f32x4 max(const f32x4 a, const f32x4 b)
+{
+  return wasm_f32x4_pmax(a.v, b.v);
+}
+
+inline f32x4 abs(const f32x4 a)
+{
+  return wasm_f32x4_abs(a.v);
+}
+
+inline f32x4 sqrt(const f32x4 a)
+{
+  return wasm_f32x4_sqrt(a.v);
+}
+
+/**
+ * @brief Rounds each lane to the nearest integer, halfway cases are rounded to even.
+ */
+inline f32x4 round(const f32x4 a)
+{
+  return wasm_f32x4_nearest(a.v);
+}
+
+/**
+ * @brief Returns the lanes of a where the mask is set, the lanes of b otherwise.
+ */
+inline f32x4 select(const m32x4 mask, const f32x4 a, const f32x4 b)
+{
+  return wasm_v128_bitselect(a.v, b.v, mask.v);
+}
+
+#else
+
+/**
+ * @brief Applies a binary operation to each lane of two vectors.
+ */
+template<typename F>
+inline f32x4 lanewise(const f32x4 a, const f32x4 b, F op)
+{
+  return f32x4(op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]));
+}
+
+/**
+ * @brief Compares each lane of two vectors.
+ */
+template<typename F>
+inline m32x4 lanewise_mask(const f32x4 a, const f32x4 b, F op)
+{
+  return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
+
+inline f32x4 operator+(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return x + y; });
+}
+
+inline f32x4 operator-(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return x - y; });
+}
+
+inline f32x4 operator*(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return x * y; });
+}
+
+inline f32x4 operator/(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return x / y; });
+}
+
+inline f32x4 operator-(const f32x4 a)
+{
+  return f32x4(-a.v[0], -a.v[1], -a.v[2], -a.v[3]);
+}
+
+inline m32x4 operator<(const f32x4 a, const f32x4 b)
+{
+  return lanewise_mask(a, b, [](float x, float y) { return x < y; });
+}
+
+inline m32x4 operator<=(const f32x4 a, const f32x4 b)
+{
+  return lanewise_mask(a, b, [](float x, float y) { return x <= y; });
+}
+
+inline m32x4 operator>(const f32x4 a, const f32x4 b)
+{
+  return lanewise_mask(a, b, [](float x, float y) { return x > y; });
+}
+
+inline m32x4 operator>=(const f32x4 a, const f32x4 b)
+{
+  return lanewise_mask(a, b, [](float x, float y) { return x >= y; });
+}
+
+inline f32x4 min(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return y < x ? y : x; });
+}
+
+inline f32x4 max(const f32x4 a, const f32x4 b)
+{
+  return lanewise(a, b, [](float x, float y) { return x < y ? y : x; });
+}
+
+inline f32x4 abs(const f32x4 a)
+{
+  return f32x4(std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]));
+}
+
+inline f32x4 sqrt(const f32x4 a)
+{
+  return f32x4(std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]));
+}
+
+/**
+ * @brief Rounds each lane to the nearest integer, halfway cases are rounded to even.
+ */
+inline f32x4 round(const f32x4 a)
+{
+  return f32x4(std::nearbyint(a.v[0]),
+               std::nearbyint(a.v[1]),
+               std::nearbyint(a.v[2]),
+               std::nearbyint(a.v[3]));
+}
+
+/**
+ * @brief Returns the lanes of a where the mask is set, the lanes of b otherwise.
+ */
+inline f32x4 select(const m32x4 mask, const f32x4 a, const f32x4 b)
+{
+  return f32x4(mask.v[0] ? a.v[0] : b.v[0],
+               mask.v[1] ? a.v[1] : b.v[1],
+               mask.v[2] ? a.v[2] : b.v[2],
+               mask.v[3] ? a.v[3] : b.v[3]);
+}
+
+#endif
+
+/**
+ * @brief Clamps each lane between two values.
+ */
+inline f32x4 clamp(const f32x4 a, const f32x4 lo, const f32x4 hi)
+{
+  return min(max(a, lo), hi);
+}
+
+}  // namespace graphick::renderer::GPU::SW
@@ -30,6 +30,8 @@
 
 #include "renderer_cache.h"
 
+#include <chrono>
+#include <optional>
 #include <unordered_set>
 
 #ifdef EMSCRIPTEN
@@ -40,14 +42,50 @@ namespace graphick::renderer {
 
 /* -- Static Member Initialization -- */
 
-Renderer* Renderer::s_instance = nullptr;
+thread_local Renderer* Renderer::s_instance = nullptr;
+
+/**
+ * @brief The draw request, it holds a copy of everything needed to build the drawable off the main
+ * thread.
+ */
+struct Renderer::DrawRequest {
+  std::shared_ptr<Geometry> geometry;  // The render-ready geometry, completed by the request.
+  std::array<vec2, 4> texture_coords;  // The texture coordinates to use for the fill.
+
+  std::optional<Fill> fill;            // The fill to use, if visible.
+  std::optional<Stroke> stroke;        // The stroke to use, if visible.
+
+  std::shared_ptr<const StrokeGeometry> stroke_geometry;  // The stroke outline, built if nullptr.
+  bool stroked = false;  // Whether the stroke outline was built by the request.
+
+  uuid id;                             // The id used for caching.
+
+  Drawable drawable;                   // The resulting drawable.
+  drect cached_bounding_rect;          // The bounding rectangle to cache, includes the stroke.
+  bool visible = false;                // Whether the drawable is visible.
+};
+
+/**
+ * @brief Returns the options to stroke a path with.
+ *
+ * @param stroke The stroke properties.
+ * @return The stroking options.
+ */
+static geom::StrokingOptions<double> stroking_options(const Stroke& stroke)
+{
+  return geom::StrokingOptions<double>{RendererSettings::stroking_tolerance,
+                                       stroke.width,
+                                       stroke.miter_limit,
+                                       stroke.cap,
+                                       stroke.join};
+}
 
 #ifdef GK_DEBUG
 
 #  define __debug_max_rects 2048
 
-inline static GPU::Buffer* __debug_rect_vertex_buffer = nullptr;
-inline static GPU::Texture* __debug_font_texture = nullptr;
+inline static thread_local GPU::Buffer* __debug_rect_vertex_buffer = nullptr;
+inline static thread_local GPU::Texture* __debug_font_texture = nullptr;
 
 /**
  * @brief The vertex structure for the debug rect.
@@ -90,11 +128,25 @@ GPU::Texture create_default_texture()
                       data.data());
 }
 
+/**
+ * @brief Returns the current time of a monotonic clock, used for the frame statistics.
+ *
+ * @return The time in nanoseconds.
+ */
+static inline size_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 /* -- Renderer -- */
 
 void Renderer::init()
 {
-#ifdef EMSCRIPTEN
+#if defined(GK_SOFTWARE)
+  GPU::Device::init(GPU::DeviceVersion::Software);
+#elif defined(EMSCRIPTEN)
   EmscriptenWebGLContextAttributes attr;
   emscripten_webgl_init_context_attributes(&attr);
 
@@ -144,7 +196,7 @@ void Renderer::shutdown()
 
   GPU::Device::shutdown();
 
-#ifdef EMSCRIPTEN
+#if defined(EMSCRIPTEN) && !defined(GK_SOFTWARE)
   EMSCRIPTEN_WEBGL_CONTEXT_HANDLE ctx = emscripten_webgl_get_current_context();
   emscripten_webgl_destroy_context(ctx);
 #endif
@@ -156,8 +208,14 @@ void Renderer::begin_frame(const RenderOptions& options)
 
   get()->m_viewport = options.viewport;
   get()->m_tiler.setup(options.viewport.zoom);
+
+  for (Tiler& tiler : get()->m_worker_tilers) {
+    tiler.setup(options.viewport.zoom);
+  }
   get()->m_ui_options = UIOptions(options.viewport.dpr / options.viewport.zoom);
   get()->m_cache = options.cache;
+  get()->m_stats = RenderStats{};
+  get()->m_textures.begin_frame();
 
   get()->flush_background_layer();
 
@@ -184,6 +242,13 @@ void Renderer::end_frame()
 {
   get()->flush_scene_layer();
 
+  get()->m_stats.stale_LODs = get()->m_cache->schedule_LOD_updates(
+      RendererSettings::LOD_updates_per_frame);
+
+  __debug_value("stale LODs", get()->m_stats.stale_LODs);
+  __debug_value("geometry cache (KB)", get()->m_cache->geometries_memory() / 1024);
+  __debug_value("stroke cache (KB)", get()->m_cache->strokes_memory() / 1024);
+
   GPU::Device::default_framebuffer();
 
   get()->flush_ui_layer();
@@ -195,6 +260,8 @@ void Renderer::end_frame()
 
   const size_t time = GPU::Device::end_commands();
 
+  get()->m_stats.gpu_time = time;
+
   __debug_time_total_record("GPU", time);
 }
 
@@ -216,7 +283,16 @@ bool Renderer::draw(const geom::path& path,
     return false;
   }
 
-  if (get()->m_cache->has_bounding_rect(id) && get()->m_cache->has_drawable(id)) {
+  if (get()->m_cache->has_drawable(id) &&
+      (!get()->m_cache->has_bounding_rect(id) ||
+       get()->m_cache->get_drawable(id).transform != transform))
+  {
+    get()->move_cached_drawable(transform, options, id);
+  }
+
+  if (get()->m_cache->has_bounding_rect(id) && get()->m_cache->has_drawable(id) &&
+      get()->m_cache->get_drawable(id).transform == transform)
+  {
     const drect& bounding_rect = get()->m_cache->get_bounding_rect(id);
     const Drawable& drawable = get()->m_cache->get_drawable(id);
 
@@ -236,17 +312,24 @@ bool Renderer::draw(const geom::path& path,
     if (LOD == drawable.LOD) {
       is_LOD_valid = true;
     } else if (LOD == drawable.LOD + 1 || drawable.LOD == LOD + 1) {
-      // We randomly choose whether to update the LOD or not. To distribute the updates across
-      // multiple frames.
-      is_LOD_valid = rand() > RAND_MAX / 2;
+      // A close LOD is still acceptable, updates are distributed across multiple frames giving
+      // priority to the most visible drawables.
+      is_LOD_valid = !get()->m_cache->update_LOD(id, visible_all);
     }
 
     if (is_LOD_valid && math::is_almost_equal(visible_all, visible_clip)) {
-      get()->m_tiles.push_drawable(&drawable);
+      get()->m_queue.push_back({&drawable, 0});
 
       if (options.outline) {
-        const geom::dpath transformed_path = path.transformed<double>(transform);
-        get()->draw_outline(transformed_path, bounding_rect, *options.outline);
+        const std::shared_ptr<const Geometry> geometry = get()->m_cache->get_geometry(id,
+                                                                                      transform);
+
+        if (geometry && !geometry->path.empty()) {
+          get()->draw_outline(geometry->path, bounding_rect, *options.outline);
+        } else {
+          const geom::dpath transformed_path = path.transformed<double>(transform);
+          get()->draw_outline(transformed_path, bounding_rect, *options.outline);
+        }
       }
 
       return true;
@@ -255,14 +338,39 @@ bool Renderer::draw(const geom::path& path,
 
   __debug_value_counter("recalculated");
 
-  bool has_transform;
+  /* The geometry only depends on the path and its transform, so it is reused when retiling
+   * (i.e. when the LOD changes). A cached geometry is never modified, since it could be shared.
+   * Fills are tiled from the cubic multipath, streamed without transforming the path first. The
+   * transformed path is only built for strokes and outlines, or for the bounds of hidden fills. */
+
+  const bool needs_cubic_path = options.fill && options.fill->paint.visible();
+  const bool needs_path = !needs_cubic_path ||
+                          (options.stroke && options.stroke->paint.visible()) || options.outline;
 
-  const geom::dpath transformed_path = path.transformed<double>(transform, &has_transform);
-  const math::drect transformed_bounding_rect = transformed_path.bounding_rect();
+  std::shared_ptr<Geometry> geometry = get()->m_cache->get_geometry(id, transform);
+
+  if (geometry == nullptr) {
+    geometry = std::make_shared<Geometry>();
+
+    geometry->transform = transform;
+    geometry->has_transform = !math::is_identity(transform);
+    geometry->build(path, needs_cubic_path, needs_path);
+    geometry->bounding_rect = geometry->cubic_path.empty() ? geometry->path.bounding_rect() :
+                                                             geometry->cubic_path.bounding_rect();
+  } else if ((needs_cubic_path && geometry->cubic_path.empty()) ||
+             (needs_path && geometry->path.empty()))
+  {
+    geometry = std::make_shared<Geometry>(*geometry);
+    geometry->build(path, needs_cubic_path, needs_path);
+  } else {
+    __debug_value_counter("reused geometry");
+  }
+
+  const drect& transformed_bounding_rect = geometry->bounding_rect;
 
   std::array<vec2, 4> tex_coords = rect::identity().vertices();
 
-  if (has_transform && options.fill &&
+  if (geometry->has_transform && options.fill &&
       (options.fill->paint.is_gradient() || options.fill->paint.is_texture()))
   {
     drect raw_bounding_rect = drect(path.bounding_rect());
@@ -280,8 +388,7 @@ bool Renderer::draw(const geom::path& path,
     tex_coords = {v0, v1, v2, v3};
   }
 
-  return get()->draw_transformed(
-      transformed_path, transformed_bounding_rect, options, tex_coords, id);
+  return get()->draw_transformed(std::move(geometry), options, tex_coords, id);
 }
 
 bool Renderer::draw(const renderer::Text& text,
@@ -453,67 +560,206 @@ float Renderer::__debug_text_impl(const std::string& text, const vec2 position,
 
 #endif
 
-bool Renderer::draw_transformed(const geom::dpath& path,
-                                const drect& bounding_rect,
+bool Renderer::draw_transformed(std::shared_ptr<Geometry> geometry,
                                 const DrawingOptions& options,
                                 const std::array<vec2, 4>& texture_coords,
                                 const uuid id)
 {
-  Drawable drawable;
+  const bool has_fill = options.fill && options.fill->paint.visible();
+  const bool has_stroke = options.stroke && options.stroke->paint.visible();
 
-  drawable.LOD = m_tiler.LOD();
-  drawable.appearance = Appearance{BlendingMode::Normal, 1.0f};
+  const geom::dpath& path = geometry->path;
+  const drect& bounding_rect = geometry->bounding_rect;
 
-  bool visible = false;
+  DrawRequest& request = m_requests.emplace_back();
 
-  if (options.fill && options.fill->paint.visible()) {
-    geom::dcubic_multipath cubic_path = path.to_cubic_multipath();
+  request.geometry = std::move(geometry);
+  request.texture_coords = texture_coords;
+  request.id = id;
 
-    if (!cubic_path.closed()) {
-      cubic_path.line_to(cubic_path.front());
-    }
+  if (has_fill) {
+    request.fill = *options.fill;
+  }
 
-    visible |= draw_multipath(cubic_path, bounding_rect, *options.fill, texture_coords, drawable);
+  if (has_stroke) {
+    request.stroke = *options.stroke;
+    request.stroke_geometry = m_cache->get_stroke(
+        id, request.geometry->transform, stroking_options(*options.stroke));
   }
 
-  if (options.stroke && options.stroke->paint.visible()) {
-    Fill stroke_fill{options.stroke->paint, FillRule::NonZero};
+  m_queue.push_back({nullptr, m_requests.size() - 1});
 
-    const geom::StrokingOptions<double> stroking_options{RendererSettings::stroking_tolerance,
-                                                         options.stroke->width,
-                                                         options.stroke->miter_limit,
-                                                         options.stroke->cap,
-                                                         options.stroke->join};
-    const geom::PathBuilder<double> builder = geom::PathBuilder(path, bounding_rect);
-    const geom::StrokeOutline<double> stroke_path = builder.stroke(stroking_options);
+  /* The same visibility test of draw_multipath(), the outline is drawn right away because the
+   * selected vertices are only valid during this call. */
 
-    get()->m_cache->set_bounding_rect(id, stroke_path.bounding_rect);
+  const drect visible_rect = m_viewport.visible();
+  const auto is_visible = [&](const drect& rect) {
+    const double coverage = geom::rect_rect_intersection_area(rect, visible_rect) / rect.area();
+    return !(coverage <= math::epsilon<double>);
+  };
 
-    visible |= draw_multipath(
-        stroke_path.path, stroke_path.bounding_rect, stroke_fill, texture_coords, drawable);
-  } else {
-    get()->m_cache->set_bounding_rect(id, bounding_rect);
+  const bool visible = (has_fill && is_visible(bounding_rect)) ||
+                       (has_stroke && is_visible(drect::expand(bounding_rect,
+                                                               options.stroke->width * 0.5)));
+
+  if (visible && options.outline) {
+    draw_outline(path, bounding_rect, *options.outline);
   }
 
-  if (!visible) {
-    m_cache->set_drawable(id, std::move(drawable));
+  return visible;
+}
+
+bool Renderer::move_cached_drawable(const mat2x3& transform,
+                                    const DrawingOptions& options,
+                                    const uuid id)
+{
+  const double max_error = RendererSettings::move_tolerance / m_viewport.zoom;
+  const double stroke_width = options.stroke && options.stroke->paint.visible() ?
+                                  options.stroke->width :
+                                  0.0;
+
+  if (!m_cache->move_drawable(
+          id, transform, RendererSettings::move_scale_change, max_error, stroke_width))
+  {
     return false;
   }
 
-  m_tiles.push_drawable(m_cache->set_drawable(id, std::move(drawable)));
+  __debug_value_counter("moved");
 
-  if (options.outline) {
-    draw_outline(path, bounding_rect, *options.outline);
+  return true;
+}
+
+void Renderer::build_drawable(DrawRequest& request, Tiler& tiler) const
+{
+  Drawable& drawable = request.drawable;
+  const Geometry& geometry = *request.geometry;
+
+  drawable.LOD = tiler.LOD();
+  drawable.appearance = Appearance{BlendingMode::Normal, 1.0f};
+  drawable.transform = geometry.transform;
+
+  request.cached_bounding_rect = geometry.bounding_rect;
+  request.visible = false;
+
+  if (request.fill) {
+    request.visible |= draw_multipath(geometry.cubic_path,
+                                      geometry.bounding_rect,
+                                      *request.fill,
+                                      request.texture_coords,
+                                      tiler,
+                                      drawable);
   }
 
-  return true;
+  if (request.stroke) {
+    const Stroke& stroke = *request.stroke;
+    const Fill stroke_fill{stroke.paint, FillRule::NonZero};
+
+    /* The outline doesn't depend on the LOD, so it is only built if not cached. */
+
+    if (request.stroke_geometry == nullptr) {
+      build_stroke(request, nullptr);
+    }
+
+    const geom::StrokeOutline<double>& stroke_path = request.stroke_geometry->outline;
+
+    request.cached_bounding_rect = stroke_path.bounding_rect;
+
+    request.visible |= draw_multipath(stroke_path.path,
+                                      stroke_path.bounding_rect,
+                                      stroke_fill,
+                                      request.texture_coords,
+                                      tiler,
+                                      drawable);
+  }
+}
+
+void Renderer::build_stroke(DrawRequest& request, utils::JobSystem* jobs) const
+{
+  const Geometry& geometry = *request.geometry;
+
+  std::shared_ptr<StrokeGeometry> stroke_geometry = std::make_shared<StrokeGeometry>();
+
+  const geom::PathBuilder<double> builder = geom::PathBuilder(geometry.path,
+                                                              geometry.bounding_rect);
+
+  stroke_geometry->options = stroking_options(*request.stroke);
+  stroke_geometry->outline = builder.stroke(stroke_geometry->options, nullptr, jobs);
+  stroke_geometry->transform = geometry.transform;
+
+  request.stroke_geometry = std::move(stroke_geometry);
+  request.stroked = true;
+}
+
+void Renderer::flush_requests()
+{
+  __debug_time_total();
+
+  /* Tiling and stroking are independent for each request, only the cache and the GPU resources
+   * must be touched from the main thread. */
+
+  const size_t start = now_ns();
+
+  /* A single long path would keep one worker busy while the others are idle, so long paths are
+   * stroked first, each one split across all the workers. */
+
+  for (DrawRequest& request : m_requests) {
+    if (request.stroke && request.stroke_geometry == nullptr &&
+        request.geometry->path.size() >= RendererSettings::stroke_split_size)
+    {
+      build_stroke(request, &m_jobs);
+    }
+  }
+
+  m_jobs.parallel_for(m_requests.size(), [this](const size_t index, const size_t worker) {
+    build_drawable(m_requests[index], worker == 0 ? m_tiler : m_worker_tilers[worker - 1]);
+  });
+
+  m_stats.tile_time += now_ns() - start;
+  m_stats.requests += m_requests.size();
+  m_stats.drawables += m_queue.size();
+
+  for (QueuedDrawable& queued : m_queue) {
+    if (queued.drawable == nullptr) {
+      DrawRequest& request = m_requests[queued.request_index];
+
+      m_cache->set_bounding_rect(request.id, request.cached_bounding_rect);
+      m_cache->set_geometry(request.id, std::move(request.geometry));
+
+      if (request.stroked) {
+        m_cache->set_stroke(request.id, std::move(request.stroke_geometry));
+        m_stats.strokes++;
+      }
+
+      const Drawable* drawable = m_cache->set_drawable(request.id, std::move(request.drawable));
+
+      if (!request.visible) {
+        continue;
+      }
+
+      queued.drawable = drawable;
+    }
+
+    /* Cached drawables are requested too, so that their textures are not evicted. */
+    request_textures(*queued.drawable);
+
+    m_tiles.push_drawable(queued.drawable);
+  }
+
+  m_textures.resolve();
+  m_textures.trim();
+  m_cache->trim_geometries(RendererSettings::geometry_budget);
+  m_cache->trim_strokes(RendererSettings::stroke_budget);
+
+  m_requests.clear();
+  m_queue.clear();
 }
 
 bool Renderer::draw_multipath(const geom::dcubic_multipath& path,
                               const drect& bounding_rect,
                               const Fill& fill,
                               const std::array<vec2, 4>& texture_coords,
-                              Drawable& drawable)
+                              Tiler& tiler,
+                              Drawable& drawable) const
 {
   drawable.bounding_rect = bounding_rect;
   drawable.valid_rect = bounding_rect;
@@ -530,13 +776,15 @@ bool Renderer::draw_multipath(const geom::dcubic_multipath& path,
   const bool clip = coverage < 0.25;
 
   if (clip) {
-    const double tile_size = m_tiler.tile_size();
+    const double tile_size = tiler.tile_size();
     const drect clip_region = {math::floor(visible.min / tile_size - 2) * tile_size,
                                math::ceil(visible.max / tile_size + 2) * tile_size};
 
     drawable.valid_rect = geom::rect_rect_intersection(clip_region, bounding_rect);
 
-    geom::dcubic_multipath clipped_path = geom::clip(path, clip_region);
+    /* The clipped path is only needed while tiling, so the buffer of the tiler is reused. */
+    geom::dcubic_multipath& clipped_path = tiler.clip_path();
+    geom::clip(path, clip_region, clipped_path);
 
     if (clipped_path.empty()) {
       return false;
@@ -548,13 +796,9 @@ bool Renderer::draw_multipath(const geom::dcubic_multipath& path,
 
     drawable.bounding_rect = clipped_bounding_rect;
 
-    m_tiler.tile(clipped_path, clipped_bounding_rect, fill, clipped_tex_coords, drawable);
+    tiler.tile(clipped_path, clipped_bounding_rect, fill, clipped_tex_coords, drawable);
   } else {
-    m_tiler.tile(path, bounding_rect, fill, texture_coords, drawable);
-  }
-
-  if (fill.paint.is_texture()) {
-    request_texture(fill.paint.id());
+    tiler.tile(path, bounding_rect, fill, texture_coords, drawable);
   }
 
   return true;
@@ -683,39 +927,13 @@ void Renderer::draw_outline_vertices(const geom::dpath& path, const Outline& out
       });
 }
 
-// TODO: error handling
-void Renderer::request_texture(const uuid texture_id)
+void Renderer::request_textures(const Drawable& drawable)
 {
-  if (m_textures.find(texture_id) != m_textures.end()) {
-    return;
-  }
-
-  io::Image image_texture = io::ResourceManager::get_image(texture_id);
-
-  GPU::TextureFormat format;
-
-  switch (image_texture.channels) {
-    case 1:
-      format = GPU::TextureFormat::R8;
-      break;
-    case 3:
-      format = GPU::TextureFormat::RGB8;
-      break;
-    case 4:
-    default:
-      format = GPU::TextureFormat::RGBA8;
-      break;
+  for (const DrawablePaintBinding& binding : drawable.paints) {
+    if (binding.paint_type == Paint::Type::TexturePaint) {
+      m_textures.request(binding.paint_id, drawable.bounding_rect.size() * m_viewport.zoom);
+    }
   }
-
-  GPU::Texture texture = GPU::Texture(format,
-                                      image_texture.size,
-                                      GPU::TextureSamplingFlagRepeatU |
-                                          GPU::TextureSamplingFlagRepeatV |
-                                          GPU::TextureSamplingFlagMipmapMin,
-                                      image_texture.data,
-                                      true);
-
-  m_textures.insert(std::make_pair(texture_id, std::move(texture)));
 }
 
 void Renderer::flush_background_layer()
@@ -727,7 +945,34 @@ void Renderer::flush_background_layer()
 
 void Renderer::flush_scene_layer()
 {
+  flush_requests();
+
+  const size_t start = now_ns();
+
   m_tiles.flush();
+
+  const TiledRenderer::Stats& tiles_stats = m_tiles.stats();
+
+  m_stats.batch_time += now_ns() - start;
+  m_stats.tiles += tiles_stats.tiles;
+  m_stats.tile_bytes += tiles_stats.tile_bytes;
+  m_stats.fills += tiles_stats.fills;
+  m_stats.curves += tiles_stats.curves;
+  m_stats.half_curves += tiles_stats.half_curves;
+  m_stats.shared_curves += tiles_stats.shared_curves;
+  m_stats.batches += tiles_stats.tile_batches + tiles_stats.fill_batches;
+  m_stats.retained_batches += tiles_stats.retained_batches;
+  m_stats.patched_drawables += tiles_stats.patched_drawables;
+  m_stats.culled_tiles += tiles_stats.culled_tiles;
+  m_stats.offscreen_tiles += tiles_stats.offscreen_tiles;
+  m_stats.passes += tiles_stats.passes;
+  m_stats.texture_splits += tiles_stats.texture_splits;
+
+  const TextureCache::Stats& textures_stats = m_textures.stats();
+
+  m_stats.texture_bytes = textures_stats.resident_bytes;
+  m_stats.uploaded_texture_bytes = textures_stats.uploaded_bytes;
+  m_stats.evicted_texture_bytes = textures_stats.evicted_bytes;
 }
 
 void Renderer::flush_ui_layer()
@@ -792,14 +1037,21 @@ void Renderer::__debug_flush_layer(const DebugOptions& options) const
 
 #endif
 
-Renderer::Renderer() : m_instances(GK_LARGE_BUFFER_SIZE), m_tiles(GK_LARGE_BUFFER_SIZE)
+Renderer::Renderer()
+    : m_jobs(std::min(utils::JobSystem::default_workers_count(), RendererSettings::max_workers)),
+      m_worker_tilers(m_jobs.concurrency() - 1),
+      m_instances(GK_LARGE_BUFFER_SIZE),
+      m_tiles(GK_LARGE_BUFFER_SIZE)
 {
   std::unique_ptr<GPU::PrimitiveVertexArray> primitive_vertex_array =
       std::make_unique<GPU::PrimitiveVertexArray>(m_programs.primitive_program,
                                                   m_instances.instance_buffer(),
                                                   m_instances.vertex_buffer());
   std::unique_ptr<GPU::TileVertexArray> tile_vertex_array = std::make_unique<GPU::TileVertexArray>(
-      m_programs.tile_program, m_tiles.tiles_vertex_buffer(), m_tiles.tiles_index_buffer());
+      m_programs.tile_program,
+      m_tiles.tiles_vertex_buffer(),
+      m_tiles.tiles_instance_buffer(),
+      m_tiles.tiles_tex_coords_buffer());
   std::unique_ptr<GPU::FillVertexArray> fill_vertex_array = std::make_unique<GPU::FillVertexArray>(
       m_programs.fill_program, m_tiles.fills_vertex_buffer(), m_tiles.fills_index_buffer());
 
@@ -823,9 +1075,11 @@ Renderer::Renderer() : m_instances(GK_LARGE_BUFFER_SIZE), m_tiles(GK_LARGE_BUFFE
                          &m_programs.fill_program,
                          m_vertex_arrays.tile_vertex_array.get(),
                          m_vertex_arrays.fill_vertex_array.get(),
-                         &m_textures);
+                         m_textures.textures());
 
-  m_textures.insert(std::make_pair(uuid::null, std::move(create_default_texture())));
+  m_textures.set_default_texture(create_default_texture());
 }
 
+Renderer::~Renderer() = default;
+
 }  // namespace graphick::renderer
@@ -8,13 +8,17 @@
 #include "../math/mat2x3.h"
 
 #include "../utils/defines.h"
+#include "../utils/job_system.h"
 
 #include "gpu/shaders.h"
 
 #include "instances.h"
 #include "renderer_data.h"
+#include "texture_cache.h"
 #include "tiles.h"
 
+#include <memory>
+
 namespace graphick::geom {
 template<typename T, typename>
 
@@ -43,6 +47,8 @@ using dpath = geom::Path<double, std::enable_if<true>>;
 
 namespace graphick::renderer {
 
+struct Geometry;
+
 /**
  * @brief The main Graphick renderer.
  *
@@ -60,6 +66,9 @@ namespace graphick::renderer {
  * methods.
  *
  * Takes floats as input, but uses doubles internally for better precision.
+ *
+ * The instance is thread-local: each thread that calls init() owns an independent renderer (and
+ * GPU device), so multiple documents can be rendered concurrently.
  */
 class Renderer {
  public:
@@ -76,6 +85,16 @@ class Renderer {
     return get()->m_viewport.size;
   }
 
+  /**
+   * @brief Returns the statistics of the last rendered frame.
+   *
+   * @return The statistics of the last frame.
+   */
+  inline static const RenderStats& stats()
+  {
+    return get()->m_stats;
+  }
+
   /**
    * @brief Initializes the renderer.
    *
@@ -294,16 +313,29 @@ class Renderer {
 #endif
 
  private:
+  /**
+   * @brief A cache miss collected during the frame, it is tiled when the scene layer is flushed.
+   */
+  struct DrawRequest;
+
+  /**
+   * @brief An entry of the scene layer, drawables are pushed to the tiled renderer in this order.
+   */
+  struct QueuedDrawable {
+    const Drawable* drawable;  // The cached drawable, nullptr if it will be built by a request.
+    size_t request_index;      // The index of the request that builds the drawable.
+  };
+
   /**
    * @brief Default constructor and destructor.
    */
   Renderer();
-  ~Renderer() = default;
+  ~Renderer();
 
   /**
-   * @brief Returns the singleton instance of the renderer.
+   * @brief Returns the instance of the renderer of the calling thread.
    *
-   * @return The singleton instance of the renderer.
+   * @return The instance of the renderer.
    */
   static inline Renderer* get()
   {
@@ -311,20 +343,57 @@ class Renderer {
   }
 
   /**
-   * @brief Draws a transformed Path with the provided Fill and Stroke properties.
+   * @brief Queues the geometry of a path to be drawn with the provided Fill and Stroke properties.
    *
-   * @param path The transformed Path to draw.
-   * @param bounding_rect The bounding rectangle of the path.
+   * The path is tiled and stroked when the scene layer is flushed, see flush_requests().
+   *
+   * @param geometry The render-ready geometry of the path, cached when flushed.
    * @param options The DrawingOptions to use.
    * @param texture_coords The texture coordinates to use for the fill.
-   * @return true if the path was visible and drawn, false otherwise.
+   * @param id The id used for caching.
+   * @return true if the path could be visible, false otherwise.
    */
-  bool draw_transformed(const geom::dpath& path,
-                        const drect& bounding_rect,
+  bool draw_transformed(std::shared_ptr<Geometry> geometry,
                         const DrawingOptions& options,
                         const std::array<vec2, 4>& texture_coords,
                         const uuid id);
 
+  /**
+   * @brief Tries to move the cached drawable of an element to its new transform.
+   *
+   * A uniform scale is only allowed while the error of the stroke width is within tolerance.
+   *
+   * @param transform The new transform of the element.
+   * @param options The DrawingOptions of the element.
+   * @param id The id of the element.
+   * @return Whether the cached drawable was moved, if false the element should be retiled.
+   */
+  bool move_cached_drawable(const mat2x3& transform, const DrawingOptions& options, const uuid id);
+
+  /**
+   * @brief Builds the drawable of a request, strokes and tiles the path.
+   *
+   * This method is thread-safe as long as each thread uses its own tiler.
+   *
+   * @param request The request to build the drawable of.
+   * @param tiler The tiler to use, already set up for the current frame.
+   */
+  void build_drawable(DrawRequest& request, Tiler& tiler) const;
+
+  /**
+   * @brief Builds the stroke outline of a request.
+   *
+   * @param request The request to build the stroke outline of.
+   * @param jobs The job system to split the stroke across, nullptr to stroke on the calling thread.
+   */
+  void build_stroke(DrawRequest& request, utils::JobSystem* jobs) const;
+
+  /**
+   * @brief Builds the drawables of all the queued requests across the job system, caches them and
+   * pushes all the drawables of the frame to the tiled renderer in z-order.
+   */
+  void flush_requests();
+
   /**
    * @brief Draws a cubic multipath with the provided Fill properties.
    *
@@ -332,6 +401,7 @@ class Renderer {
    * @param bounding_rect The bounding rectangle of the path.
    * @param fill The Fill properties to use.
    * @param texture_coords The texture coordinates to use for the fill.
+   * @param tiler The tiler to use.
    * @param drawable The Drawable to use.
    * @return true if the path was visible and drawn, false otherwise.
    */
@@ -339,7 +409,8 @@ class Renderer {
                       const drect& bounding_rect,
                       const Fill& fill,
                       const std::array<vec2, 4>& texture_coords,
-                      Drawable& drawable);
+                      Tiler& tiler,
+                      Drawable& drawable) const;
 
   /**
    * @brief Draws the outline of a path.
@@ -359,11 +430,11 @@ class Renderer {
   void draw_outline_vertices(const geom::dpath& path, const Outline& outline);
 
   /**
-   * @brief If needed, uploads the texture to the GPU.
+   * @brief Makes the textures painted by a drawable resident, at the resolution they are displayed.
    *
-   * @param texture_id The id of the texture stored in the ResourceManager cache.
+   * @param drawable The drawable to request the textures of.
    */
-  void request_texture(const uuid texture_id);
+  void request_textures(const Drawable& drawable);
 
   /**
    * @brief Flushes the background layer.
@@ -409,16 +480,23 @@ class Renderer {
   Viewport m_viewport;                                // The viewport of the renderer.
   Tiler m_tiler;                                      // Takes care of tiling and LOD.
 
-  std::unordered_map<uuid, GPU::Texture> m_textures;  // The textures loaded in the GPU.
+  utils::JobSystem m_jobs;                            // Tiles and strokes the requests.
+  std::vector<Tiler> m_worker_tilers;                 // The tilers of the worker threads.
+
+  std::vector<DrawRequest> m_requests;                // The cache misses of the frame.
+  std::vector<QueuedDrawable> m_queue;                // The drawables of the frame in z-order.
+
+  TextureCache m_textures;                            // The textures resident in the GPU.
 
   InstancedRenderer m_instances;                      // The line instances.
   TiledRenderer m_tiles;                              // The tiles renderer.
 
-  UIOptions m_ui_options;       // The UI options (i.e. handle size, colors, etc.).
+  UIOptions m_ui_options;                    // The UI options (i.e. handle size, colors, etc.).
 
-  RendererCache* m_cache;       // The cache to use for the renderer.
+  RendererCache* m_cache;                    // The cache to use for the renderer.
+  RenderStats m_stats;                       // The statistics of the last frame.
  private:
-  static Renderer* s_instance;  // The singleton instance of the renderer.
+  static thread_local Renderer* s_instance;  // The instance of the renderer of this thread.
 };
 
 }  // namespace graphick::renderer
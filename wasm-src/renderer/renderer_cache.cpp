@@ -5,8 +5,11 @@
 
 #include "renderer_cache.h"
 
+#include "../math/matrix.h"
 #include "../math/vector.h"
 
+#include <algorithm>
+
 namespace graphick::renderer {
 
 void RendererCache::clear()
@@ -16,6 +19,58 @@ void RendererCache::clear()
   }
 }
 
+void RendererCache::trim_geometries(const size_t budget)
+{
+  if (m_geometries_memory <= budget) {
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, uuid>> entries;
+  entries.reserve(m_geometries.size());
+
+  for (const auto& [id, entry] : m_geometries) {
+    entries.emplace_back(entry.last_used, id);
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  for (const auto& [last_used, id] : entries) {
+    if (m_geometries_memory <= budget) {
+      break;
+    }
+
+    erase_geometry(id);
+  }
+}
+
+void RendererCache::trim_strokes(const size_t budget)
+{
+  if (m_strokes_memory <= budget) {
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, uuid>> entries;
+  entries.reserve(m_strokes.size());
+
+  for (const auto& [id, entry] : m_strokes) {
+    entries.emplace_back(entry.last_used, id);
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  for (const auto& [last_used, id] : entries) {
+    if (m_strokes_memory <= budget) {
+      break;
+    }
+
+    erase_stroke(id);
+  }
+}
+
 void RendererCache::set_grid_rect(const rect grid_rect, const ivec2 subdivisions)
 {
   m_subdivisions = subdivisions;
@@ -51,4 +106,111 @@ void RendererCache::invalidate_rect(const rect invalidated_rect)
   }
 }
 
+bool RendererCache::move_drawable(uuid id,
+                                  const mat2x3& transform,
+                                  const double max_scale_change,
+                                  const double max_error,
+                                  const double stroke_width)
+{
+  const auto drawable_it = m_drawables.find(id);
+
+  if (drawable_it == m_drawables.end()) {
+    return false;
+  }
+
+  auto rect_it = m_bounding_rects.find(id);
+
+  if (rect_it == m_bounding_rects.end()) {
+    rect_it = m_moved_bounding_rects.find(id);
+
+    if (rect_it == m_moved_bounding_rects.end()) {
+      return false;
+    }
+  }
+
+  Drawable& drawable = drawable_it->second;
+
+  const dmat2x3 delta = dmat2x3(transform) * math::inverse(dmat2x3(drawable.transform));
+  const double scale = (delta[0][0] + delta[1][1]) * 0.5;
+
+  if (scale <= 0.0 || std::abs(scale - 1.0) > max_scale_change) {
+    return false;
+  }
+
+  /* Rotation, shear and non-uniform scaling are ignored, the resulting displacement of the
+   * farthest vertex is accumulated as error, together with the rounding error of the move. */
+
+  const dvec2 translation = {delta[0][2], delta[1][2]};
+  const drect bounding_rect = {rect_it->second.min * scale + translation,
+                               rect_it->second.max * scale + translation};
+
+  const dvec2 max_coords = math::max(math::abs(drawable.bounding_rect.min),
+                                     math::abs(drawable.bounding_rect.max));
+  const dvec2 moved_max_coords = math::abs(max_coords * scale) + math::abs(translation);
+  const double deviation = std::abs(delta[0][0] - scale) + std::abs(delta[0][1]) +
+                           std::abs(delta[1][0]) + std::abs(delta[1][1] - scale);
+
+  const double error = drawable.transform_error * scale +
+                       deviation * (max_coords.x + max_coords.y) +
+                       std::max(moved_max_coords.x, moved_max_coords.y) * math::epsilon<float>;
+
+  /* The width error doesn't accumulate with the moves, it only depends on the total scale. Many
+   * small scale changes (e.g. dragging a handle) would otherwise never retile the stroke. */
+
+  const double moved_scale = drawable.moved_scale * scale;
+  const double width_error = std::abs(moved_scale - 1.0) * stroke_width;
+
+  if (error + width_error > max_error) {
+    return false;
+  }
+
+  drawable.move(scale, translation);
+  drawable.transform = transform;
+  drawable.transform_error = error;
+  drawable.moved_scale = moved_scale;
+  drawable.revision = ++s_revision;
+
+  set_bounding_rect(id, bounding_rect);
+
+  return true;
+}
+
+bool RendererCache::update_LOD(uuid id, const double priority)
+{
+  if (m_scheduled_LODs.erase(id)) {
+    return true;
+  }
+
+  m_stale_LODs.push_back({priority, id});
+
+  return false;
+}
+
+size_t RendererCache::schedule_LOD_updates(const size_t budget)
+{
+  /* Ties are broken by id, so the schedule only depends on the scene and the viewport. */
+
+  const size_t count = std::min(budget, m_stale_LODs.size());
+
+  std::partial_sort(m_stale_LODs.begin(),
+                    m_stale_LODs.begin() + count,
+                    m_stale_LODs.end(),
+                    [](const auto& a, const auto& b) {
+                      return a.first > b.first ||
+                             (a.first == b.first && uint64_t(a.second) < uint64_t(b.second));
+                    });
+
+  m_scheduled_LODs.clear();
+
+  for (size_t i = 0; i < count; i++) {
+    m_scheduled_LODs.insert(m_stale_LODs[i].second);
+  }
+
+  const size_t stale_LODs = m_stale_LODs.size();
+
+  m_stale_LODs.clear();
+
+  return stale_LODs;
+}
+
 }  // namespace graphick::renderer
@@ -16,9 +16,13 @@
 #include "../utils/console.h"
 
 #include "drawable.h"
+#include "geometry.h"
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace graphick::renderer {
@@ -43,7 +47,36 @@ class RendererCache {
   inline void clear(uuid id)
   {
     m_bounding_rects.erase(id);
+    m_moved_bounding_rects.erase(id);
     m_drawables.erase(id);
+
+    erase_geometry(id);
+    erase_stroke(id);
+  }
+
+  /**
+   * @brief Clears the cache of an element whose transform changed.
+   *
+   * The drawable is kept, so that it can be moved to the new transform instead of being retiled.
+   *
+   * @param id The id of the element to clear.
+   */
+  inline void clear_transform(uuid id)
+  {
+    erase_geometry(id);
+    erase_stroke(id);
+
+    const auto it = m_bounding_rects.find(id);
+
+    if (it == m_bounding_rects.end()) {
+      return;
+    }
+
+    if (has_drawable(id)) {
+      m_moved_bounding_rects.insert(*it);
+    }
+
+    m_bounding_rects.erase(it);
   }
 
   /**
@@ -95,6 +128,7 @@ class RendererCache {
   inline void set_bounding_rect(uuid id, const drect& bounding_rect)
   {
     m_bounding_rects[id] = bounding_rect;
+    m_moved_bounding_rects.erase(id);
   }
 
   inline bool has_bounding_rect(uuid id) const
@@ -109,6 +143,8 @@ class RendererCache {
 
   inline const Drawable* set_drawable(uuid id, Drawable&& drawable)
   {
+    drawable.revision = ++s_revision;
+
     return &(m_drawables[id] = std::move(drawable));
   }
 
@@ -117,15 +153,241 @@ class RendererCache {
     return m_drawables.find(id) != m_drawables.end();
   }
 
+  /**
+   * @brief Gets the cached geometry of an element, if it was built with the given transform.
+   *
+   * @param id The id of the element.
+   * @param transform The current transform of the element.
+   * @return The cached geometry, nullptr if not cached or outdated.
+   */
+  inline std::shared_ptr<Geometry> get_geometry(uuid id, const mat2x3& transform)
+  {
+    const auto it = m_geometries.find(id);
+
+    if (it == m_geometries.end() || it->second.geometry->transform != transform) {
+      return nullptr;
+    }
+
+    it->second.last_used = ++m_geometries_clock;
+
+    return it->second.geometry;
+  }
+
+  /**
+   * @brief Caches the geometry of an element, replacing the previous one.
+   *
+   * @param id The id of the element.
+   * @param geometry The geometry to cache.
+   */
+  inline void set_geometry(uuid id, std::shared_ptr<Geometry> geometry)
+  {
+    const auto it = m_geometries.find(id);
+
+    if (it != m_geometries.end() && it->second.geometry == geometry) {
+      it->second.last_used = ++m_geometries_clock;
+      return;
+    }
+
+    erase_geometry(id);
+
+    m_geometries_memory += geometry->memory();
+    m_geometries.insert({id, GeometryEntry{std::move(geometry), ++m_geometries_clock}});
+  }
+
+  /**
+   * @brief Gets the approximate memory used by the cached geometries.
+   *
+   * @return The number of bytes used by the cached geometries.
+   */
+  inline size_t geometries_memory() const
+  {
+    return m_geometries_memory;
+  }
+
+  /**
+   * @brief Evicts the least recently used geometries until the budget is met.
+   *
+   * The drawables tiled from an evicted geometry stay cached, the geometry is built again only
+   * if they have to be retiled.
+   *
+   * @param budget The maximum number of bytes of the cached geometries.
+   */
+  void trim_geometries(const size_t budget);
+
+  /**
+   * @brief Gets the cached stroke outline of an element, if it was built with the given transform
+   * and options, and marks it as recently used.
+   *
+   * The outline is removed whenever the path of the element changes, see clear().
+   *
+   * @param id The id of the element.
+   * @param transform The current transform of the element.
+   * @param options The current stroking options of the element.
+   * @return The cached outline, nullptr if not cached or outdated.
+   */
+  inline std::shared_ptr<const StrokeGeometry> get_stroke(
+      uuid id, const mat2x3& transform, const geom::StrokingOptions<double>& options)
+  {
+    const auto it = m_strokes.find(id);
+
+    if (it == m_strokes.end() || !it->second.stroke->matches(transform, options)) {
+      return nullptr;
+    }
+
+    it->second.last_used = ++m_strokes_clock;
+
+    return it->second.stroke;
+  }
+
+  /**
+   * @brief Caches the stroke outline of an element, replacing the previous one.
+   *
+   * @param id The id of the element.
+   * @param stroke The outline to cache.
+   */
+  inline void set_stroke(uuid id, std::shared_ptr<const StrokeGeometry> stroke)
+  {
+    erase_stroke(id);
+
+    m_strokes_memory += stroke->memory();
+    m_strokes.insert({id, StrokeEntry{std::move(stroke), ++m_strokes_clock}});
+  }
+
+  /**
+   * @brief Gets the approximate memory used by the cached stroke outlines.
+   *
+   * @return The number of bytes used by the cached outlines.
+   */
+  inline size_t strokes_memory() const
+  {
+    return m_strokes_memory;
+  }
+
+  /**
+   * @brief Evicts the least recently used stroke outlines until the budget is met.
+   *
+   * @param budget The maximum number of bytes of the cached outlines.
+   */
+  void trim_strokes(const size_t budget);
+
+  /**
+   * @brief Moves the cached drawable of an element to a new transform without retiling it.
+   *
+   * Only a uniform scale followed by a translation can be applied to a drawable, the deviation of
+   * the transform delta from such a transform is accounted as error. A stroke is built after
+   * transforming the path, so scaling it also scales its width: the width error of the total scale
+   * applied since the drawable was tiled is accounted as error too.
+   *
+   * @param id The id of the element.
+   * @param transform The new transform of the element.
+   * @param max_scale_change The maximum allowed change of the scale factor, relative to 1.
+   * @param max_error The maximum error allowed in the vertex positions, in scene units.
+   * @param stroke_width The width of the stroke of the element, 0 if not stroked.
+   * @return Whether the drawable was moved, if false the element should be retiled.
+   */
+  bool move_drawable(uuid id,
+                     const mat2x3& transform,
+                     const double max_scale_change,
+                     const double max_error,
+                     const double stroke_width);
+
+  /**
+   * @brief Checks whether a cached drawable with an outdated LOD should be retiled this frame.
+   *
+   * Drawables that are not retiled are recorded as stale and ranked by priority at the end of the
+   * frame, the highest ranked ones are retiled in the next frame.
+   *
+   * @param id The id of the element.
+   * @param priority The priority of the update (i.e. the visible area of the drawable).
+   * @return Whether the drawable should be retiled.
+   */
+  bool update_LOD(uuid id, const double priority);
+
+  /**
+   * @brief Schedules the LOD updates of the next frame.
+   *
+   * This method should be called at the end of each frame.
+   *
+   * @param budget The maximum number of drawables to retile in the next frame.
+   * @return The number of drawables that were drawn with an outdated LOD in the last frame.
+   */
+  size_t schedule_LOD_updates(const size_t budget);
+
+ private:
+  /**
+   * @brief A cached geometry.
+   */
+  struct GeometryEntry {
+    std::shared_ptr<Geometry> geometry;  // The geometry.
+    uint64_t last_used;                  // The last time the geometry was requested.
+  };
+
+  /**
+   * @brief A cached stroke outline.
+   */
+  struct StrokeEntry {
+    std::shared_ptr<const StrokeGeometry> stroke;  // The outline.
+    uint64_t last_used;                            // The last time the outline was requested.
+  };
+ private:
+  /**
+   * @brief Removes the cached geometry of an element, if any.
+   *
+   * @param id The id of the element.
+   */
+  inline void erase_geometry(uuid id)
+  {
+    const auto it = m_geometries.find(id);
+
+    if (it == m_geometries.end()) {
+      return;
+    }
+
+    m_geometries_memory -= it->second.geometry->memory();
+    m_geometries.erase(it);
+  }
+
+  /**
+   * @brief Removes the cached stroke outline of an element, if any.
+   *
+   * @param id The id of the element.
+   */
+  inline void erase_stroke(uuid id)
+  {
+    const auto it = m_strokes.find(id);
+
+    if (it == m_strokes.end()) {
+      return;
+    }
+
+    m_strokes_memory -= it->second.stroke->memory();
+    m_strokes.erase(it);
+  }
+
  private:
   std::unordered_map<uuid, drect> m_bounding_rects;  // The bounding rectangles of the paths.
   std::unordered_map<uuid, Drawable> m_drawables;    // The drawables.
 
+  std::unordered_map<uuid, drect> m_moved_bounding_rects;  // The bounding rects of moved elements.
+
+  std::unordered_map<uuid, GeometryEntry> m_geometries;  // Render-ready paths.
+  size_t m_geometries_memory = 0;                        // The bytes used by the geometries.
+  uint64_t m_geometries_clock = 0;                       // Incremented when a geometry is used.
+
+  std::unordered_map<uuid, StrokeEntry> m_strokes;  // Render-ready stroke outlines.
+  size_t m_strokes_memory = 0;                      // The memory used by the outlines, in bytes.
+  uint64_t m_strokes_clock = 0;                     // Incremented whenever an outline is used.
+
   std::vector<bool> m_grid;  // When an action is performed, some grid cells are invalidated.
   std::vector<rect> m_invalid_rects;  // The invalid rectangles.
 
   ivec2 m_subdivisions;               // The number of subdivisions in the grid.
   rect m_grid_rect;                   // The portion of the screen that is cached.
+
+  std::vector<std::pair<double, uuid>> m_stale_LODs;  // The stale drawables of the current frame.
+  std::unordered_set<uuid> m_scheduled_LODs;          // The drawables to retile this frame.
+ private:
+  inline static std::atomic<uint64_t> s_revision = 0;  // Shared, so that revisions are unique.
 };
 
 }  // namespace graphick::renderer
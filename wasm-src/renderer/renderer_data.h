@@ -181,4 +181,37 @@ struct UIOptions {
   UIOptions() : UIOptions(1.0) {}
 };
 
+/**
+ * @brief The statistics of the last rendered frame, timings are in nanoseconds.
+ */
+struct RenderStats {
+  size_t drawables = 0;      // The number of drawables of the scene layer.
+  size_t requests = 0;       // The number of drawables that were tiled (cache misses).
+  size_t strokes = 0;        // The number of stroke outlines built (cache misses).
+  size_t stale_LODs = 0;     // The number of drawables drawn with an outdated LOD.
+
+  size_t tiles = 0;          // The number of tiles drawn.
+  size_t tile_bytes = 0;     // The bytes uploaded for the tiles, curves excluded.
+  size_t fills = 0;          // The number of fill quads drawn.
+  size_t curves = 0;         // The number of curves uploaded with the tiles.
+  size_t half_curves = 0;    // The number of uploaded curves stored with half precision.
+  size_t shared_curves = 0;  // The number of curves reused from equal drawables of the batch.
+  size_t batches = 0;        // The number of draw calls of the scene layer (tiles and fills).
+
+  size_t retained_batches = 0;   // The number of draw calls replayed from the last frame.
+  size_t patched_drawables = 0;  // The number of changed drawables patched into the batches.
+  size_t culled_tiles = 0;       // The number of tiles hidden by nearer opaque fills.
+  size_t offscreen_tiles = 0;    // The number of tiles dropped outside of the viewport.
+  size_t passes = 0;             // The number of tile passes, each one swaps the framebuffers.
+  size_t texture_splits = 0;     // The number of batches split because the textures were full.
+
+  size_t texture_bytes = 0;           // The bytes of the textures resident in the GPU.
+  size_t uploaded_texture_bytes = 0;  // The bytes of the textures uploaded in the frame.
+  size_t evicted_texture_bytes = 0;   // The bytes of the textures evicted in the frame.
+
+  size_t tile_time = 0;      // The time spent stroking and tiling the requests.
+  size_t batch_time = 0;     // The CPU time spent building and submitting the batches.
+  size_t gpu_time = 0;       // The time spent by the device executing the commands of the frame.
+};
+
 }  // namespace graphick::renderer
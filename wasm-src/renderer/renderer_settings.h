@@ -7,6 +7,9 @@
 
 #include "../math/vec4.h"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace graphick::renderer {
 
 /**
@@ -17,7 +20,19 @@ namespace graphick::renderer {
 struct RendererSettings {
   inline static double flattening_tolerance = 0.25;  // Pixel accuracy of path flattening.
   inline static double stroking_tolerance = 1e-4;    // Accuracy of the path stroking algorithm.
+  inline static bool half_curves = false;            // Store precise enough curves as RGBA16F.
+  inline static double half_curves_error = 0.02;     // Max pixel error of half precision curves.
   inline static double tile_size = 16.0;             // The target pixel size of the tiles.
+  inline static size_t LOD_updates_per_frame = 32;   // Max drawables retiled to a close LOD.
+  inline static double move_tolerance = 0.1;         // Pixel accuracy of moved cached drawables.
+  inline static double move_scale_change = 0.25;     // Max scale change of moved drawables.
+  inline static size_t max_workers = SIZE_MAX;       // Max worker threads per renderer and device.
+  inline static bool retained_batches = true;        // Replay the batches of unchanged frames.
+  inline static bool cull_occluded_tiles = true;     // Skip the tiles hidden by opaque fills.
+  inline static size_t texture_budget = 256 << 20;   // Max bytes of the resident textures.
+  inline static size_t geometry_budget = 64 << 20;   // Max bytes of the cached geometries.
+  inline static size_t stroke_budget = 64 << 20;     // Max bytes of the cached stroke outlines.
+  inline static size_t stroke_split_size = 4096;     // Min segments to split a stroke on workers.
 
   inline static double ui_handle_size = 5.0;         // The typical size of the UI handles.
   inline static double ui_line_width = 1.0;          // The width of the UI lines.
@@ -0,0 +1,199 @@
+/**
+ * @file renderer/texture_cache.cpp
+ * @brief This file contains the implementation of the TextureCache class.
+ */
+
+#include "texture_cache.h"
+
+#include "../io/resource_manager.h"
+
+#include "renderer_settings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace graphick::renderer {
+
+/**
+ * @brief The maximum number of times the size of an image is halved.
+ */
+static constexpr uint8_t max_texture_level = 15;
+
+/**
+ * @brief Calculates the bytes of a texture, mipmaps included.
+ *
+ * @param size The size of the texture.
+ * @param channels The number of channels of the texture.
+ * @return The bytes of the texture.
+ */
+static inline size_t texture_bytes(const ivec2 size, const uint8_t channels)
+{
+  return static_cast<size_t>(size.x) * size.y * channels * 4 / 3;
+}
+
+/**
+ * @brief Calculates the number of times an image can be halved while staying larger than the
+ * area it is displayed in.
+ *
+ * @param image_size The size of the image.
+ * @param display_size The size of the painted area in pixels.
+ * @return The number of times the image size can be halved.
+ */
+static uint8_t texture_level(const ivec2 image_size, const dvec2 display_size)
+{
+  const double ratio = std::min(image_size.x / std::max(display_size.x, 1.0),
+                                image_size.y / std::max(display_size.y, 1.0));
+
+  if (!(ratio >= 2.0)) {
+    return 0;
+  }
+
+  const int max_level = static_cast<int>(std::log2(std::max(image_size.x, image_size.y)));
+  const int level = static_cast<int>(std::floor(std::log2(ratio)));
+
+  return static_cast<uint8_t>(std::min({level, max_level, int(max_texture_level)}));
+}
+
+void TextureCache::set_default_texture(GPU::Texture&& texture)
+{
+  m_textures.erase(uuid::null);
+  m_textures.insert(std::make_pair(uuid::null, std::move(texture)));
+}
+
+void TextureCache::begin_frame()
+{
+  m_frame++;
+
+  m_stats.uploaded_bytes = 0;
+  m_stats.evicted_bytes = 0;
+}
+
+void TextureCache::request(const uuid texture_id, const dvec2 display_size)
+{
+  /* Until the image is decoded, the drawables are painted with the default texture. */
+  if (!io::ResourceManager::is_image_ready(texture_id)) {
+    return;
+  }
+
+  const ivec2 image_size = io::ResourceManager::get_image_size(texture_id);
+  const uint8_t level = texture_level(image_size, display_size);
+
+  /* Drawables sharing an image are painted with the finest level any of them needs. */
+  const auto [it, inserted] = m_requests.insert(std::make_pair(texture_id, level));
+
+  if (!inserted) {
+    it->second = std::min(it->second, level);
+  }
+}
+
+void TextureCache::resolve()
+{
+  for (const auto& [texture_id, level] : m_requests) {
+    upload(texture_id, level);
+  }
+
+  m_requests.clear();
+}
+
+void TextureCache::upload(const uuid texture_id, const uint8_t level)
+{
+  const auto it = m_entries.find(texture_id);
+
+  if (it != m_entries.end()) {
+    it->second.last_used = m_frame;
+
+    /* Shrinking only below a quarter of the pixels avoids uploading again at each zoom step. */
+    if (level >= it->second.level && level <= it->second.level + 1) {
+      return;
+    }
+  }
+
+  /* The level is decoded in the background, until then the decoded level, if any, is drawn. */
+  const io::Image image = io::ResourceManager::get_image(texture_id, level);
+
+  if (image.data == nullptr) {
+    return;
+  }
+
+  if (it != m_entries.end()) {
+    if (image.level == it->second.level) {
+      return;
+    }
+
+    m_stats.resident_bytes -= it->second.bytes;
+    m_textures.erase(texture_id);
+    m_entries.erase(it);
+  }
+
+  GPU::TextureFormat format;
+
+  switch (image.channels) {
+    case 1:
+      format = GPU::TextureFormat::R8;
+      break;
+    case 3:
+      format = GPU::TextureFormat::RGB8;
+      break;
+    case 4:
+    default:
+      format = GPU::TextureFormat::RGBA8;
+      break;
+  }
+
+  GPU::Texture texture = GPU::Texture(format,
+                                      image.size,
+                                      GPU::TextureSamplingFlagRepeatU |
+                                          GPU::TextureSamplingFlagRepeatV |
+                                          GPU::TextureSamplingFlagMipmapMin,
+                                      image.data,
+                                      true);
+
+  const size_t bytes = texture_bytes(image.size, image.channels);
+
+  m_textures.insert(std::make_pair(texture_id, std::move(texture)));
+  m_entries.insert(std::make_pair(texture_id, Entry{bytes, image.level, m_frame}));
+
+  m_stats.resident_bytes += bytes;
+  m_stats.uploaded_bytes += bytes;
+
+  /* The GPU copy is enough to draw, the image is decoded again if it has to be uploaded. */
+  if (image.level == level) {
+    io::ResourceManager::release_image_data(texture_id);
+  }
+}
+
+void TextureCache::trim()
+{
+  if (m_stats.resident_bytes <= RendererSettings::texture_budget) {
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, uuid>> unused;
+
+  for (const auto& [texture_id, entry] : m_entries) {
+    if (entry.last_used < m_frame) {
+      unused.push_back(std::make_pair(entry.last_used, texture_id));
+    }
+  }
+
+  std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  for (const auto& [_, texture_id] : unused) {
+    if (m_stats.resident_bytes <= RendererSettings::texture_budget) {
+      break;
+    }
+
+    const auto it = m_entries.find(texture_id);
+
+    m_stats.resident_bytes -= it->second.bytes;
+    m_stats.evicted_bytes += it->second.bytes;
+
+    m_textures.erase(texture_id);
+    m_entries.erase(it);
+  }
+}
+
+}  // namespace graphick::renderer
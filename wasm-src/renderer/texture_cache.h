@@ -0,0 +1,126 @@
+/**
+ * @file renderer/texture_cache.h
+ * @brief This file contains the definition of the TextureCache class.
+ */
+
+#pragma once
+
+#include "../math/vec2.h"
+
+#include "../utils/uuid.h"
+
+#include "gpu/render_state.h"
+
+#include <unordered_map>
+
+namespace graphick::renderer {
+
+/**
+ * @brief The TextureCache class keeps the image textures resident in the GPU within a budget.
+ *
+ * Each texture is uploaded at the resolution it is displayed at, picked from the zoom and the
+ * size of the drawables that paint it, rounded to a power of two fraction of the image size.
+ * When the resident textures exceed RendererSettings::texture_budget, the least recently used
+ * ones are evicted. Once a texture is resident, the decoded pixels of the image are released
+ * from the ResourceManager. When the texture has to be uploaded at another resolution, the image
+ * is decoded and downsampled again in the background, and the resident texture is drawn until
+ * then.
+ */
+class TextureCache {
+ public:
+  /**
+   * @brief The texture memory counters, in bytes.
+   */
+  struct Stats {
+    size_t resident_bytes = 0;  // The bytes of the resident textures, mipmaps included.
+    size_t uploaded_bytes = 0;  // The bytes uploaded in the frame.
+    size_t evicted_bytes = 0;   // The bytes evicted in the frame.
+  };
+ public:
+  /**
+   * @brief Gets the map of the resident textures, it always contains the default texture.
+   *
+   * @return A pointer to the map of the textures.
+   */
+  inline std::unordered_map<uuid, GPU::Texture>* textures()
+  {
+    return &m_textures;
+  }
+
+  /**
+   * @brief Gets the texture memory counters, the frame counters are reset by begin_frame().
+   *
+   * @return The texture memory counters.
+   */
+  inline const Stats& stats() const
+  {
+    return m_stats;
+  }
+
+  /**
+   * @brief Sets the texture drawn in place of missing textures, it is never evicted.
+   *
+   * @param texture The default texture.
+   */
+  void set_default_texture(GPU::Texture&& texture);
+
+  /**
+   * @brief Starts a new frame, textures requested from now on are used by it.
+   */
+  void begin_frame();
+
+  /**
+   * @brief Requests a texture at the resolution it is displayed at, it is uploaded by resolve().
+   *
+   * When more drawables paint the same image, the finest resolution requested in the frame is
+   * used, so that each image is decoded and uploaded at most once per frame.
+   *
+   * @param texture_id The id of the image stored in the ResourceManager cache.
+   * @param display_size The size of the painted area in pixels.
+   */
+  void request(const uuid texture_id, const dvec2 display_size);
+
+  /**
+   * @brief Makes the textures requested in the frame resident.
+   *
+   * A resident texture is uploaded again only if it is displayed at more than its resolution,
+   * or at less than a quarter of it.
+   */
+  void resolve();
+
+  /**
+   * @brief Evicts the least recently used textures until the budget is met.
+   *
+   * Textures requested in the current frame are never evicted, so the budget can be exceeded.
+   */
+  void trim();
+ private:
+  /**
+   * @brief Makes a texture resident at the given level, uploading it if needed.
+   *
+   * If the image is not decoded at that level yet, the image is uploaded at the level it is
+   * decoded at, if it is not resident already.
+   *
+   * @param texture_id The id of the image stored in the ResourceManager cache.
+   * @param level The number of times the image size is halved.
+   */
+  void upload(const uuid texture_id, const uint8_t level);
+ private:
+  /**
+   * @brief The residency state of a texture.
+   */
+  struct Entry {
+    size_t bytes;        // The bytes of the texture, mipmaps included.
+    uint8_t level;       // The image size is halved level times.
+    uint64_t last_used;  // The last frame the texture was requested in.
+  };
+ private:
+  std::unordered_map<uuid, GPU::Texture> m_textures;  // The resident textures.
+  std::unordered_map<uuid, Entry> m_entries;          // The state of the resident textures.
+  std::unordered_map<uuid, uint8_t> m_requests;       // The finest level requested per image.
+
+  uint64_t m_frame = 0;                               // The current frame.
+  Stats m_stats;                                      // The texture memory counters.
+};
+
+}  // namespace graphick::renderer
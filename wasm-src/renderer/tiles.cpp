@@ -2,7 +2,6 @@
  * @file renderer/tiles.cpp
  * @brief The file contains the implementation of the Tiler class.
  *
- * @todo when setting semi-valid/invalid, iterate over tiles (only tiles!), not entire bounding box
  * @todo different workflow for paths spanning less than 2x2 tiles
  * @todo different workflow for strokes with width less than twice (or 1.5x) the tile size
  * @todo find optimal tile size for a given zoom level
@@ -26,6 +25,11 @@
 
 namespace graphick::renderer {
 
+/**
+ * @brief The tolerance of the occlusion cells, in cells, to absorb the rounding of moved quads.
+ */
+static constexpr double occlusion_tolerance = 1e-4;
+
 std::array<vec2, 4> reproject_texture_coords(const drect bounding_rect,
                                              const drect clipped_rect,
                                              const std::array<vec2, 4>& texture_coords,
@@ -94,17 +98,21 @@ void Tiler::tile(const geom::dcubic_multipath& path,
                           uvec4(fill.paint.color() * drawable.appearance.opacity * 255.0f) :
                           uvec4(vec4(1.0, 1.0, 1.0, drawable.appearance.opacity) * 255.0f);
 
-  const uint32_t attr_1 = TileVertex::create_attr_1(0, fill.paint.type(), drawable.curves.size());
-  const uint32_t attr_2 = TileVertex::create_attr_2(
+  const uint32_t attr_1 = TileInstance::create_attr_1(
+      0, fill.paint.type(), drawable.curves.size());
+  const uint32_t attr_2 = TileInstance::create_attr_2(
       0, CurvesType::Cubic, fill.rule == FillRule::EvenOdd, 0);
-  const uint32_t attr_2_fill = TileVertex::create_attr_2(
+  const uint32_t attr_2_half = TileInstance::create_attr_2(
+      0, CurvesType::CubicHalf, fill.rule == FillRule::EvenOdd, 0);
+  const uint32_t attr_2_fill = TileInstance::create_attr_2(
       0, CurvesType::None, fill.rule == FillRule::EvenOdd, 0);
 
-  const dvec2 bounds_size = bounding_rect.size();
-
   const bool create_fills = fill.paint.is_color() && color.a == 255 &&
                             drawable.appearance.blending == BlendingMode::Normal;
 
+  /* Only texture paints read the texture coordinates of the tiles. */
+  const bool push_tex_coords = fill.paint.is_texture();
+
   /* Setting up the workspace, a 1 cell padding in all directions is applied. */
 
   const ivec2 path_start_cell = ivec2(math::floor(bounding_rect.min / m_cell_size)) - 1;
@@ -272,35 +280,22 @@ void Tiler::tile(const geom::dcubic_multipath& path,
               m_cells.intersections(y).end(),
               [](const Intersection a, const Intersection b) { return a.x > b.x; });
 
-    uint32_t row_curves_offset = drawable.curves.size() / 2;
-    uint16_t row_curves_count = m_cells[y].size();
-
-    std::vector<uint16_t> curves;
-
-    curves.assign(m_cells[y].begin(), m_cells[y].end());
-
-    std::sort(curves.begin(), curves.end(), [&](const uint16_t a, const uint16_t b) {
-      return m_curves_max[a] > m_curves_max[b];
-    });
+    const std::vector<uint16_t>& curves = m_cells.sort_and_unique(y, m_curves_max);
+    const uint16_t row_curves_count = curves.size();
 
     const int hash = math::hash(curves, 0, curves.size());
     auto it = m_curves_map.find(hash);
 
     if (it == m_curves_map.end()) {
-      m_curves_map[hash] = row_curves_offset;
-
-      for (const uint16_t i : curves) {
-        const vec2 p0 = vec2((path[i] - bounding_rect.min) / bounds_size);
-        const vec2 p1 = vec2((path[i + 1] - bounding_rect.min) / bounds_size);
-        const vec2 p2 = vec2((path[i + 2] - bounding_rect.min) / bounds_size);
-        const vec2 p3 = vec2((path[i + 3] - bounding_rect.min) / bounds_size);
-
-        drawable.curves.insert(drawable.curves.end(), {p0, p1, p2, p3});
-      }
-    } else {
-      row_curves_offset = it->second;
+      const RowCurves row_curves = push_row_curves(path, curves, bounding_rect, drawable);
+      it = m_curves_map.emplace(hash, row_curves).first;
     }
 
+    const RowCurves row_curves = it->second;
+    const uint32_t row_attr_1 = TileInstance::create_attr_1(
+        0, fill.paint.type(), row_curves.offset);
+    const uint32_t row_attr_2 = row_curves.half ? attr_2_half : attr_2;
+
     for (int x = path_cell_count.x - 1; x >= 0; x--) {
       if (!m_cells.is_tile(x, y)) {
         if (tile_start > -1) {
@@ -317,20 +312,22 @@ void Tiler::tile(const geom::dcubic_multipath& path,
               tex_coord_curves_min,
               tex_coord_curves_max);
 
-          const uint32_t attr_1 = TileVertex::create_attr_1(
-              0, fill.paint.type(), row_curves_offset);
-          const uint32_t attr_3 = TileVertex::create_attr_3(tile_start_winding, row_curves_count);
+          const uint32_t attr_3 = TileInstance::create_attr_3(tile_start_winding,
+                                                              row_curves_count);
 
           drawable.push_tile(vec2(cell_min),
                              vec2(cell_max),
-                             tex_coord_curves_min,
-                             tex_coord_curves_max,
-                             transformed_tex_coords,
+                             (tex_coord_curves_min - row_curves.origin) * row_curves.scale,
+                             (tex_coord_curves_max - row_curves.origin) * row_curves.scale,
                              color,
-                             attr_1,
-                             attr_2,
+                             row_attr_1,
+                             row_attr_2,
                              attr_3);
 
+          if (push_tex_coords) {
+            drawable.push_tile_tex_coords(transformed_tex_coords);
+          }
+
           tile_start = -1;
         }
 
@@ -358,11 +355,14 @@ void Tiler::tile(const geom::dcubic_multipath& path,
                                  vec2(cell_max),
                                  vec2::zero(),
                                  vec2::zero(),
-                                 transformed_tex_coords,
                                  color,
                                  attr_1,
                                  attr_2_fill,
                                  0);
+
+              if (push_tex_coords) {
+                drawable.push_tile_tex_coords(transformed_tex_coords);
+              }
             }
           }
 
@@ -400,19 +400,21 @@ void Tiler::tile(const geom::dcubic_multipath& path,
           tex_coord_curves_min,
           tex_coord_curves_max);
 
-      const uint32_t attr_1 = TileVertex::create_attr_1(0, fill.paint.type(), row_curves_offset);
-      const uint32_t attr_3 = TileVertex::create_attr_3(tile_start_winding, row_curves_count);
+      const uint32_t attr_3 = TileInstance::create_attr_3(tile_start_winding, row_curves_count);
 
       drawable.push_tile(vec2(cell_min),
                          vec2(cell_max),
-                         tex_coord_curves_min,
-                         tex_coord_curves_max,
-                         transformed_tex_coords,
+                         (tex_coord_curves_min - row_curves.origin) * row_curves.scale,
+                         (tex_coord_curves_max - row_curves.origin) * row_curves.scale,
                          color,
-                         attr_1,
-                         attr_2,
+                         row_attr_1,
+                         row_attr_2,
                          attr_3);
 
+      if (push_tex_coords) {
+        drawable.push_tile_tex_coords(transformed_tex_coords);
+      }
+
       tile_start = -1;
     }
 
@@ -425,6 +427,78 @@ void Tiler::tile(const geom::dcubic_multipath& path,
 
   drawable.paints.push_back(
       {drawable.tiles.size(), drawable.fills.size(), fill.paint.type(), fill.paint.id()});
+
+  /* Curves are normalized to the bounding rect, so equal shapes hash equally wherever they are. */
+  drawable.curves_hash = math::hash64(
+      drawable.half_curves.data(),
+      drawable.half_curves.size() * sizeof(utils::half),
+      math::hash64(drawable.curves.data(), drawable.curves.size() * sizeof(vec2)));
+}
+
+Tiler::RowCurves Tiler::push_row_curves(const geom::dcubic_multipath& path,
+                                        const std::vector<uint16_t>& curves,
+                                        const drect& bounding_rect,
+                                        Drawable& drawable)
+{
+  const dvec2 bounds_size = bounding_rect.size();
+
+  m_row_points.clear();
+
+  for (const uint16_t i : curves) {
+    for (uint16_t j = 0; j < 4; j++) {
+      m_row_points.push_back((path[i + j] - bounding_rect.min) / bounds_size);
+    }
+  }
+
+  if (RendererSettings::half_curves && !m_row_points.empty()) {
+    dvec2 row_min = m_row_points.front();
+    dvec2 row_max = m_row_points.front();
+
+    for (const dvec2& p : m_row_points) {
+      row_min = math::min(row_min, p);
+      row_max = math::max(row_max, p);
+    }
+
+    /* Centering the row in [-1, 1] gives the most precision, rows are at least a tile wide. */
+
+    const dvec2 origin = (row_min + row_max) / 2.0;
+    const dvec2 scale = 2.0 / math::max(row_max - row_min, dvec2(m_cell_size) / bounds_size);
+
+    /* The error bound is in pixels, so it shrinks in scene space as the zoom increases. */
+    const dvec2 max_error = RendererSettings::half_curves_error / m_zoom / bounds_size;
+
+    const size_t offset = drawable.half_curves.size();
+    bool precise = true;
+
+    for (const dvec2& p : m_row_points) {
+      const utils::half x = static_cast<float>((p.x - origin.x) * scale.x);
+      const utils::half y = static_cast<float>((p.y - origin.y) * scale.y);
+
+      if (std::abs(static_cast<float>(x) / scale.x + origin.x - p.x) > max_error.x ||
+          std::abs(static_cast<float>(y) / scale.y + origin.y - p.y) > max_error.y)
+      {
+        precise = false;
+        break;
+      }
+
+      drawable.half_curves.insert(drawable.half_curves.end(), {x, y});
+    }
+
+    if (precise) {
+      return RowCurves{static_cast<uint32_t>(offset / 4), true, vec2(origin), vec2(scale)};
+    }
+
+    /* Rows that would lose precision fall back to the full precision curves. */
+    drawable.half_curves.resize(offset);
+  }
+
+  const size_t offset = drawable.curves.size();
+
+  for (const dvec2& p : m_row_points) {
+    drawable.curves.push_back(vec2(p));
+  }
+
+  return RowCurves{static_cast<uint32_t>(offset / 2), false, vec2::zero(), vec2(1.0f)};
 }
 
 void TiledRenderer::setup(const ivec2 viewport_size,
@@ -439,6 +513,7 @@ void TiledRenderer::setup(const ivec2 viewport_size,
   m_LOD = LOD;
   m_base_cell_size = base_cell_size;
   m_z_index = 1;
+  m_stats = Stats{};
 
   m_cell_sizes[0] = m_base_cell_size * std::pow(0.5, m_LOD - 1);
   m_cell_sizes[1] = m_base_cell_size * std::pow(0.5, m_LOD);
@@ -447,14 +522,12 @@ void TiledRenderer::setup(const ivec2 viewport_size,
   m_cell_count = ivec2(math::ceil(visible.max / m_cell_sizes[1]) -
                        math::floor(visible.min / m_cell_sizes[1]));
 
-  // m_culled.clear();
-  // m_culled.resize(m_cell_count.x * m_cell_count.y, std::numeric_limits<uint32_t>::max());
+  m_culled.clear();
+  m_culled.resize(m_cell_count.x * m_cell_count.y, std::numeric_limits<uint32_t>::max());
+  m_culled_origin = math::floor(visible.min / m_cell_sizes[1]) * m_cell_sizes[1];
 
-  m_invalid.clear();
-  m_invalid.resize(m_cell_count.x * m_cell_count.y, false);
-
-  m_semivalid.clear();
-  m_semivalid.resize(m_cell_count.x * m_cell_count.y, false);
+  /* Two units sample the curves, the first slot of the textures array holds the gradients. */
+  m_batch.textures.max_textures = GPU::Device::max_texture_image_units() - 3;
 
   if (!m_framebuffers || m_framebuffers->size() != m_viewport_size) {
     delete m_framebuffers;
@@ -482,17 +555,27 @@ void TiledRenderer::flush()
 
   m_framebuffers->bind();
 
-  render_fills();
+  if (!RendererSettings::retained_batches || !replay()) {
+    record();
 
-  m_framebuffers->swap();
-  m_framebuffers->blit_back_to_front();
+    render_fills();
+
+    swap_framebuffers();
+    blit_framebuffers();
 
-  render_tiles();
+    render_tiles();
+
+    m_retained.valid = m_recording;
+    m_retained.culled_tiles = m_stats.culled_tiles;
+    m_retained.offscreen_tiles = m_stats.offscreen_tiles;
+    m_retained.passes = m_stats.passes;
+    m_retained.texture_splits = m_stats.texture_splits;
+    m_recording = false;
+  }
 
   m_z_index = 1;
 
   m_front_stack.clear();
-  m_back_stack.clear();
 }
 
 void TiledRenderer::render_fills()
@@ -503,47 +586,38 @@ void TiledRenderer::render_fills()
     const Drawable& drawable = *(it->first);
     const uint32_t z_index = m_z_index - it->second;
 
-    if (!m_batch.can_handle_fills(drawable)) {
-      flush_fills();
-    }
-
-    // TODO: should be non_color_paint
-    uint32_t texture_index = 0;
-    bool has_texture_paint = false;
+    const bool textures_fit = m_batch.textures.can_handle(drawable);
 
-    // TODO: extract logic
-    for (const DrawablePaintBinding& binding : drawable.paints) {
-      if (binding.paint_type != Paint::Type::TexturePaint) {
-        continue;
+    if (!textures_fit || !m_batch.can_handle_fills(drawable)) {
+      if (!textures_fit && m_batch.fills.vertices_count()) {
+        m_stats.texture_splits++;
       }
 
-      const auto it = m_textures->find(binding.paint_id);
-      const auto binded_it = std::find_if(
-          m_binded_textures.begin(), m_binded_textures.end(), [binding](const auto& pair) {
-            return pair.first == binding.paint_id;
-          });
-
-      if (it == m_textures->end()) {
-        continue;
-      }
+      flush_fills();
+    }
 
-      has_texture_paint = true;
+    if (m_recording) {
+      const size_t index = std::distance(it, m_front_stack.rend()) - 1;
 
-      if (binded_it != m_binded_textures.end()) {
-        texture_index = binded_it->second;
-      } else {
-        /* We add 1 to the index to avoid binding the gradients texture. */
-        m_binded_textures.push_back(
-            std::make_pair(binding.paint_id, m_binded_textures.size() + 1));
-      }
+      m_retained.drawables[index].fills_first = m_retained.fill_vertices.size() +
+                                                m_batch.fills.vertices_count();
     }
 
+    const bool has_texture_paint = m_batch.textures.bind(drawable);
+
     const double cell_size = m_cell_sizes[1];
 
+    const FillVertex* first_vertex = m_batch.fills.vertices_ptr;
+
     if (!has_texture_paint && drawable.paints.size() == 1) {
       m_batch.fills.upload(drawable, z_index);
     } else {
-      m_batch.fills.upload(drawable, z_index, m_binded_textures);
+      m_batch.fills.upload(drawable, z_index, m_batch.textures);
+    }
+
+    /* Drawables are visited front to back, so the cells already know all the nearer fills. */
+    if (RendererSettings::cull_occluded_tiles) {
+      occlude(first_vertex, m_batch.fills.vertices_ptr - first_vertex);
     }
   }
 
@@ -557,140 +631,390 @@ void TiledRenderer::render_tiles()
   bool complete_batch = true;
   bool first_in_batch = false;  // to avoid blitting again, already done after render_fills()
 
-  while (true) {
-    for (auto it = m_front_stack.begin(); it != m_front_stack.end(); it++) {
-      const Drawable& drawable = *(it->first);
-      const uint32_t z_index = it->second;
+  schedule_passes();
+
+  const size_t passes_count = m_pass_offsets.size() - 1;
+
+  for (size_t pass = 0; pass < passes_count; pass++) {
+    /* Only the ranges of the first pass can be patched. */
+    const bool first_pass = pass == 0;
+
+    for (uint32_t k = m_pass_offsets[pass]; k < m_pass_offsets[pass + 1]; k++) {
+      const uint32_t index = m_pass_order[k];
+      const Drawable& drawable = *m_front_stack[index].first;
+      const uint32_t z_index = m_front_stack[index].second;
+
+      const bool textures_fit = m_batch.textures.can_handle(drawable);
+
+      if (!textures_fit || !m_batch.can_handle_tiles(drawable)) {
+        if (!textures_fit && m_batch.tiles.instances_count()) {
+          m_stats.texture_splits++;
+        }
 
-      if (!m_batch.can_handle_tiles(drawable)) {
         flush_tiles(first_in_batch);
 
         complete_batch = false;
         first_in_batch = false;
       }
 
-      const ivec2 cell_min = ivec2(math::ceil(drawable.bounding_rect.min - m_visible.min) /
-                                   m_cell_sizes[1]);
-      const ivec2 cell_max = ivec2(math::ceil(drawable.bounding_rect.max - m_visible.min) /
-                                   m_cell_sizes[1]);
+      const bool has_texture_paint = m_batch.textures.bind(drawable);
 
-      bool semi_valid = false;
-      bool invalid = false;
+      const size_t tiles_first = m_retained.instances.size() + m_batch.tiles.instances_count();
+      TileInstance* first_tile = m_batch.tiles.instances_ptr;
+      TileBatchData::CurvesBlock block;
+
+      if (!has_texture_paint && drawable.paints.size() == 1) {
+        block = m_batch.tiles.upload(drawable, m_z_index - z_index);
+      } else {
+        block = m_batch.tiles.upload(drawable, m_z_index - z_index, m_batch.textures);
+      }
 
-      for (int y = std::max(cell_min.y, 0); y <= std::min(cell_max.y, m_cell_count.y - 1); y++) {
-        for (int x = std::max(cell_min.x, 0); x <= std::min(cell_max.x, m_cell_count.x - 1); x++) {
-          const int index = x + y * m_cell_count.x;
+      size_t culled_tiles = 0;
 
-          if (m_semivalid[index]) {
-            semi_valid = true;
+      /* Deferred drawables are drawn over the result of the previous passes, never culled. */
+      if (RendererSettings::cull_occluded_tiles && first_pass) {
+        culled_tiles = m_batch.tiles.remove_tiles(first_tile, [this](const TileInstance& tile) {
+          if (!is_occluded(tile)) {
+            return false;
           }
 
-          if (m_invalid[index]) {
-            invalid = true;
+          if (m_recording) {
+            pin_occluders(tile);
           }
-        }
 
-        if (semi_valid && invalid) {
-          break;
-        }
+          return true;
+        });
+
+        m_stats.culled_tiles += culled_tiles;
       }
 
-      if (invalid || (semi_valid && drawable.appearance.blending != BlendingMode::Normal)) {
-        for (int y = std::max(cell_min.y, 0); y <= std::min(cell_max.y, m_cell_count.y - 1); y++) {
-          for (int x = std::max(cell_min.x, 0); x <= std::min(cell_max.x, m_cell_count.x - 1); x++)
-          {
-            const int index = x + y * m_cell_count.x;
+      const bool recorded = m_recording && first_pass;
 
-            m_invalid[index] = true;
-          }
-        }
+      if (recorded) {
+        RetainedBatches::DrawableRange& range = m_retained.drawables[index];
 
-        m_back_stack.push_back(std::make_pair(&drawable, z_index));
+        range.tiles_first = tiles_first;
+        range.curves_block = block;
 
-        continue;
+        /* Patching does not restore culled tiles, a moved drawable could uncover them. */
+        if (culled_tiles > 0) {
+          range.patchable = false;
+        }
       }
 
-      for (int y = std::max(cell_min.y, 0); y <= std::min(cell_max.y, m_cell_count.y - 1); y++) {
-        for (int x = std::max(cell_min.x, 0); x <= std::min(cell_max.x, m_cell_count.x - 1); x++) {
-          const int index = x + y * m_cell_count.x;
+      /* Patching replaces the tiles of a drawable one by one, so the tiles outside of the viewport
+       * are only dropped from the drawables that can't be patched. */
+      if (!recorded || !m_retained.drawables[index].patchable) {
+        m_stats.offscreen_tiles += m_batch.tiles.remove_tiles(
+            first_tile, [this](const TileInstance& tile) { return is_offscreen(tile); });
+      }
+    }
 
-          m_semivalid[index] = true;
-        }
+    flush_tiles(complete_batch);
+
+    complete_batch = true;
+    first_in_batch = true;
+
+    if (pass + 1 < passes_count) {
+      swap_framebuffers();
+    }
+  }
+
+  m_stats.passes += passes_count;
+
+  m_framebuffers->blit();
+  m_framebuffers->unbind();
+}
+
+void TiledRenderer::flush_fills()
+{
+  FillBatchData& fills = m_batch.fills;
+
+  if (fills.vertices_count() == 0) {
+    /* Drawables without fills could have bound their textures. */
+    m_batch.textures.clear();
+    return;
+  }
+
+  if (m_recording) {
+    m_retained.push_fills(fills, m_batch.textures);
+  }
+
+  draw_fills(fills.vertices,
+             fills.vertices_count(),
+             m_batch.textures.textures.data(),
+             m_batch.textures.textures.size());
+
+  m_batch.clear_fills();
+}
+
+void TiledRenderer::flush_tiles(const bool blit_back_to_front)
+{
+  TileBatchData& tiles = m_batch.tiles;
+
+  if (!tiles.instances_count()) {
+    /* Drawables without tiles could have bound their textures. */
+    m_batch.textures.clear();
+    return;
+  }
+
+  if (blit_back_to_front) {
+    blit_framebuffers();
+  }
+
+  if (m_recording) {
+    m_retained.push_tiles(tiles, m_batch.textures);
+  }
+
+  draw_tiles(tiles.instances,
+             tiles.instances_count(),
+             tiles.tex_coords,
+             tiles.tex_coords_count(),
+             tiles.curves,
+             tiles.curves_count(),
+             tiles.half_curves,
+             tiles.half_curves_count(),
+             m_batch.textures.textures.data(),
+             m_batch.textures.textures.size());
+
+  m_stats.shared_curves += tiles.shared_curves;
+
+  m_batch.clear_tiles();
+}
+
+void TiledRenderer::occlude(const FillVertex* vertices, const size_t vertices_count)
+{
+  const double cell_size = m_cell_sizes[1];
+
+  for (size_t i = 0; i + 3 < vertices_count; i += 4) {
+    /* Quads are axis-aligned, the first and third vertices are opposite corners. */
+    const dvec2 a = (dvec2(vertices[i].position) - m_culled_origin) / cell_size;
+    const dvec2 b = (dvec2(vertices[i + 2].position) - m_culled_origin) / cell_size;
+    const uint32_t z_index = vertices[i].z_index();
+
+    /* Only the cells completely inside the quad are covered. */
+    const ivec2 min = math::max(ivec2(math::ceil(math::min(a, b) - occlusion_tolerance)),
+                                ivec2::zero());
+    const ivec2 max = math::min(ivec2(math::floor(math::max(a, b) + occlusion_tolerance)),
+                                m_cell_count);
+
+    for (int y = min.y; y < max.y; y++) {
+      for (int x = min.x; x < max.x; x++) {
+        uint32_t& cell = m_culled[x + y * m_cell_count.x];
+
+        cell = std::min(cell, z_index);
       }
+    }
+  }
+}
 
-      // TODO: should be non_color_paint
-      uint32_t texture_index = 0;
-      bool has_texture_paint = false;
+irect TiledRenderer::touched_cells(const vec2 a, const vec2 b) const
+{
+  const double cell_size = m_cell_sizes[1];
 
-      // TODO: extract logic
-      for (const DrawablePaintBinding& binding : drawable.paints) {
-        if (binding.paint_type != Paint::Type::TexturePaint) {
-          continue;
-        }
+  const dvec2 cell_a = (dvec2(a) - m_culled_origin) / cell_size;
+  const dvec2 cell_b = (dvec2(b) - m_culled_origin) / cell_size;
 
-        const auto it = m_textures->find(binding.paint_id);
-        const auto binded_it = std::find_if(
-            m_binded_textures.begin(), m_binded_textures.end(), [binding](const auto& pair) {
-              return pair.first == binding.paint_id;
-            });
+  const ivec2 min = math::max(
+      ivec2(math::floor(math::min(cell_a, cell_b) + occlusion_tolerance)), ivec2::zero());
+  const ivec2 max = math::min(
+      ivec2(math::ceil(math::max(cell_a, cell_b) - occlusion_tolerance)), m_cell_count);
 
-        if (it == m_textures->end()) {
-          continue;
-        }
+  return irect{min, max};
+}
+
+bool TiledRenderer::has_blended_drawables() const
+{
+  return std::any_of(m_front_stack.begin(), m_front_stack.end(), [](const auto& pair) {
+    return pair.first->appearance.blending != BlendingMode::Normal;
+  });
+}
+
+void TiledRenderer::schedule_passes()
+{
+  const size_t drawables_count = m_front_stack.size();
+
+  m_drawable_passes.assign(drawables_count, 0);
+
+  size_t passes_count = drawables_count > 0 ? 1 : 0;
+
+  /* Without blended drawables nothing is deferred, so the cells are not tracked at all. */
+  if (has_blended_drawables()) {
+    passes_count = 0;
+
+    for (size_t i = 0; i < drawables_count; i++) {
+      const Drawable& drawable = *m_front_stack[i].first;
+
+      collect_spans(drawable);
 
-        has_texture_paint = true;
+      /* The pass after the topmost one that paints any of the cells of the drawable. */
+      size_t above = passes_count;
 
-        if (binded_it != m_binded_textures.end()) {
-          texture_index = binded_it->second;
-        } else {
-          /* We add 1 to the index to avoid binding the gradients texture. */
-          m_binded_textures.push_back(
-              std::make_pair(binding.paint_id, m_binded_textures.size() + 1));
+      while (above > 0 && std::none_of(m_spans.begin(), m_spans.end(), [&](const auto& span) {
+               return m_pass_masks[above - 1].any(span);
+             }))
+      {
+        above--;
+      }
+
+      const size_t pass = drawable.appearance.blending != BlendingMode::Normal ?
+                              above :
+                              std::max(above, size_t(1)) - 1;
+
+      if (pass == passes_count) {
+        if (m_pass_masks.size() <= pass) {
+          m_pass_masks.emplace_back();
         }
+
+        m_pass_masks[pass].clear_and_resize(m_cell_count);
+        passes_count++;
       }
 
-      if (!has_texture_paint && drawable.paints.size() == 1) {
-        m_batch.tiles.upload(drawable, m_z_index - z_index);
-      } else {
-        m_batch.tiles.upload(drawable, m_z_index - z_index, m_binded_textures);
+      for (const CellMask::Span& span : m_spans) {
+        m_pass_masks[pass].set(span);
       }
+
+      m_drawable_passes[i] = static_cast<uint32_t>(pass);
     }
+  }
 
-    flush_tiles(complete_batch);
+  /* Counting sort, the drawables of each pass keep their order. */
+  m_pass_offsets.assign(passes_count + 1, 0);
+  m_pass_order.resize(drawables_count);
 
-    complete_batch = true;
-    first_in_batch = true;
+  for (const uint32_t pass : m_drawable_passes) {
+    m_pass_offsets[pass + 1]++;
+  }
+
+  for (size_t pass = 1; pass <= passes_count; pass++) {
+    m_pass_offsets[pass] += m_pass_offsets[pass - 1];
+  }
+
+  for (size_t i = 0; i < drawables_count; i++) {
+    m_pass_order[m_pass_offsets[m_drawable_passes[i]]++] = static_cast<uint32_t>(i);
+  }
 
-    m_invalid.clear();
-    m_invalid.resize(m_cell_count.x * m_cell_count.y, false);
+  /* Placing the drawables moved each offset to the start of the next pass. */
+  for (size_t pass = passes_count; pass > 0; pass--) {
+    m_pass_offsets[pass] = m_pass_offsets[pass - 1];
+  }
 
-    m_semivalid.clear();
-    m_semivalid.resize(m_cell_count.x * m_cell_count.y, false);
+  m_pass_offsets[0] = 0;
+}
 
-    if (m_back_stack.empty()) {
-      break;
+void TiledRenderer::collect_spans(const Drawable& drawable)
+{
+  m_spans.clear();
+
+  const auto push_cells = [&](const irect cells) {
+    for (int y = cells.min.y; y < cells.max.y; y++) {
+      if (!m_spans.empty() && m_spans.back().y == y && cells.min.x <= m_spans.back().x1 &&
+          cells.max.x >= m_spans.back().x0)
+      {
+        m_spans.back().x0 = std::min(m_spans.back().x0, cells.min.x);
+        m_spans.back().x1 = std::max(m_spans.back().x1, cells.max.x);
+      } else if (cells.min.x < cells.max.x) {
+        m_spans.push_back({y, cells.min.x, cells.max.x});
+      }
     }
+  };
 
-    m_front_stack.clear();
-    m_framebuffers->swap();
+  for (const TileInstance& tile : drawable.tiles) {
+    push_cells(touched_cells(tile.min, tile.max));
+  }
 
-    std::swap(m_front_stack, m_back_stack);
+  for (size_t i = 0; i + 3 < drawable.fills.size(); i += 4) {
+    push_cells(touched_cells(drawable.fills[i].position, drawable.fills[i + 2].position));
   }
+}
 
-  m_framebuffers->blit();
-  m_framebuffers->unbind();
+bool TiledRenderer::is_occluded(const TileInstance& tile) const
+{
+  /* Only the cells inside of the viewport are checked, tiles outside of it are not occluded. */
+  const irect cells = touched_cells(tile.min, tile.max);
+  const uint32_t z_index = tile.z_index();
+
+  if (cells.min.x >= cells.max.x || cells.min.y >= cells.max.y) {
+    return false;
+  }
+
+  for (int y = cells.min.y; y < cells.max.y; y++) {
+    for (int x = cells.min.x; x < cells.max.x; x++) {
+      if (m_culled[x + y * m_cell_count.x] >= z_index) {
+        return false;
+      }
+    }
+  }
+
+  return true;
 }
 
-void TiledRenderer::flush_fills()
+bool TiledRenderer::is_offscreen(const TileInstance& tile) const
 {
-  FillBatchData& fills = m_batch.fills;
-  BatchData& data = m_batch.data;
+  const irect cells = touched_cells(tile.min, tile.max);
 
-  if (fills.vertices_count() == 0) {
-    return;
+  return cells.min.x >= cells.max.x || cells.min.y >= cells.max.y;
+}
+
+void TiledRenderer::pin_occluders(const TileInstance& tile)
+{
+  const irect cells = touched_cells(tile.min, tile.max);
+
+  uint32_t last_z_index = 0;
+
+  for (int y = cells.min.y; y < cells.max.y; y++) {
+    for (int x = cells.min.x; x < cells.max.x; x++) {
+      const uint32_t z_index = m_culled[x + y * m_cell_count.x];
+
+      if (z_index == last_z_index) {
+        continue;
+      }
+
+      /* The fill belongs to the last drawable pushed before its z-index. */
+      const uint32_t pushed_z_index = m_z_index - z_index;
+      const auto it = std::upper_bound(
+          m_retained.drawables.begin(),
+          m_retained.drawables.end(),
+          pushed_z_index,
+          [](const uint32_t z, const RetainedBatches::DrawableRange& range) {
+            return z < range.z_index;
+          });
+
+      if (it != m_retained.drawables.begin()) {
+        std::prev(it)->patchable = false;
+      }
+
+      last_z_index = z_index;
+    }
   }
+}
 
-  fills.vertex_buffer.upload(fills.vertices, fills.vertices_count() * sizeof(FillVertex));
+std::vector<const GPU::Texture*> TiledRenderer::batch_textures(const uuid* textures,
+                                                               const size_t textures_count) const
+{
+  std::vector<const GPU::Texture*> bound = {&m_batch.data.gradients_texture};
+
+  for (size_t i = 0; i < textures_count; i++) {
+    const auto it = m_textures->find(textures[i]);
+
+    if (it != m_textures->end()) {
+      bound.push_back(&it->second);
+    } else {
+      bound.push_back(&m_textures->find(uuid::null)->second);
+    }
+  }
+
+  return bound;
+}
+
+void TiledRenderer::draw_fills(const FillVertex* vertices,
+                               const size_t vertices_count,
+                               const uuid* textures,
+                               const size_t textures_count)
+{
+  FillBatchData& fills = m_batch.fills;
+
+  fills.vertex_buffer.upload(vertices, vertices_count * sizeof(FillVertex));
 
   GPU::RenderState render_state = GPU::RenderState().no_blend().default_depth().no_stencil();
 
@@ -701,40 +1025,50 @@ void TiledRenderer::flush_fills()
 
   render_state.uniforms = {{m_fill_program->vp_uniform, m_vp_matrix}};
   render_state.texture_arrays = std::vector<GPU::TextureArrayBinding>{
-      {m_fill_program->textures_uniform, {&data.gradients_texture}}};
-
-  for (const auto& [texture_id, _] : m_binded_textures) {
-    const auto it = m_textures->find(texture_id);
-
-    if (it != m_textures->end()) {
-      render_state.texture_arrays[0].second.push_back(&it->second);
-    } else {
-      render_state.texture_arrays[0].second.push_back(&m_textures->find(uuid::null)->second);
-    }
-  }
+      {m_fill_program->textures_uniform, batch_textures(textures, textures_count)}};
 
-  GPU::Device::draw_elements(fills.indices_count(), render_state);
+  GPU::Device::draw_elements(vertices_count * 3 / 2, render_state);
 
-  m_batch.clear_fills();
+  m_stats.fills += vertices_count / 4;
+  m_stats.fill_batches++;
 }
 
-void TiledRenderer::flush_tiles(const bool blit_back_to_front)
+void TiledRenderer::draw_tiles(const TileInstance* instances,
+                               const size_t instances_count,
+                               const TileTexCoords* tex_coords,
+                               const size_t tex_coords_count,
+                               const vec2* curves,
+                               const size_t curves_count,
+                               const utils::half* half_curves,
+                               const size_t half_curves_count,
+                               const uuid* textures,
+                               const size_t textures_count)
 {
   TileBatchData& tiles = m_batch.tiles;
-  BatchData& data = m_batch.data;
 
   GPU::RenderState render_state = GPU::RenderState().no_blend().default_depth().no_stencil();
 
-  if (!tiles.vertices_count()) {
-    return;
-  }
+  const size_t instances_size = instances_count * sizeof(TileInstance);
+  const size_t tex_coords_size = tex_coords_count * sizeof(TileTexCoords);
 
-  if (blit_back_to_front) {
-    m_framebuffers->blit_back_to_front();
+  tiles.instance_buffer.upload(instances, instances_size);
+
+  if (tex_coords_size) {
+    tiles.tex_coords_buffer.upload(tex_coords, tex_coords_size);
   }
 
-  tiles.vertex_buffer.upload(tiles.vertices, tiles.vertices_count() * sizeof(TileVertex));
-  tiles.curves_texture.upload(tiles.curves, tiles.curves_count());
+  tiles.curves_texture.upload(curves, curves_count);
+
+  if (half_curves_count) {
+    if (!tiles.half_curves_texture) {
+      tiles.half_curves_texture = std::make_unique<GPU::Texture>(
+          GPU::TextureFormat::RGBA16F,
+          ivec2{GK_CURVES_TEXTURE_SIZE},
+          GPU::TextureSamplingFlagNearestMin | GPU::TextureSamplingFlagNearestMag);
+    }
+
+    tiles.half_curves_texture->upload(half_curves, half_curves_count);
+  }
 
   render_state.default_blend().no_depth_write().no_stencil();
 
@@ -745,24 +1079,155 @@ void TiledRenderer::flush_tiles(const bool blit_back_to_front)
 
   render_state.uniforms = {{m_tile_program->vp_uniform, m_vp_matrix},
                            {m_tile_program->samples_uniform, 3}};
+  /* Without half precision curves, the sampler is bound to a valid texture that is never read. */
   render_state.textures = std::vector<GPU::TextureBinding>{
-      {m_tile_program->curves_texture_uniform, &tiles.curves_texture}};
+      {m_tile_program->curves_texture_uniform, &tiles.curves_texture},
+      {m_tile_program->half_curves_texture_uniform,
+       tiles.half_curves_texture ? tiles.half_curves_texture.get() : &tiles.curves_texture}};
   render_state.texture_arrays = std::vector<GPU::TextureArrayBinding>{
-      {m_tile_program->textures_uniform, {&data.gradients_texture}}};
+      {m_tile_program->textures_uniform, batch_textures(textures, textures_count)}};
 
-  for (const auto& [texture_id, _] : m_binded_textures) {
-    const auto it = m_textures->find(texture_id);
+  GPU::Device::draw_arrays_instanced(
+      TileBatchData::vertices_per_instance(), instances_count, render_state);
 
-    if (it != m_textures->end()) {
-      render_state.texture_arrays[0].second.push_back(&it->second);
-    } else {
-      render_state.texture_arrays[0].second.push_back(&m_textures->find(uuid::null)->second);
+  m_stats.tiles += instances_count;
+  m_stats.tile_bytes += instances_size + tex_coords_size;
+  m_stats.curves += curves_count / 2 + half_curves_count / 2;
+  m_stats.half_curves += half_curves_count / 2;
+  m_stats.tile_batches++;
+}
+
+void TiledRenderer::swap_framebuffers()
+{
+  if (m_recording) {
+    m_retained.commands.push_back({RetainedBatches::Command::Type::Swap});
+  }
+
+  m_framebuffers->swap();
+}
+
+void TiledRenderer::blit_framebuffers()
+{
+  if (m_recording) {
+    m_retained.commands.push_back({RetainedBatches::Command::Type::Blit});
+  }
+
+  m_framebuffers->blit_back_to_front();
+}
+
+void TiledRenderer::record()
+{
+  m_retained.clear();
+  m_recording = RendererSettings::retained_batches;
+
+  if (!m_recording) {
+    return;
+  }
+
+  m_retained.viewport_size = m_viewport_size;
+  m_retained.visible = m_visible;
+  m_retained.LOD = m_LOD;
+  m_retained.base_cell_size = m_base_cell_size;
+  m_retained.textures_count = m_textures->size();
+  m_retained.culling = RendererSettings::cull_occluded_tiles;
+
+  /* Blending decides the passes from the painted cells, so a single blended drawable makes
+   * every drawable of the frame unpatchable. */
+  const bool blended = has_blended_drawables();
+
+  for (const auto& [drawable, z_index] : m_front_stack) {
+    m_retained.drawables.push_back({drawable,
+                                    drawable->revision,
+                                    z_index,
+                                    0,
+                                    0,
+                                    drawable->paints.size(),
+                                    drawable->fills.size(),
+                                    drawable->tiles.size(),
+                                    drawable->curves.size(),
+                                    drawable->half_curves.size(),
+                                    drawable->curves_hash,
+                                    TileBatchData::CurvesBlock{},
+                                    !blended && RetainedBatches::is_patchable(*drawable)});
+  }
+}
+
+bool TiledRenderer::replay()
+{
+  if (!m_retained.valid || m_retained.viewport_size != m_viewport_size ||
+      m_retained.visible != m_visible || m_retained.LOD != m_LOD ||
+      m_retained.base_cell_size != m_base_cell_size ||
+      m_retained.textures_count != m_textures->size() ||
+      m_retained.culling != RendererSettings::cull_occluded_tiles ||
+      m_retained.drawables.size() != m_front_stack.size())
+  {
+    return false;
+  }
+
+  size_t patched_drawables = 0;
+
+  /* If a patch fails, the partially patched frame is discarded and recorded again. */
+  for (size_t i = 0; i < m_front_stack.size(); i++) {
+    const auto [drawable, z_index] = m_front_stack[i];
+    RetainedBatches::DrawableRange& range = m_retained.drawables[i];
+
+    if (range.drawable != drawable || range.z_index != z_index) {
+      return false;
+    }
+
+    if (range.revision == drawable->revision) {
+      continue;
+    }
+
+    if (!m_retained.patch(range, *drawable, m_z_index - z_index)) {
+      return false;
     }
+
+    patched_drawables++;
   }
 
-  GPU::Device::draw_elements(tiles.indices_count(), render_state);
+  for (const RetainedBatches::Command& command : m_retained.commands) {
+    switch (command.type) {
+      case RetainedBatches::Command::Type::Fills:
+        draw_fills(m_retained.fill_vertices.data() + command.first,
+                   command.count,
+                   m_retained.textures.data() + command.textures_first,
+                   command.textures_count);
+        m_stats.retained_batches++;
+        break;
+      case RetainedBatches::Command::Type::Tiles:
+        draw_tiles(m_retained.instances.data() + command.first,
+                   command.count,
+                   m_retained.tex_coords.data() + command.first,
+                   command.tex_coords_count,
+                   m_retained.curves.data() + command.curves_first,
+                   command.curves_count,
+                   m_retained.half_curves.data() + command.half_curves_first,
+                   command.half_curves_count,
+                   m_retained.textures.data() + command.textures_first,
+                   command.textures_count);
+        m_stats.shared_curves += command.shared_curves;
+        m_stats.retained_batches++;
+        break;
+      case RetainedBatches::Command::Type::Blit:
+        m_framebuffers->blit_back_to_front();
+        break;
+      case RetainedBatches::Command::Type::Swap:
+        m_framebuffers->swap();
+        break;
+    }
+  }
 
-  m_batch.clear_tiles();
+  m_stats.patched_drawables += patched_drawables;
+  m_stats.culled_tiles += m_retained.culled_tiles;
+  m_stats.offscreen_tiles += m_retained.offscreen_tiles;
+  m_stats.passes += m_retained.passes;
+  m_stats.texture_splits += m_retained.texture_splits;
+
+  m_framebuffers->blit();
+  m_framebuffers->unbind();
+
+  return true;
 }
 
 }  // namespace graphick::renderer
@@ -16,7 +16,10 @@
 
 #include "drawable.h"
 
-#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
 
 namespace graphick::renderer::GPU {
 
@@ -111,6 +114,18 @@ class Tiler {
             const std::array<vec2, 4>& texture_coords,
             Drawable& drawable);
 
+  /**
+   * @brief Returns the path to clip into before tiling, it is reused across draws.
+   *
+   * Each thread owns its tiler, so the path can be filled without synchronization.
+   *
+   * @return A reference to the reusable clipped path.
+   */
+  inline geom::dcubic_multipath& clip_path()
+  {
+    return m_clip_path;
+  }
+
  private:
   /**
    * @brief The Cell struct represents a cell of the tiling grid.
@@ -131,9 +146,33 @@ class Tiler {
 
   using Intersections = std::vector<Intersection>;
 
+  /**
+   * @brief The RowCurves struct represents the curves of a row of tiles in the drawable.
+   *
+   * The curve coordinates of the tiles are mapped to the frame of the row: (p - origin) * scale.
+   */
+  struct RowCurves {
+    uint32_t offset;  // The texel offset of the curves in the full or half precision curves.
+    bool half;        // Whether the curves are stored with half precision.
+
+    vec2 origin;      // The origin of the row frame, in normalized drawable space.
+    vec2 scale;       // The scale of the row frame.
+  };
+
+  /**
+   * @brief The CellRows struct stores, for each row of the tiling grid, the curves crossing it,
+   * the intersections with the row boundary and which cells of the row are tiles.
+   *
+   * All the storage is flat and is reused across calls to avoid rehashing and reallocations.
+   */
   struct CellRows {
    public:
-    inline const std::unordered_set<uint16_t>& operator[](const size_t index) const
+    inline const std::vector<uint16_t>& operator[](const size_t index) const
+    {
+      return m_rows[index];
+    }
+
+    inline std::vector<uint16_t>& operator[](const size_t index)
     {
       return m_rows[index];
     }
@@ -166,17 +205,31 @@ class Tiler {
         m_capacity = y;
       }
 
-      m_hsize = x;
+      m_hwords = (x + 63) / 64;
       m_size = y;
 
-      m_tiles.clear();
-      m_tiles.resize(x * y, false);
+      if (m_tiles.size() < m_hwords * y) {
+        m_tiles.resize(m_hwords * y);
+      }
+
+      std::fill(m_tiles.begin(), m_tiles.begin() + m_hwords * y, uint64_t(0));
     }
 
+    /**
+     * @brief Adds a curve to a row and marks the cell as a tile.
+     *
+     * Curves are inserted in order, so consecutive duplicates are skipped here, the remaining
+     * ones are removed by sort_and_unique().
+     */
     inline void insert(const int x, const int y, const uint16_t curve)
     {
-      m_rows[y].insert(curve);
-      m_tiles[y * m_hsize + x] = true;
+      std::vector<uint16_t>& row = m_rows[y];
+
+      if (row.empty() || row.back() != curve) {
+        row.push_back(curve);
+      }
+
+      m_tiles[y * m_hwords + x / 64] |= uint64_t(1) << (x % 64);
     }
 
     inline void intersection(const int y, const Intersection i)
@@ -186,95 +239,244 @@ class Tiler {
 
     inline bool is_tile(const int x, const int y) const
     {
-      return m_tiles[y * m_hsize + x];
+      return (m_tiles[y * m_hwords + x / 64] >> (x % 64)) & 1;
+    }
+
+    /**
+     * @brief Sorts the curves of a row by their maximum x-coordinate (descending) and removes
+     * duplicates.
+     *
+     * @param y The row to sort.
+     * @param curves_max The x-max values of the curves.
+     * @return The sorted row.
+     */
+    inline const std::vector<uint16_t>& sort_and_unique(const int y,
+                                                        const std::vector<float>& curves_max)
+    {
+      std::vector<uint16_t>& row = m_rows[y];
+
+      std::sort(row.begin(), row.end(), [&](const uint16_t a, const uint16_t b) {
+        return curves_max[a] > curves_max[b] || (curves_max[a] == curves_max[b] && a < b);
+      });
+
+      row.erase(std::unique(row.begin(), row.end()), row.end());
+
+      return row;
     }
 
    private:
-    std::vector<std::unordered_set<uint16_t>> m_rows;
-    std::vector<Intersections> m_intersections;
-    std::vector<bool> m_tiles;
+    std::vector<std::vector<uint16_t>> m_rows;  // The curve indices of each row.
+    std::vector<Intersections> m_intersections;  // The intersections of each row.
+    std::vector<uint64_t> m_tiles;               // Bitset of the cells that are tiles.
 
     size_t m_capacity = 0;
-    size_t m_hsize = 0;
+    size_t m_hwords = 0;
     size_t m_size = 0;
   };
 
+  /**
+   * @brief Adds the control points of the curves of a row of tiles to the drawable.
+   *
+   * If RendererSettings::half_curves is set, the points are stored with half precision in the
+   * frame of the row, unless a point would move by more than RendererSettings::half_curves_error.
+   *
+   * @param path The path being tiled.
+   * @param curves The indices of the curves of the row.
+   * @param bounding_rect The bounding rectangle of the path.
+   * @param drawable The drawable to add the curves to.
+   * @return The location and the frame of the curves.
+   */
+  RowCurves push_row_curves(const geom::dcubic_multipath& path,
+                            const std::vector<uint16_t>& curves,
+                            const drect& bounding_rect,
+                            Drawable& drawable);
+
  private:
-  drect m_visible;                                 // The visible area of the scene.
+  drect m_visible;                                  // The visible area of the scene.
 
-  double m_zoom;                                   // The current zoom level.
-  double m_base_cell_size;                         // The largest scene-space tile size.
-  double m_cell_size;                              // The current (smallest) scene-space tile size.
+  double m_zoom;                                    // The current zoom level.
+  double m_base_cell_size;                          // The largest scene-space tile size.
+  double m_cell_size;                               // The smallest scene-space tile size.
 
-  uint8_t m_LOD;                                   // The maximum level of detail.
-  ivec2 m_cell_count;                              // The number of tiles in the x and y direction.
+  uint8_t m_LOD;                                    // The maximum level of detail.
+  ivec2 m_cell_count;                               // The number of tiles in the x and y axes.
 
-  CellRows m_cells;                                // Rows of cells of the path being tiled.
+  CellRows m_cells;                                 // Rows of cells of the path being tiled.
 
-  std::vector<float> m_curves_max;                 // The x-max values of the curves.
-  std::unordered_map<int, uint32_t> m_curves_map;  // The map of curves group to indices.
+  std::vector<float> m_curves_max;                  // The x-max values of the curves.
+  std::unordered_map<int, RowCurves> m_curves_map;  // The map of curves group to row curves.
+  std::vector<dvec2> m_row_points;                  // The normalized control points of a row.
+
+  geom::dcubic_multipath m_clip_path;  // The reusable clipped path, see clip_path().
+};
+
+/**
+ * @brief The texture slots of a batch, looked up by texture id.
+ *
+ * Slot 0 is the gradients texture, so the textures of the batch start from slot 1. When a
+ * drawable needs more textures than the free slots, the batch is split.
+ */
+struct TextureSlots {
+  size_t max_textures = 0;                   // The number of slots available to textures.
+
+  std::unordered_map<uuid, uint32_t> slots;  // The slot of each texture of the batch.
+  std::vector<uuid> textures;                // The textures of the batch, ordered by slot.
+
+  /**
+   * @brief Gets the slot of a texture.
+   *
+   * @param texture_id The id of the texture.
+   * @return The slot of the texture, 0 if it is not in the batch.
+   */
+  inline uint32_t find(const uuid texture_id) const
+  {
+    const auto it = slots.find(texture_id);
+    return it != slots.end() ? it->second : 0;
+  }
+
+  /**
+   * @brief Checks whether the texture paints of a drawable fit in the batch.
+   *
+   * @param drawable The drawable to check.
+   * @return Whether the textures of the drawable are already in the batch or fit in free slots.
+   */
+  inline bool can_handle(const Drawable& drawable) const
+  {
+    size_t new_textures = 0;
+
+    for (auto it = drawable.paints.begin(); it != drawable.paints.end(); it++) {
+      if (it->paint_type != Paint::Type::TexturePaint || slots.count(it->paint_id)) {
+        continue;
+      }
+
+      /* A texture used by more than one paint of the drawable takes a single slot. */
+      if (std::none_of(drawable.paints.begin(), it, [it](const DrawablePaintBinding& binding) {
+            return binding.paint_id == it->paint_id;
+          }))
+      {
+        new_textures++;
+      }
+    }
+
+    return textures.size() + new_textures <= max_textures;
+  }
+
+  /**
+   * @brief Binds the texture paints of a drawable to the batch.
+   *
+   * can_handle() should be called first, textures that do not fit are not bound.
+   *
+   * @param drawable The drawable to bind the textures of.
+   * @return Whether the drawable has texture paints.
+   */
+  inline bool bind(const Drawable& drawable)
+  {
+    bool has_texture_paint = false;
+
+    for (const DrawablePaintBinding& binding : drawable.paints) {
+      if (binding.paint_type != Paint::Type::TexturePaint) {
+        continue;
+      }
+
+      has_texture_paint = true;
+
+      if (textures.size() < max_textures &&
+          slots.emplace(binding.paint_id, static_cast<uint32_t>(textures.size() + 1)).second)
+      {
+        textures.push_back(binding.paint_id);
+      }
+    }
+
+    return has_texture_paint;
+  }
+
+  /**
+   * @brief Clears the slots, the capacity is kept.
+   */
+  inline void clear()
+  {
+    slots.clear();
+    textures.clear();
+  }
 };
 
 /**
  * @brief Represents the data of a single tile batch.
  */
 struct TileBatchData {
-  size_t max_vertices;          // The maximum number of vertices in the batch.
-  size_t max_indices;           // The maximum number of indices in the batch.
-  size_t max_curves;            // The maximum number of control points in the curves texture.
+  /**
+   * @brief A block of curves uploaded once and shared by all the drawables with equal curves.
+   */
+  struct CurvesBlock {
+    size_t offset;       // The index of the first texel of the block in the curves texture.
+    size_t size;         // The number of control points in the block.
+    size_t half_offset;  // The index of the first texel of the block in the half curves texture.
+    size_t half_size;    // The number of half precision components in the block.
+  };
+
+  /**
+   * @brief The corners of the two triangles of a tile, expanded by the vertex shader.
+   */
+  inline static const uvec2 s_corners[6] = {
+      uvec2(0, 0), uvec2(1, 0), uvec2(1, 1), uvec2(1, 1), uvec2(0, 1), uvec2(0, 0)};
+
+  size_t max_instances;                                     // The maximum number of tiles.
+  size_t max_curves;                                        // The maximum number of curves.
+
+  TileInstance* instances;                                  // The tiles of the batch.
+  TileInstance* instances_ptr;                              // The current index of the tiles.
+
+  TileTexCoords* tex_coords;                                // The paint coordinates of the tiles.
+  TileTexCoords* tex_coords_end;                            // The end of the written coordinates.
 
-  TileVertex* vertices;         // The vertices of the batch.
-  TileVertex* vertices_ptr;     // The current index of the vertices.
+  vec2* curves;                                             // The control points of the curves.
+  vec2* curves_ptr;                                         // The current index of the curves.
 
-  uint16_t* indices;            // The indices of the batch, these are all static quads.
-  uint16_t* indices_ptr;        // The current index of the indices.
+  utils::half* half_curves;                                 // The half precision control points.
+  utils::half* half_curves_ptr;                             // The current index of half_curves.
 
-  vec2* curves;                 // The control points of the curves.
-  vec2* curves_ptr;             // The current index of the curves.
+  std::unordered_map<uint64_t, CurvesBlock> curves_blocks;  // The uploaded curves, by hash.
+  size_t shared_curves;                                     // The curves reused from blocks.
 
-  GPU::Buffer vertex_buffer;    // The GPU vertex buffer.
-  GPU::Buffer index_buffer;     // The GPU index buffer.
-  GPU::Texture curves_texture;  // The curves texture.
+  GPU::Buffer vertex_buffer;                                // The corners of a tile, static.
+  GPU::Buffer instance_buffer;                              // The GPU tiles buffer.
+  GPU::Buffer tex_coords_buffer;                            // The GPU paint coordinates buffer.
+  GPU::Texture curves_texture;                              // The curves texture.
+  std::unique_ptr<GPU::Texture> half_curves_texture;        // Created on the first half upload.
 
-  GPU::Primitive primitive;     // The primitive type of the mesh.
+  GPU::Primitive primitive;                                 // The primitive type of the mesh.
 
   /**
    * @brief Constructs a new TileBatchData object.
    */
   TileBatchData(const size_t buffer_size)
       : primitive(GPU::Primitive::Triangles),
-        max_vertices(buffer_size / sizeof(TileVertex)),
-        max_indices(max_vertices * 3 / 2),
+        max_instances(buffer_size / sizeof(TileInstance)),
         max_curves(GK_CURVES_TEXTURE_SIZE * GK_CURVES_TEXTURE_SIZE),
+        shared_curves(0),
         vertex_buffer(GPU::BufferTarget::Vertex,
-                      GPU::BufferUploadMode::Dynamic,
-                      max_vertices * sizeof(TileVertex)),
-        index_buffer(GPU::BufferTarget::Index,
-                     GPU::BufferUploadMode::Static,
-                     max_indices * sizeof(uint16_t)),
+                      GPU::BufferUploadMode::Static,
+                      sizeof(s_corners),
+                      s_corners),
+        instance_buffer(GPU::BufferTarget::Vertex,
+                        GPU::BufferUploadMode::Dynamic,
+                        max_instances * sizeof(TileInstance)),
+        tex_coords_buffer(GPU::BufferTarget::Vertex,
+                          GPU::BufferUploadMode::Dynamic,
+                          max_instances * sizeof(TileTexCoords)),
         curves_texture(GPU::TextureFormat::RGBA32F,
                        ivec2{GK_CURVES_TEXTURE_SIZE},
                        GPU::TextureSamplingFlagNearestMin | GPU::TextureSamplingFlagNearestMag)
   {
-    vertices = new TileVertex[max_vertices];
-    indices = new uint16_t[max_indices];
+    instances = new TileInstance[max_instances];
+    tex_coords = new TileTexCoords[max_instances]();
     curves = new vec2[max_curves * 2];
+    half_curves = new utils::half[max_curves * 4];
 
-    vertices_ptr = vertices;
-    indices_ptr = indices;
+    instances_ptr = instances;
+    tex_coords_end = tex_coords;
     curves_ptr = curves;
-
-    // Fill the index buffer with static quads.
-    for (size_t i = 0; i < max_indices - 5; i += 6) {
-      indices[i + 0] = i / 6 * 4 + 0;
-      indices[i + 1] = i / 6 * 4 + 1;
-      indices[i + 2] = i / 6 * 4 + 2;
-      indices[i + 3] = i / 6 * 4 + 2;
-      indices[i + 4] = i / 6 * 4 + 3;
-      indices[i + 5] = i / 6 * 4 + 0;
-    }
-
-    index_buffer.upload(indices, max_indices * sizeof(uint16_t));
+    half_curves_ptr = half_curves;
   }
 
   /**
@@ -282,29 +484,40 @@ struct TileBatchData {
    */
   ~TileBatchData()
   {
-    delete[] vertices;
-    delete[] indices;
+    delete[] instances;
+    delete[] tex_coords;
     delete[] curves;
+    delete[] half_curves;
   }
 
   /**
-   * @brief Gets the number of vertices currently in the batch.
+   * @brief Gets the number of tiles currently in the batch.
    *
-   * @return The number of vertices in the batch.
+   * @return The number of tiles in the batch.
    */
-  inline size_t vertices_count() const
+  inline size_t instances_count() const
   {
-    return vertices_ptr - vertices;
+    return instances_ptr - instances;
   }
 
   /**
-   * @brief Gets the number of indices currently in the batch.
+   * @brief Gets the number of paint coordinates to upload, tiles without them are not read.
    *
-   * @return The number of indices in the batch.
+   * @return The number of paint coordinates in the batch.
    */
-  inline size_t indices_count() const
+  inline size_t tex_coords_count() const
   {
-    return vertices_count() * 3 / 2;
+    return tex_coords_end - tex_coords;
+  }
+
+  /**
+   * @brief Gets the number of vertices of a tile.
+   *
+   * @return The number of vertices to draw for each instance.
+   */
+  static constexpr size_t vertices_per_instance()
+  {
+    return sizeof(s_corners) / sizeof(uvec2);
   }
 
   /**
@@ -317,112 +530,248 @@ struct TileBatchData {
     return (curves_ptr - curves) / 2;
   }
 
+  /**
+   * @brief Gets the number of half precision curves currently in the batch.
+   *
+   * @return The number of half precision curves in the batch.
+   */
+  inline size_t half_curves_count() const
+  {
+    return (half_curves_ptr - half_curves) / 4;
+  }
+
   /**
    * @brief Clears the batch data.
    */
   inline void clear()
   {
-    vertices_ptr = vertices;
-    indices_ptr = indices;
+    instances_ptr = instances;
+    tex_coords_end = tex_coords;
     curves_ptr = curves;
+    half_curves_ptr = half_curves;
+
+    curves_blocks.clear();
+    shared_curves = 0;
   }
 
   /**
-   * @brief Checks if the batch can handle the given number of curves.
+   * @brief Checks if the batch can handle the given number of tiles.
    *
-   * @param curves The number of curves to add.
-   * @return Whether the batch can handle the curves.
+   * @param instances The number of tiles to add.
+   * @return Whether the batch can handle the tiles.
    */
-  inline bool can_handle_quads(const size_t quads = 1) const
+  inline bool can_handle_instances(const size_t instances = 1) const
   {
-    return this->vertices_count() + quads * 4 < max_vertices;
+    return this->instances_count() + instances < max_instances;
   }
 
   /**
    * @brief Checks if the batch can handle the given number of curves.
    *
    * @param curves The number of curves to add.
+   * @param half_curves The number of half precision curves to add.
    * @return Whether the batch can handle the curves.
    */
-  inline bool can_handle_curves(const size_t curves) const
+  inline bool can_handle_curves(const size_t curves, const size_t half_curves = 0) const
   {
-    return this->curves_count() + curves < max_curves;
+    return this->curves_count() + curves < max_curves &&
+           this->half_curves_count() + half_curves < max_curves;
   }
 
   /**
-   * @brief Uploads vertices and curves to the buffers.
+   * @brief Looks for a block of curves equal to the ones of the drawable.
    *
-   * @param drawable The drawable with the tile vertices and curves to upload.
+   * @param drawable The drawable to look the curves of.
+   * @return The block, or nullptr if not found.
+   */
+  inline const CurvesBlock* find_curves(const Drawable& drawable) const
+  {
+    const auto it = curves_blocks.find(drawable.curves_hash);
+
+    if (it == curves_blocks.end() || it->second.size != drawable.curves.size() ||
+        it->second.half_size != drawable.half_curves.size() ||
+        std::memcmp(curves + it->second.offset * 2,
+                    drawable.curves.data(),
+                    drawable.curves.size() * sizeof(vec2)) != 0 ||
+        std::memcmp(half_curves + it->second.half_offset * 4,
+                    drawable.half_curves.data(),
+                    drawable.half_curves.size() * sizeof(utils::half)) != 0)
+    {
+      return nullptr;
+    }
+
+    return &it->second;
+  }
+
+  /**
+   * @brief Adds the curves of the drawable to the batch, unless an equal block is already there.
+   *
+   * @param drawable The drawable with the curves to add.
+   * @return The block with the texel offsets of the curves of the drawable.
+   */
+  inline CurvesBlock push_curves(const Drawable& drawable)
+  {
+    const size_t size = drawable.curves.size();
+    const size_t half_size = drawable.half_curves.size();
+
+    if (size == 0 && half_size == 0) {
+      return CurvesBlock{curves_count(), 0, half_curves_count(), 0};
+    }
+
+    if (const CurvesBlock* block = find_curves(drawable)) {
+      shared_curves += size / 4 + half_size / 8;
+      return *block;
+    }
+
+    const CurvesBlock block{curves_count(), size, half_curves_count(), half_size};
+
+    memcpy((void*)curves_ptr, drawable.curves.data(), size * sizeof(vec2));
+    memcpy((void*)half_curves_ptr, drawable.half_curves.data(), half_size * sizeof(utils::half));
+
+    curves_ptr += size;
+    half_curves_ptr += half_size;
+
+    /* On hash collisions the first block is kept, the new one is just not shared. */
+    curves_blocks.try_emplace(drawable.curves_hash, block);
+
+    return block;
+  }
+
+  /**
+   * @brief Copies the paint coordinates of the drawable next to its tiles.
+   *
+   * @param drawable The drawable with the paint coordinates to copy.
+   */
+  inline void push_tex_coords(const Drawable& drawable)
+  {
+    if (drawable.tile_tex_coords.empty()) {
+      return;
+    }
+
+    TileTexCoords* tex_coords_ptr = tex_coords + instances_count();
+
+    memcpy((void*)tex_coords_ptr,
+           drawable.tile_tex_coords.data(),
+           drawable.tile_tex_coords.size() * sizeof(TileTexCoords));
+
+    tex_coords_end = tex_coords_ptr + drawable.tile_tex_coords.size();
+  }
+
+  /**
+   * @brief Uploads tiles and curves to the buffers.
+   *
+   * @param drawable The drawable with the tiles and curves to upload.
    * @param z_index The z-index of the drawable.
+   * @return The block the tiles of the drawable point to.
    */
-  inline void upload(const Drawable& drawable, const uint32_t z_index)
+  inline CurvesBlock upload(const Drawable& drawable, const uint32_t z_index)
   {
-    memcpy((void*)vertices_ptr, drawable.tiles.data(), drawable.tiles.size() * sizeof(TileVertex));
-    memcpy((void*)curves_ptr, drawable.curves.data(), drawable.curves.size() * sizeof(vec2));
+    memcpy((void*)instances_ptr,
+           drawable.tiles.data(),
+           drawable.tiles.size() * sizeof(TileInstance));
 
-    const size_t curves_start_index = curves_count();
+    push_tex_coords(drawable);
 
-    const TileVertex* vertices_end_ptr = vertices_ptr + drawable.tiles.size();
+    const CurvesBlock block = push_curves(drawable);
 
-    for (; vertices_ptr < vertices_end_ptr; vertices_ptr++) {
-      vertices_ptr->add_offset_to_curves(curves_start_index);
-      vertices_ptr->update_z_index(z_index);
+    const TileInstance* instances_end_ptr = instances_ptr + drawable.tiles.size();
+
+    for (; instances_ptr < instances_end_ptr; instances_ptr++) {
+      instances_ptr->add_offset_to_curves(block.offset, block.half_offset);
+      instances_ptr->update_z_index(z_index);
     }
 
-    curves_ptr += drawable.curves.size();
+    return block;
   }
 
   /**
-   * @brief Uploads vertices and curves to the buffers.
+   * @brief Uploads tiles and curves to the buffers.
    *
-   * @param drawable The drawable with the tile vertices and curves to upload.
+   * @param drawable The drawable with the tiles and curves to upload.
    * @param z_index The z-index of the drawable.
-   * @param textures The texture bindings to use for the drawable.
+   * @param textures The texture slots of the batch, the textures of the drawable must be bound.
+   * @return The block the tiles of the drawable point to.
    */
-  inline void upload(const Drawable& drawable,
-                     const uint32_t z_index,
-                     const std::vector<std::pair<uuid, uint32_t>>& textures)
+  inline CurvesBlock upload(const Drawable& drawable,
+                            const uint32_t z_index,
+                            const TextureSlots& textures)
   {
-    memcpy((void*)vertices_ptr, drawable.tiles.data(), drawable.tiles.size() * sizeof(TileVertex));
-    memcpy((void*)curves_ptr, drawable.curves.data(), drawable.curves.size() * sizeof(vec2));
+    memcpy((void*)instances_ptr,
+           drawable.tiles.data(),
+           drawable.tiles.size() * sizeof(TileInstance));
+
+    push_tex_coords(drawable);
 
-    const size_t curves_start_index = curves_count();
+    const CurvesBlock block = push_curves(drawable);
 
     size_t local_z_index = z_index;
 
-    const TileVertex* vertices_start_ptr = vertices_ptr;
+    const TileInstance* instances_start_ptr = instances_ptr;
 
     for (const DrawablePaintBinding& binding : drawable.paints) {
-      const TileVertex* vertices_end_ptr = vertices_start_ptr + binding.last_tile_index;
+      const TileInstance* instances_end_ptr = instances_start_ptr + binding.last_tile_index;
 
       if (binding.paint_type == Paint::Type::TexturePaint) {
-        const auto it = std::find_if(
-            textures.begin(), textures.end(), [binding](const auto& pair) {
-              return pair.first == binding.paint_id;
-            });
+        const uint32_t texture_index = textures.find(binding.paint_id);
 
-        if (it == textures.end()) {
-          continue;
-        }
-
-        const uint32_t texture_index = it->second;
-
-        for (; vertices_ptr < vertices_end_ptr; vertices_ptr++) {
-          vertices_ptr->add_offset_to_curves(curves_start_index);
-          vertices_ptr->update_z_index(local_z_index);
-          vertices_ptr->update_paint_coord(texture_index);
+        for (; instances_ptr < instances_end_ptr; instances_ptr++) {
+          instances_ptr->add_offset_to_curves(block.offset, block.half_offset);
+          instances_ptr->update_z_index(local_z_index);
+          instances_ptr->update_paint_coord(texture_index);
         }
       } else {
-        for (; vertices_ptr < vertices_end_ptr; vertices_ptr++) {
-          vertices_ptr->add_offset_to_curves(curves_start_index);
-          vertices_ptr->update_z_index(local_z_index);
+        for (; instances_ptr < instances_end_ptr; instances_ptr++) {
+          instances_ptr->add_offset_to_curves(block.offset, block.half_offset);
+          instances_ptr->update_z_index(local_z_index);
         }
       }
 
       local_z_index--;
     }
 
-    curves_ptr += drawable.curves.size();
+    return block;
+  }
+
+  /**
+   * @brief Removes the tiles matching the predicate, starting from the given one.
+   *
+   * The remaining tiles and their paint coordinates are compacted, keeping their order.
+   *
+   * @param first The first tile to check, i.e. the first tile of the last uploaded drawable.
+   * @param predicate The function that returns true for the tiles to remove.
+   * @return The number of removed tiles.
+   */
+  template<typename F>
+  inline size_t remove_tiles(TileInstance* first, const F& predicate)
+  {
+    const size_t first_index = first - instances;
+    const bool has_tex_coords = tex_coords_end > tex_coords + first_index;
+
+    size_t kept = first_index;
+
+    for (size_t i = first_index; i < instances_count(); i++) {
+      if (predicate(instances[i])) {
+        continue;
+      }
+
+      instances[kept] = instances[i];
+
+      if (has_tex_coords) {
+        tex_coords[kept] = tex_coords[i];
+      }
+
+      kept++;
+    }
+
+    const size_t removed = instances_count() - kept;
+
+    instances_ptr = instances + kept;
+
+    if (has_tex_coords) {
+      tex_coords_end = tex_coords + kept;
+    }
+
+    return removed;
   }
 };
 
@@ -549,11 +898,11 @@ struct FillBatchData {
    *
    * @param drawable The drawable with the tile vertices and curves to upload.
    * @param z_index The z-index of the drawable.
-   * @param textures The texture bindings to use for the drawable.
+   * @param textures The texture slots of the batch, the textures of the drawable must be bound.
    */
   inline void upload(const Drawable& drawable,
                      const uint32_t z_index,
-                     const std::vector<std::pair<uuid, uint32_t>>& textures)
+                     const TextureSlots& textures)
   {
     memcpy((void*)vertices_ptr, drawable.fills.data(), drawable.fills.size() * sizeof(FillVertex));
 
@@ -565,16 +914,7 @@ struct FillBatchData {
       const FillVertex* vertices_end_ptr = vertices_start_ptr + binding.last_fill_index;
 
       if (binding.paint_type == Paint::Type::TexturePaint) {
-        const auto it = std::find_if(
-            textures.begin(), textures.end(), [binding](const auto& pair) {
-              return pair.first == binding.paint_id;
-            });
-
-        if (it == textures.end()) {
-          continue;
-        }
-
-        const uint32_t texture_index = it->second;
+        const uint32_t texture_index = textures.find(binding.paint_id);
 
         for (; vertices_ptr < vertices_end_ptr; vertices_ptr++) {
           vertices_ptr->update_z_index(local_z_index);
@@ -658,6 +998,7 @@ struct Batch {
   TileBatchData tiles;
   FillBatchData fills;
   BatchData data;
+  TextureSlots textures;
 
   /**
    * @brief Constructs a new Batch object.
@@ -671,6 +1012,7 @@ struct Batch {
   {
     fills.clear();
     data.clear();
+    textures.clear();
   }
 
   /**
@@ -680,12 +1022,19 @@ struct Batch {
   {
     tiles.clear();
     data.clear();
+    textures.clear();
   }
 
   inline bool can_handle_tiles(const Drawable& drawable) const
   {
     // TODO: check if gradients, ecc can be handled
-    return tiles.can_handle_quads(drawable.tiles.size() / 4);
+    if (!tiles.can_handle_instances(drawable.tiles.size())) {
+      return false;
+    }
+
+    /* Shared curves take no space, the lookup is only needed when the texture is almost full. */
+    return tiles.can_handle_curves(drawable.curves.size() / 2, drawable.half_curves.size() / 4) ||
+           tiles.find_curves(drawable) != nullptr;
   }
 
   inline bool can_handle_fills(const Drawable& drawable) const
@@ -695,7 +1044,335 @@ struct Batch {
   }
 };
 
+/**
+ * @brief The batches of the last frame, replayed while the drawables and the viewport are equal.
+ *
+ * The batch buffers are copied here when flushed, so that an equal frame is submitted again
+ * without copying the drawables and patching their z-indices and curve offsets. Drawables that
+ * changed in place (i.e. moved or recolored) are patched into their ranges, as long as the batch
+ * and pass layout of the frame cannot change.
+ */
+struct RetainedBatches {
+  /**
+   * @brief A recorded command of the frame, replayed in order.
+   */
+  struct Command {
+    enum class Type : uint8_t { Fills, Tiles, Blit, Swap };
+
+    Type type;                     // The type of the command.
+
+    size_t first = 0;              // The first fill vertex or tile instance of the batch.
+    size_t count = 0;              // The number of fill vertices or tile instances of the batch.
+    size_t tex_coords_count = 0;   // The number of paint coordinates of the tile batch.
+
+    size_t curves_first = 0;       // The first control point of the tile batch.
+    size_t curves_count = 0;       // The number of curve texels of the tile batch.
+    size_t half_curves_first = 0;  // The first half precision component of the tile batch.
+    size_t half_curves_count = 0;  // The number of half precision curve texels of the tile batch.
+    size_t shared_curves = 0;      // The number of curves shared in the tile batch.
+
+    size_t textures_first = 0;     // The first texture id of the batch.
+    size_t textures_count = 0;     // The number of textures bound with the batch.
+  };
+
+  /**
+   * @brief The recorded state of a drawable and its ranges in the retained buffers.
+   */
+  struct DrawableRange {
+    const Drawable* drawable;                 // The drawable, only valid while it is cached.
+    uint64_t revision;                        // The revision of the drawable when it was recorded.
+    uint32_t z_index;                         // The z-index the drawable was pushed with.
+
+    size_t fills_first;                       // The first fill vertex of the drawable.
+    size_t tiles_first;                       // The first tile instance of the drawable.
+
+    size_t paints_count;                      // The number of paints of the drawable.
+    size_t fills_count;                       // The number of fill vertices of the drawable.
+    size_t tiles_count;                       // The number of tile instances of the drawable.
+    size_t curves_size;                       // The number of control points of the drawable.
+    size_t half_curves_size;                  // The half precision components of the drawable.
+    uint64_t curves_hash;                     // The hash of the curves of the drawable.
+
+    TileBatchData::CurvesBlock curves_block;  // The block the tiles of the drawable point to.
+
+    bool patchable;                           // Whether the drawable can be patched in place.
+  };
+
+  bool valid = false;                        // Whether a complete frame was recorded.
+
+  ivec2 viewport_size;                       // The viewport size of the recorded frame.
+  drect visible;                             // The visible area of the recorded frame.
+  uint8_t LOD;                               // The level of detail of the recorded frame.
+  double base_cell_size;                     // The base cell size of the recorded frame.
+  size_t textures_count;                     // The number of loaded textures of the frame.
+  bool culling;                              // Whether occluded tiles were culled.
+  size_t culled_tiles;                       // The number of tiles culled in the frame.
+  size_t offscreen_tiles;                    // The number of tiles dropped outside the viewport.
+  size_t passes;                             // The number of tile passes of the frame.
+  size_t texture_splits;                     // The number of batches split by their textures.
+
+  std::vector<Command> commands;             // The commands of the frame.
+  std::vector<DrawableRange> drawables;      // The drawables of the frame, in push order.
+
+  std::vector<FillVertex> fill_vertices;     // The fill vertices of all the fill batches.
+  std::vector<TileInstance> instances;       // The tile instances of all the tile batches.
+  std::vector<TileTexCoords> tex_coords;     // The paint coordinates, parallel to instances.
+  std::vector<vec2> curves;                  // The control points of all the tile batches.
+  std::vector<utils::half> half_curves;      // The half precision curves of the tile batches.
+  std::vector<uuid> textures;                // The texture ids of all the batches.
+
+  /**
+   * @brief Checks whether a drawable can be patched without changing the layout of the frame.
+   *
+   * Only drawables with color paints are patched, and only if no drawable of the frame is
+   * blended, as blending decides the passes from the painted cells.
+   *
+   * @param drawable The drawable to check.
+   * @return Whether the drawable can be patched.
+   */
+  static inline bool is_patchable(const Drawable& drawable)
+  {
+    return drawable.appearance.blending == BlendingMode::Normal &&
+           std::none_of(drawable.paints.begin(),
+                        drawable.paints.end(),
+                        [](const DrawablePaintBinding& binding) {
+                          return binding.paint_type == Paint::Type::TexturePaint;
+                        });
+  }
+
+  /**
+   * @brief Clears the recorded frame, the capacity of the buffers is kept.
+   */
+  inline void clear()
+  {
+    valid = false;
+
+    commands.clear();
+    drawables.clear();
+    fill_vertices.clear();
+    instances.clear();
+    tex_coords.clear();
+    curves.clear();
+    half_curves.clear();
+    textures.clear();
+  }
+
+  /**
+   * @brief Records a fill batch.
+   *
+   * @param fills The fill batch to record.
+   * @param slots The texture slots of the batch.
+   */
+  inline void push_fills(const FillBatchData& fills, const TextureSlots& slots)
+  {
+    Command command{Command::Type::Fills, fill_vertices.size(), fills.vertices_count()};
+
+    command.textures_first = textures.size();
+    command.textures_count = slots.textures.size();
+
+    commands.push_back(command);
+
+    fill_vertices.insert(fill_vertices.end(), fills.vertices, fills.vertices_ptr);
+    textures.insert(textures.end(), slots.textures.begin(), slots.textures.end());
+  }
+
+  /**
+   * @brief Records a tile batch.
+   *
+   * @param tiles The tile batch to record.
+   * @param slots The texture slots of the batch.
+   */
+  inline void push_tiles(const TileBatchData& tiles, const TextureSlots& slots)
+  {
+    Command command{Command::Type::Tiles, instances.size(), tiles.instances_count()};
+
+    command.tex_coords_count = tiles.tex_coords_count();
+    command.curves_first = curves.size();
+    command.curves_count = tiles.curves_count();
+    command.half_curves_first = half_curves.size();
+    command.half_curves_count = tiles.half_curves_count();
+    command.shared_curves = tiles.shared_curves;
+    command.textures_first = textures.size();
+    command.textures_count = slots.textures.size();
+
+    commands.push_back(command);
+
+    instances.insert(instances.end(), tiles.instances, tiles.instances_ptr);
+    tex_coords.insert(tex_coords.end(), tiles.tex_coords, tiles.tex_coords_end);
+    tex_coords.resize(instances.size());
+    curves.insert(curves.end(), tiles.curves, tiles.curves_ptr);
+    half_curves.insert(half_curves.end(), tiles.half_curves, tiles.half_curves_ptr);
+    textures.insert(textures.end(), slots.textures.begin(), slots.textures.end());
+  }
+
+  /**
+   * @brief Patches a drawable that changed in place into its recorded ranges.
+   *
+   * @param range The recorded ranges of the drawable, updated to the new revision.
+   * @param drawable The changed drawable.
+   * @param z_index The z-index of the drawable in the batches.
+   * @return Whether the drawable was patched, if false the frame should be rebuilt.
+   */
+  inline bool patch(DrawableRange& range, const Drawable& drawable, const uint32_t z_index)
+  {
+    /* Equal counts and curves keep the batch boundaries and the shared curve blocks valid. */
+    if (!range.patchable || !is_patchable(drawable) ||
+        drawable.paints.size() != range.paints_count ||
+        drawable.fills.size() != range.fills_count || drawable.tiles.size() != range.tiles_count ||
+        drawable.curves.size() != range.curves_size ||
+        drawable.half_curves.size() != range.half_curves_size ||
+        drawable.curves_hash != range.curves_hash)
+    {
+      return false;
+    }
+
+    FillVertex* vertices = fill_vertices.data() + range.fills_first;
+    TileInstance* tiles = instances.data() + range.tiles_first;
+
+    const bool single_paint = drawable.paints.size() == 1;
+
+    size_t fill_index = 0;
+    size_t tile_index = 0;
+    uint32_t local_z_index = z_index;
+
+    /* As in the uploads, each paint after the first one is drawn one z-index below. */
+    for (const DrawablePaintBinding& binding : drawable.paints) {
+      const size_t fills_end = single_paint ? drawable.fills.size() : binding.last_fill_index;
+      const size_t tiles_end = single_paint ? drawable.tiles.size() : binding.last_tile_index;
+
+      for (; fill_index < fills_end; fill_index++) {
+        vertices[fill_index] = drawable.fills[fill_index];
+        vertices[fill_index].update_z_index(local_z_index);
+      }
+
+      for (; tile_index < tiles_end; tile_index++) {
+        tiles[tile_index] = drawable.tiles[tile_index];
+        tiles[tile_index].add_offset_to_curves(range.curves_block.offset,
+                                               range.curves_block.half_offset);
+        tiles[tile_index].update_z_index(local_z_index);
+      }
+
+      local_z_index--;
+    }
+
+    range.revision = drawable.revision;
+
+    return true;
+  }
+};
+
+/**
+ * @brief A bitset of the cells of the viewport grid, tested and set a row span at a time.
+ *
+ * Each row is padded to a whole number of 64 bit words, so that a span of n cells is handled
+ * with n / 64 word operations.
+ */
+struct CellMask {
+  /**
+   * @brief A horizontal span of cells of a row, the maximum is exclusive.
+   */
+  struct Span {
+    int y;   // The row of the span.
+    int x0;  // The first cell of the span.
+    int x1;  // The cell after the last one of the span.
+  };
+
+  /**
+   * @brief Resizes the mask to the given number of cells and clears it.
+   *
+   * @param size The number of cells in the x and y axes.
+   */
+  inline void clear_and_resize(const ivec2 size)
+  {
+    m_hwords = (std::max(size.x, 0) + 63) / 64;
+    m_words.assign(m_hwords * std::max(size.y, 0), uint64_t(0));
+  }
+
+  /**
+   * @brief Clears the mask, keeping its size.
+   */
+  inline void clear()
+  {
+    std::fill(m_words.begin(), m_words.end(), uint64_t(0));
+  }
+
+  /**
+   * @brief Checks whether any cell of the span is set.
+   *
+   * @param span The span to check, it should be inside of the mask.
+   * @return Whether any cell is set.
+   */
+  inline bool any(const Span& span) const
+  {
+    const uint64_t* row = m_words.data() + span.y * m_hwords;
+
+    for (int word = span.x0 / 64; word <= (span.x1 - 1) / 64; word++) {
+      if (row[word] & word_mask(word, span)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Sets all the cells of the span.
+   *
+   * @param span The span to set, it should be inside of the mask.
+   */
+  inline void set(const Span& span)
+  {
+    uint64_t* row = m_words.data() + span.y * m_hwords;
+
+    for (int word = span.x0 / 64; word <= (span.x1 - 1) / 64; word++) {
+      row[word] |= word_mask(word, span);
+    }
+  }
+ private:
+  /**
+   * @brief Gets the bits of a word covered by a span.
+   *
+   * @param word The index of the word in the row.
+   * @param span The span.
+   * @return The mask of the bits of the span.
+   */
+  static inline uint64_t word_mask(const int word, const Span& span)
+  {
+    const int start = std::max(span.x0 - word * 64, 0);
+    const int end = std::min(span.x1 - word * 64, 64);
+
+    const uint64_t low = ~uint64_t(0) << start;
+    const uint64_t high = end == 64 ? ~uint64_t(0) : (uint64_t(1) << end) - 1;
+
+    return low & high;
+  }
+ private:
+  std::vector<uint64_t> m_words;  // The bits of the cells, row by row.
+  size_t m_hwords = 0;            // The number of words of a row.
+};
+
 class TiledRenderer {
+ public:
+  /**
+   * @brief The primitives and batches flushed since the last call to setup().
+   */
+  struct Stats {
+    size_t tiles = 0;          // The number of tile instances.
+    size_t tile_bytes = 0;     // The bytes of tile instances and paint coordinates uploaded.
+    size_t fills = 0;          // The number of fill quads.
+    size_t curves = 0;         // The number of curves.
+    size_t half_curves = 0;    // The number of curves stored with half precision.
+    size_t shared_curves = 0;  // The number of curves shared with other drawables of the batch.
+    size_t tile_batches = 0;   // The number of tile draw calls.
+    size_t fill_batches = 0;   // The number of fill draw calls.
+
+    size_t retained_batches = 0;   // The number of draw calls replayed from the last frame.
+    size_t patched_drawables = 0;  // The number of changed drawables patched into the batches.
+    size_t culled_tiles = 0;       // The number of tiles hidden by nearer opaque fills.
+    size_t offscreen_tiles = 0;    // The number of tiles dropped outside of the viewport.
+    size_t passes = 0;             // The number of tile passes, each one swaps the framebuffers.
+    size_t texture_splits = 0;     // The number of batches split because the textures were full.
+  };
  public:
   /**
    * @brief Constructs a new TiledRenderer object.
@@ -748,7 +1425,7 @@ class TiledRenderer {
   }
 
   /**
-   * @brief Returns the tiles vertex buffer.
+   * @brief Returns the tiles vertex buffer, with the corners of a tile.
    *
    * @return The tiles vertex buffer.
    */
@@ -758,13 +1435,23 @@ class TiledRenderer {
   }
 
   /**
-   * @brief Returns the tiles index buffer.
+   * @brief Returns the tiles instance buffer.
+   *
+   * @return The tiles instance buffer.
+   */
+  inline const GPU::Buffer& tiles_instance_buffer() const
+  {
+    return m_batch.tiles.instance_buffer;
+  }
+
+  /**
+   * @brief Returns the tiles paint coordinates buffer.
    *
-   * @return The tiles index buffer.
+   * @return The tiles paint coordinates buffer.
    */
-  inline const GPU::Buffer& tiles_index_buffer() const
+  inline const GPU::Buffer& tiles_tex_coords_buffer() const
   {
-    return m_batch.tiles.index_buffer;
+    return m_batch.tiles.tex_coords_buffer;
   }
 
   /**
@@ -787,6 +1474,16 @@ class TiledRenderer {
     return m_batch.fills.index_buffer;
   }
 
+  /**
+   * @brief Returns the primitives and batches flushed since the last call to setup().
+   *
+   * @return The statistics of the current frame.
+   */
+  inline const Stats& stats() const
+  {
+    return m_stats;
+  }
+
   /**
    * @brief Adds a new drawable to the batch.
    *
@@ -815,7 +1512,7 @@ class TiledRenderer {
   void render_fills();
 
   /**
-   * @brief Renders the tile batches.
+   * @brief Renders the tile batches, in the passes scheduled by schedule_passes().
    */
   void render_tiles();
 
@@ -831,6 +1528,154 @@ class TiledRenderer {
    */
   void flush_tiles(const bool blit_back_to_front);
 
+  /**
+   * @brief Marks the occlusion cells fully covered by the given opaque fills.
+   *
+   * Each cell keeps the z-index of the nearest fill covering it.
+   *
+   * @param vertices The fill vertices, four per quad, with their final z-index.
+   * @param vertices_count The number of vertices.
+   */
+  void occlude(const FillVertex* vertices, const size_t vertices_count);
+
+  /**
+   * @brief Assigns each drawable of the front stack to a tile pass.
+   *
+   * A drawable is drawn in the topmost pass that paints any of its cells, a blended drawable in
+   * the pass after it, as it reads the result of the previous passes. The overlaps are resolved
+   * once per frame with a cell mask per pass, so the number of passes is the length of the
+   * longest chain of overlapping blended drawables.
+   *
+   * The indices of the front stack are sorted by pass into m_pass_order, the passes are delimited
+   * by m_pass_offsets.
+   */
+  void schedule_passes();
+
+  /**
+   * @brief Collects the cells covered by the tiles and fills of a drawable into m_spans.
+   *
+   * Only the cells that are actually painted are collected, not the whole bounding box, and
+   * adjacent tiles of a row are merged into a single span.
+   *
+   * @param drawable The drawable to collect the cells of.
+   */
+  void collect_spans(const Drawable& drawable);
+
+  /**
+   * @brief Gets the cells of the viewport grid touched by a rectangle, clipped to the viewport.
+   *
+   * @param a A corner of the rectangle.
+   * @param b The opposite corner of the rectangle.
+   * @return The range of cells, the maximum is exclusive.
+   */
+  irect touched_cells(const vec2 a, const vec2 b) const;
+
+  /**
+   * @brief Checks whether any drawable to render is blended.
+   *
+   * Without blended drawables nothing is ever deferred to a later pass.
+   *
+   * @return Whether any drawable of the front stack is blended.
+   */
+  bool has_blended_drawables() const;
+
+  /**
+   * @brief Checks whether the visible part of a tile is fully hidden by nearer opaque fills.
+   *
+   * @param tile The tile to check, with its final z-index.
+   * @return Whether the tile can be skipped, false if it is outside of the viewport.
+   */
+  bool is_occluded(const TileInstance& tile) const;
+
+  /**
+   * @brief Checks whether a tile is entirely outside of the viewport.
+   *
+   * @param tile The tile to check.
+   * @return Whether the tile can be skipped.
+   */
+  bool is_offscreen(const TileInstance& tile) const;
+
+  /**
+   * @brief Marks the drawables whose fills hide a culled tile as not patchable.
+   *
+   * Moving one of them would uncover the tile, the fills of farther drawables can move freely.
+   *
+   * @param tile The culled tile.
+   */
+  void pin_occluders(const TileInstance& tile);
+
+  /**
+   * @brief Collects the textures to bind with a batch, after the gradients texture.
+   *
+   * @param textures The ids of the textures of the batch, ordered by slot.
+   * @param textures_count The number of textures of the batch.
+   * @return The textures to bind, textures that are not loaded are replaced by the default one.
+   */
+  std::vector<const GPU::Texture*> batch_textures(const uuid* textures,
+                                                  const size_t textures_count) const;
+
+  /**
+   * @brief Draws fill vertices, already patched, with the fill program.
+   *
+   * @param vertices The vertices to draw.
+   * @param vertices_count The number of vertices to draw.
+   * @param textures The ids of the textures of the batch, ordered by slot.
+   * @param textures_count The number of textures of the batch.
+   */
+  void draw_fills(const FillVertex* vertices,
+                  const size_t vertices_count,
+                  const uuid* textures,
+                  const size_t textures_count);
+
+  /**
+   * @brief Draws tile instances, already patched, with the tile program.
+   *
+   * @param instances The tile instances to draw.
+   * @param instances_count The number of tile instances to draw.
+   * @param tex_coords The paint coordinates of the tiles.
+   * @param tex_coords_count The number of paint coordinates to upload.
+   * @param curves The control points of the curves.
+   * @param curves_count The number of curve texels to upload.
+   * @param half_curves The half precision control points of the curves.
+   * @param half_curves_count The number of half precision curve texels to upload.
+   * @param textures The ids of the textures of the batch, ordered by slot.
+   * @param textures_count The number of textures of the batch.
+   */
+  void draw_tiles(const TileInstance* instances,
+                  const size_t instances_count,
+                  const TileTexCoords* tex_coords,
+                  const size_t tex_coords_count,
+                  const vec2* curves,
+                  const size_t curves_count,
+                  const utils::half* half_curves,
+                  const size_t half_curves_count,
+                  const uuid* textures,
+                  const size_t textures_count);
+
+  /**
+   * @brief Swaps the framebuffers, recording the command if needed.
+   */
+  void swap_framebuffers();
+
+  /**
+   * @brief Blits the back framebuffer to the front one, recording the command if needed.
+   */
+  void blit_framebuffers();
+
+  /**
+   * @brief Starts recording the frame, if retained batches are enabled.
+   */
+  void record();
+
+  /**
+   * @brief Replays the batches of the last frame if the drawables and the viewport are equal.
+   *
+   * Drawables that changed in place are patched into the retained batches first.
+   *
+   * @return Whether the frame was replayed, if false the batches should be rebuilt.
+   */
+  bool replay();
+
  private:
   Batch m_batch;            // The tile/fill batch to render.
   uint32_t m_z_index;       // The current z-index.
@@ -847,12 +1692,15 @@ class TiledRenderer {
 
   GPU::DoubleFramebuffer* m_framebuffers = nullptr;                 // The framebuffers to use.
 
-  std::vector<std::pair<const Drawable*, uint32_t>> m_front_stack;  // Draw now.
-  std::vector<std::pair<const Drawable*, uint32_t>> m_back_stack;   // Draw next call.
+  std::vector<std::pair<const Drawable*, uint32_t>> m_front_stack;  // The drawables to draw.
 
-  std::vector<uint32_t> m_culled;                                   // The culled tiles.
-  std::vector<bool> m_semivalid;                                    // Can draw normal tiles.
-  std::vector<bool> m_invalid;                                      // Cannot draw anything.
+  std::vector<uint32_t> m_culled;                                   // Nearest fill z per cell.
+  dvec2 m_culled_origin;                                            // The origin of the cells.
+  std::vector<CellMask> m_pass_masks;                               // Cells painted by each pass.
+  std::vector<CellMask::Span> m_spans;                              // Cells of the drawable.
+  std::vector<uint32_t> m_drawable_passes;                          // Pass of each drawable.
+  std::vector<uint32_t> m_pass_order;                               // Drawables sorted by pass.
+  std::vector<uint32_t> m_pass_offsets;                             // First drawable of each pass.
 
   GPU::TileVertexArray* m_tile_vertex_array;                 // The tile vertex array to use.
   GPU::FillVertexArray* m_fill_vertex_array;                 // The fill vertex array to use.
@@ -860,7 +1708,11 @@ class TiledRenderer {
   GPU::FillProgram* m_fill_program;                          // The fill program to use.
 
   std::unordered_map<uuid, GPU::Texture>* m_textures;        // The textures loaded in the GPU.
-  std::vector<std::pair<uuid, uint32_t>> m_binded_textures;  // The textures bound to the GPU.
+
+  RetainedBatches m_retained;                                // The batches of the last frame.
+  bool m_recording = false;                                  // Whether the frame is recorded.
+
+  Stats m_stats;                                             // The statistics of the frame.
 };
 
 }  // namespace graphick::renderer
@@ -9,6 +9,7 @@
 
 #  include <chrono>
 #  include <numeric>
+#  include <thread>
 #  include <unordered_map>
 
 #  include "../renderer/renderer.h"
@@ -25,6 +26,8 @@ inline static std::unordered_map<std::string, debugger::DebugValue> s_values = {
 inline static std::unordered_map<std::string, debugger::TotalTimer> s_total_timers = {};
 inline static std::unordered_map<std::string, debugger::AverageTimer> s_average_timers = {};
 
+inline static const std::thread::id s_main_thread = std::this_thread::get_id();
+
 inline static vec4 s_severity_colors[] = {
     vec4(0.2f, 0.8f, 0.8f, 1.0f),     // Blue
     vec4(0.2f, 0.8f, 0.2f, 1.0f),     // Green
@@ -32,6 +35,17 @@ inline static vec4 s_severity_colors[] = {
     vec4(0.8f, 0.2f, 0.2f, 1.0f),     // Red
 };
 
+/**
+ * @brief Timers and values are only recorded on the main thread, calls from worker threads are
+ * ignored.
+ *
+ * @return Whether the current thread is the main thread.
+ */
+static inline bool is_main_thread()
+{
+  return std::this_thread::get_id() == s_main_thread;
+}
+
 /* -- TotalTimer -- */
 
 void debugger::TotalTimer::start()
@@ -71,11 +85,19 @@ void debugger::frame()
 
 void debugger::value(const std::string& name, const std::string& value)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   s_values[name] = DebugValue{value, now()};
 }
 
 void debugger::value_counter(const std::string& name, const int value)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   const std::string counter_name = "[counter] " + name;
 
   auto it = s_values.find(counter_name);
@@ -89,6 +111,10 @@ void debugger::value_counter(const std::string& name, const int value)
 
 void debugger::total_start(const std::string& name)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   auto it = s_total_timers.find(name);
   size_t time = now();
 
@@ -104,6 +130,10 @@ void debugger::total_start(const std::string& name)
 
 void debugger::total_end(const std::string& name)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   auto it = s_total_timers.find(name);
   if (it == s_total_timers.end()) {
     return;
@@ -114,6 +144,10 @@ void debugger::total_end(const std::string& name)
 
 void debugger::total_record(const std::string& name, const size_t record)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   auto it = s_total_timers.find(name);
   size_t time = now();
 
@@ -129,6 +163,10 @@ void debugger::total_record(const std::string& name, const size_t record)
 
 void debugger::average_start(const std::string& name)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   auto it = s_average_timers.find(name);
   size_t time = now();
 
@@ -141,6 +179,10 @@ void debugger::average_start(const std::string& name)
 
 void debugger::average_end(const std::string& name)
 {
+  if (!is_main_thread()) {
+    return;
+  }
+
   auto it = s_average_timers.find(name);
   size_t time = now();
 
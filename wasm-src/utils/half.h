@@ -123,6 +123,40 @@ struct half {
       }
     }
   }
+
+  /**
+   * @brief Converts the half float to a float.
+   *
+   * @return The float.
+   */
+  operator float() const
+  {
+    IEEESingle f;
+
+    f.IEEE.sign = IEEE.sign;
+
+    if (!IEEE.exp) {
+      if (!IEEE.frac) {
+        // Signed zero
+        f.IEEE.frac = 0;
+        f.IEEE.exp = 0;
+      } else {
+        // Denorm, normalize it
+        const float value = static_cast<float>(IEEE.frac) * (1.0f / 16777216.0f);
+        return IEEE.sign ? -value : value;
+      }
+    } else if (IEEE.exp == 31) {
+      // NaN or INF
+      f.IEEE.exp = 0xFF;
+      f.IEEE.frac = IEEE.frac ? 1 : 0;
+    } else {
+      // Regular number
+      f.IEEE.exp = IEEE.exp + (127 - 15);
+      f.IEEE.frac = static_cast<uint32_t>(IEEE.frac) << 13;
+    }
+
+    return f.f;
+  }
 };
 
 }  // namespace graphick::utils
@@ -0,0 +1,120 @@
+/**
+ * @file utils/job_system.cpp
+ * @brief The file contains the implementation of the job system.
+ */
+
+#include "job_system.h"
+
+namespace graphick::utils {
+
+/**
+ * @brief Whether the current thread is executing a job, used to run nested jobs inline.
+ */
+static thread_local bool s_in_job = false;
+
+JobSystem::JobSystem(const size_t workers_count)
+{
+  m_workers.reserve(workers_count);
+
+  for (size_t i = 0; i < workers_count; i++) {
+    m_workers.emplace_back(&JobSystem::worker_loop, this, i + 1);
+  }
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_start.notify_all();
+
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void JobSystem::parallel_for(const size_t count, const Job& job)
+{
+  if (count == 0) {
+    return;
+  }
+
+  if (m_workers.empty() || count == 1 || s_in_job) {
+    for (size_t i = 0; i < count; i++) {
+      job(i, 0);
+    }
+
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_job = &job;
+    m_count = count;
+    m_busy = m_workers.size();
+    m_next.store(0, std::memory_order_relaxed);
+    m_generation++;
+  }
+
+  m_start.notify_all();
+
+  run(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this]() { return m_busy == 0; });
+
+  m_job = nullptr;
+}
+
+size_t JobSystem::default_workers_count()
+{
+#if defined(EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+  return 0;
+#else
+  const size_t hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads > 1 ? hardware_threads - 1 : 0;
+#endif
+}
+
+void JobSystem::worker_loop(const size_t worker)
+{
+  size_t generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [&]() { return m_stop || m_generation != generation; });
+
+      if (m_stop) {
+        return;
+      }
+
+      generation = m_generation;
+    }
+
+    run(worker);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_busy--;
+    }
+
+    m_done.notify_one();
+  }
+}
+
+void JobSystem::run(const size_t worker)
+{
+  s_in_job = true;
+
+  for (size_t i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1)) {
+    (*m_job)(i, worker);
+  }
+
+  s_in_job = false;
+}
+
+}  // namespace graphick::utils
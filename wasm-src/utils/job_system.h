@@ -0,0 +1,112 @@
+/**
+ * @file utils/job_system.h
+ * @brief The file contains the definition of the job system.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace graphick::utils {
+
+/**
+ * @brief A minimal fork-join job system backed by a pool of persistent worker threads.
+ *
+ * The calling thread always takes part in the work as worker 0, so a job system without worker
+ * threads (e.g. WebAssembly builds without pthreads) runs every job inline.
+ * Jobs must not throw and should not touch the GPU device.
+ */
+class JobSystem {
+ public:
+  /**
+   * @brief The job callback, called with the index of the item and the index of the worker.
+   *
+   * The worker index is in the range [0, concurrency()) and can be used to access per-worker
+   * scratch data.
+   */
+  using Job = std::function<void(const size_t index, const size_t worker)>;
+ public:
+  /**
+   * @brief Constructs a new job system.
+   *
+   * @param workers_count The number of worker threads to spawn, in addition to the calling thread.
+   */
+  JobSystem(const size_t workers_count = default_workers_count());
+
+  /**
+   * @brief Deleted copy and move constructors.
+   */
+  JobSystem(const JobSystem&) = delete;
+  JobSystem(JobSystem&&) = delete;
+
+  /**
+   * @brief Joins all the worker threads.
+   */
+  ~JobSystem();
+
+  /**
+   * @brief Returns the number of threads that can execute jobs, including the calling thread.
+   *
+   * @return The number of threads that can execute jobs.
+   */
+  inline size_t concurrency() const
+  {
+    return m_workers.size() + 1;
+  }
+
+  /**
+   * @brief Runs the job for each index in [0, count) and waits for all of them to complete.
+   *
+   * Indices are handed out dynamically, so the order of execution is not defined: jobs should only
+   * write to the slot of their own index or to the scratch data of their worker.
+   * Nested calls (from within a job) are executed inline on the calling thread.
+   *
+   * @param count The number of items to process.
+   * @param job The job to run for each item.
+   */
+  void parallel_for(const size_t count, const Job& job);
+
+  /**
+   * @brief Returns the default number of worker threads for this platform.
+   *
+   * @return The number of hardware threads minus one, zero if threads are not available.
+   */
+  static size_t default_workers_count();
+
+ private:
+  /**
+   * @brief The loop executed by each worker thread.
+   *
+   * @param worker The index of the worker, starting from 1.
+   */
+  void worker_loop(const size_t worker);
+
+  /**
+   * @brief Processes items of the current job until there are none left.
+   *
+   * @param worker The index of the worker.
+   */
+  void run(const size_t worker);
+
+ private:
+  std::vector<std::thread> m_workers;       // The worker threads.
+
+  std::mutex m_mutex;                       // Protects the job state below.
+  std::condition_variable m_start;          // Notified when a new job is available.
+  std::condition_variable m_done;           // Notified when a worker finishes its share of a job.
+
+  const Job* m_job = nullptr;               // The job being executed, nullptr if idle.
+  size_t m_count = 0;                       // The number of items of the current job.
+  size_t m_generation = 0;                  // Incremented every time a job is submitted.
+  size_t m_busy = 0;                        // The number of workers still processing the job.
+  bool m_stop = false;                      // Whether the workers should exit.
+
+  std::atomic<size_t> m_next{0};            // The next item to process.
+};
+
+}  // namespace graphick::utils
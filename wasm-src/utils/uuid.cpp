@@ -9,9 +9,9 @@
 
 namespace graphick::utils {
 
-static std::random_device s_random_device;
-static std::mt19937_64 s_engine(s_random_device());
-static std::uniform_int_distribution<uint64_t> s_uniform_distribution;
+/* Each thread has its own engine, so ids can be generated concurrently without locking. */
+static thread_local std::mt19937_64 s_engine(std::random_device{}());
+static thread_local std::uniform_int_distribution<uint64_t> s_uniform_distribution;
 
 const uuid uuid::null = 0;
 